@@ -0,0 +1,58 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Convert a trace of MobilityHelper::EnableBinary to the format of
+// MobilityHelper::EnableAscii:
+//
+// ./waf --run "mobility-binary-trace-converter --input=trace.bin --output=trace.mob"
+
+#include <fstream>
+#include <iostream>
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("input", "binary trace to read", input);
+  cmd.AddValue ("output", "ascii trace to write, standard output if empty", output);
+  cmd.Parse (argc, argv);
+
+  std::ifstream is (input.c_str (), std::ios::in | std::ios::binary);
+  if (!is)
+    {
+      std::cerr << "cannot open " << input << std::endl;
+      return 1;
+    }
+  std::ofstream file;
+  if (!output.empty ())
+    {
+      file.open (output.c_str ());
+    }
+  int64_t n = MobilityBinaryTrace::ConvertToAscii (is, output.empty () ? std::cout : file);
+  if (n < 0)
+    {
+      std::cerr << input << " is not a mobility binary trace" << std::endl;
+      return 1;
+    }
+  std::cerr << n << " records converted" << std::endl;
+  return 0;
+}
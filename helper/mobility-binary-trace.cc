@@ -0,0 +1,135 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include "ns3/mobility-binary-trace.h"
+
+namespace ns3 {
+
+/// First eight bytes of a trace
+static const char MAGIC[8] = { 'n', 's', '3', 'm', 'o', 'b', 'i', 'l' };
+/// Version of the format
+static const uint32_t VERSION = 1;
+
+/**
+ * Utility function that rounds |1e-4| < input value < |1e-3| up to +/- 1e-3
+ * and value <= |1e-4| to zero
+ * \param v value to round
+ * \return rounded value
+ */
+static double
+DoRound (double v)
+{
+  if (v <= 1e-4 && v >= -1e-4)
+    {
+      return 0.0;
+    }
+  else if (v <= 1e-3 && v >= 0)
+    {
+      return 1e-3;
+    }
+  else if (v >= -1e-3 && v <= 0)
+    {
+      return -1e-3;
+    }
+  else
+    {
+      return v;
+    }
+}
+
+void
+MobilityBinaryTrace::WriteHeader (std::ostream &os)
+{
+  uint32_t header[2] = { VERSION, sizeof (Record) };
+  os.write (MAGIC, sizeof (MAGIC));
+  os.write (reinterpret_cast<const char *> (header), sizeof (header));
+}
+
+void
+MobilityBinaryTrace::Write (std::ostream &os, const Time &time, uint32_t node,
+                            const Vector &position, const Vector &velocity)
+{
+  Record record;
+  record.time = time.GetNanoSeconds ();
+  record.node = node;
+  record.reserved = 0;
+  record.position[0] = position.x;
+  record.position[1] = position.y;
+  record.position[2] = position.z;
+  record.velocity[0] = velocity.x;
+  record.velocity[1] = velocity.y;
+  record.velocity[2] = velocity.z;
+  os.write (reinterpret_cast<const char *> (&record), sizeof (record));
+}
+
+bool
+MobilityBinaryTrace::ReadHeader (std::istream &is)
+{
+  char magic[sizeof (MAGIC)];
+  uint32_t header[2];
+  is.read (magic, sizeof (magic));
+  is.read (reinterpret_cast<char *> (header), sizeof (header));
+  return is && std::memcmp (magic, MAGIC, sizeof (MAGIC)) == 0
+         && header[0] == VERSION && header[1] == sizeof (Record);
+}
+
+bool
+MobilityBinaryTrace::Read (std::istream &is, Record &record)
+{
+  is.read (reinterpret_cast<char *> (&record), sizeof (record));
+  return is.gcount () == sizeof (record);
+}
+
+void
+MobilityBinaryTrace::PrintAscii (std::ostream &os, const Time &time, uint32_t node,
+                                 const Vector &position, const Vector &velocity)
+{
+  os << "now=" << time
+     << " node=" << node;
+  Vector pos = Vector (DoRound (position.x), DoRound (position.y), DoRound (position.z));
+  Vector vel = Vector (DoRound (velocity.x), DoRound (velocity.y), DoRound (velocity.z));
+  std::streamsize saved_precision = os.precision ();
+  std::ios::fmtflags saved_flags = os.flags ();
+  os.precision (3);
+  os.setf (std::ios::fixed,std::ios::floatfield);
+  os << " pos=" << pos.x << ":" << pos.y << ":" << pos.z
+     << " vel=" << vel.x << ":" << vel.y << ":" << vel.z
+     << std::endl;
+  os.flags (saved_flags);
+  os.precision (saved_precision);
+}
+
+int64_t
+MobilityBinaryTrace::ConvertToAscii (std::istream &is, std::ostream &os)
+{
+  if (!ReadHeader (is))
+    {
+      return -1;
+    }
+  int64_t n = 0;
+  Record record;
+  while (Read (is, record))
+    {
+      PrintAscii (os, NanoSeconds (record.time), record.node,
+                  Vector (record.position[0], record.position[1], record.position[2]),
+                  Vector (record.velocity[0], record.velocity[1], record.velocity[2]));
+      n++;
+    }
+  return n;
+}
+
+} // namespace ns3
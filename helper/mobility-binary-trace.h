@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MOBILITY_BINARY_TRACE_H
+#define MOBILITY_BINARY_TRACE_H
+
+#include <stdint.h>
+#include <istream>
+#include <ostream>
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Read and write the binary course change traces of
+ * MobilityHelper::EnableBinary.
+ *
+ * A trace is a 16 byte header followed by 64 byte records, in the byte
+ * order of the host which wrote it:
+ *  - header: the magic "ns3mobil", the format version and the record size,
+ *    as 32 bit integers,
+ *  - record: the time in nanoseconds as a 64 bit integer, the node id and a
+ *    reserved word as 32 bit integers, then the position and the velocity
+ *    as six doubles.
+ *
+ * Values are stored as the model returned them; the rounding of the ASCII
+ * trace is only applied by PrintAscii, so that ConvertToAscii gives back
+ * exactly the output of MobilityHelper::EnableAscii.
+ */
+class MobilityBinaryTrace
+{
+public:
+  /// One course change
+  struct Record
+  {
+    int64_t time; //!< time of the change, in nanoseconds
+    uint32_t node; //!< id of the node
+    uint32_t reserved; //!< zero
+    double position[3]; //!< position after the change
+    double velocity[3]; //!< velocity after the change
+  };
+
+  /**
+   * \param os the output stream, at the start of the trace
+   */
+  static void WriteHeader (std::ostream &os);
+  /**
+   * \param os the output stream
+   * \param time the time of the change
+   * \param node the id of the node
+   * \param position the position of the node
+   * \param velocity the velocity of the node
+   */
+  static void Write (std::ostream &os, const Time &time, uint32_t node,
+                     const Vector &position, const Vector &velocity);
+  /**
+   * \param is the input stream, at the start of the trace
+   * \return true if the stream starts with a header this version can read
+   */
+  static bool ReadHeader (std::istream &is);
+  /**
+   * \param is the input stream
+   * \param record receives the next record
+   * \return false at the end of the trace
+   */
+  static bool Read (std::istream &is, Record &record);
+  /**
+   * Print a course change in the format of MobilityHelper::EnableAscii.
+   * \param os the output stream
+   * \param time the time of the change
+   * \param node the id of the node
+   * \param position the position of the node
+   * \param velocity the velocity of the node
+   */
+  static void PrintAscii (std::ostream &os, const Time &time, uint32_t node,
+                          const Vector &position, const Vector &velocity);
+  /**
+   * Convert a binary trace to the ASCII format.
+   * \param is the binary trace
+   * \param os receives the ASCII trace
+   * \return the number of records converted, or -1 if the header is not
+   * recognized
+   */
+  static int64_t ConvertToAscii (std::istream &is, std::ostream &os);
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_BINARY_TRACE_H */
@@ -21,12 +21,20 @@
 #include "ns3/mobility-model.h"
 #include "ns3/position-allocator.h"
 #include "ns3/hierarchical-mobility-model.h"
+#include "ns3/mobility-neighbor-index.h"
+#include "ns3/course-change-aggregator.h"
+#include "ns3/mobility-binary-trace.h"
+#include "ns3/mobility-trace-writer.h"
+#include "ns3/mobility-sampler.h"
+#include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
-#include "ns3/config.h"
+#include "ns3/node-list.h"
+#include "ns3/trace-source-accessor.h"
 #include "ns3/simulator.h"
 #include "ns3/names.h"
 #include "ns3/string.h"
+#include <chrono>
 #include <iostream>
 
 namespace ns3 {
@@ -174,77 +182,119 @@ MobilityHelper::Install (NodeContainer c) const
     }
 }
 
-void 
-MobilityHelper::InstallAll (void)
-{
-  Install (NodeContainer::GetGlobal ());
-}
 /**
- * Utility function that rounds |1e-4| < input value < |1e-3| up to +/- 1e-3
- * and value <= |1e-4| to zero
- * \param v value to round
- * \return rounded value
+ * \return the wall clock, in seconds
  */
 static double
-DoRound (double v)
+GetWallClock (void)
+{
+  return std::chrono::duration<double> (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+MobilityHelper::InstallTiming
+MobilityHelper::InstallBulk (NodeContainer c) const
 {
-  if (v <= 1e-4 && v >= -1e-4)
+  NS_LOG_FUNCTION (this << c.GetN ());
+  InstallTiming timing;
+  double start = GetWallClock ();
+  if (!m_mobility.GetTypeId ().IsChildOf (MobilityModel::GetTypeId ()))
+    {
+      NS_FATAL_ERROR ("The requested mobility model is not a mobility model: \""<<
+                      m_mobility.GetTypeId ().GetName ()<<"\"");
+    }
+  uint32_t n = c.GetN ();
+  std::vector<Ptr<MobilityModel> > models (n);
+  std::vector<Ptr<MobilityModel> > created;
+  std::vector<uint32_t> createdIndices;
+  created.reserve (n);
+  createdIndices.reserve (n);
+  for (uint32_t i = 0; i < n; i++)
     {
-      return 0.0;
+      models[i] = c.Get (i)->GetObject<MobilityModel> ();
+      if (models[i] == 0)
+        {
+          models[i] = m_mobility.Create<MobilityModel> ();
+          if (m_mobilityStack.empty ())
+            {
+              created.push_back (models[i]);
+            }
+          else
+            {
+              created.push_back (CreateObjectWithAttributes<HierarchicalMobilityModel> ("Child", PointerValue (models[i]),
+                                                                                        "Parent", PointerValue (m_mobilityStack.back ())));
+            }
+          createdIndices.push_back (i);
+        }
     }
-  else if (v <= 1e-3 && v >= 0)
+  double createEnd = GetWallClock ();
+  for (uint32_t k = 0; k < created.size (); k++)
     {
-      return 1e-3;
+      c.Get (createdIndices[k])->AggregateObject (created[k]);
     }
-  else if (v >= -1e-3 && v <= 0)
+  double aggregateEnd = GetWallClock ();
+  std::vector<Vector> positions (n);
+  if (n > 0)
     {
-      return -1e-3;
+      m_position->GetNextBatch (n, &positions[0]);
     }
-  else
+  for (uint32_t i = 0; i < n; i++)
     {
-      return v;
+      models[i]->SetPosition (positions[i]);
     }
+  double positionEnd = GetWallClock ();
+  timing.created = created.size ();
+  timing.create = createEnd - start;
+  timing.aggregate = aggregateEnd - createEnd;
+  timing.position = positionEnd - aggregateEnd;
+  NS_LOG_INFO ("installed " << n << " nodes, created " << timing.created << " models in " << timing.create
+               << "s, aggregated in " << timing.aggregate << "s, positioned in " << timing.position << "s");
+  return timing;
+}
+
+void 
+MobilityHelper::InstallAll (void)
+{
+  Install (NodeContainer::GetGlobal ());
 }
 void
 MobilityHelper::CourseChanged (Ptr<OutputStreamWrapper> stream, Ptr<const MobilityModel> mobility)
 {
-  std::ostream* os = stream->GetStream ();
   Ptr<Node> node = mobility->GetObject<Node> ();
-  *os << "now=" << Simulator::Now ()
-      << " node=" << node->GetId ();
-  Vector pos = mobility->GetPosition ();
-  pos.x = DoRound (pos.x);
-  pos.y = DoRound (pos.y);
-  pos.z = DoRound (pos.z);
-  Vector vel = mobility->GetVelocity ();
-  vel.x = DoRound (vel.x);
-  vel.y = DoRound (vel.y);
-  vel.z = DoRound (vel.z);
-  std::streamsize saved_precision = os->precision ();
-  std::ios::fmtflags saved_flags = os->flags ();
-  os->precision (3);
-  os->setf (std::ios::fixed,std::ios::floatfield);
-  *os << " pos=" << pos.x << ":" << pos.y << ":" << pos.z
-      << " vel=" << vel.x << ":" << vel.y << ":" << vel.z
-      << std::endl;
-  os->flags (saved_flags);
-  os->precision (saved_precision);
+  MobilityBinaryTrace::PrintAscii (*stream->GetStream (), Simulator::Now (), node->GetId (),
+                                   mobility->GetPosition (), mobility->GetVelocity ());
 }
 
+/**
+ * Connect a sink to the CourseChange trace source of the mobility model of
+ * a node, if it has one, without resolving a configuration path.
+ * \param node the node
+ * \param cb the sink
+ */
+static void
+ConnectCourseChange (Ptr<Node> node, const CallbackBase &cb)
+{
+  static Ptr<const TraceSourceAccessor> accessor = MobilityModel::GetTypeId ().LookupTraceSourceByName ("CourseChange");
+  Ptr<MobilityModel> mobility = node->GetObject<MobilityModel> ();
+  if (mobility != 0)
+    {
+      accessor->ConnectWithoutContext (PeekPointer (mobility), cb);
+    }
+}
 void 
 MobilityHelper::EnableAscii (Ptr<OutputStreamWrapper> stream, uint32_t nodeid)
 {
-  std::ostringstream oss;
-  oss << "/NodeList/" << nodeid << "/$ns3::MobilityModel/CourseChange";
-  Config::ConnectWithoutContextFailSafe (oss.str (), 
-                                         MakeBoundCallback (&MobilityHelper::CourseChanged, stream));
+  if (nodeid < NodeList::GetNNodes ())
+    {
+      EnableAscii (stream, NodeContainer (NodeList::GetNode (nodeid)));
+    }
 }
 void 
 MobilityHelper::EnableAscii (Ptr<OutputStreamWrapper> stream, NodeContainer n)
 {
+  Callback<void, Ptr<const MobilityModel> > cb = MakeBoundCallback (&MobilityHelper::CourseChanged, stream);
   for (NodeContainer::Iterator i = n.Begin (); i != n.End (); ++i)
     {
-      EnableAscii (stream, (*i)->GetId ());
+      ConnectCourseChange (*i, cb);
     }
 }
 void 
@@ -252,6 +302,64 @@ MobilityHelper::EnableAsciiAll (Ptr<OutputStreamWrapper> stream)
 {
   EnableAscii (stream, NodeContainer::GetGlobal ());
 }
+void
+MobilityHelper::CourseChangedWriter (Ptr<MobilityTraceWriter> writer, uint32_t nodeid, Ptr<const MobilityModel> mobility)
+{
+  writer->Add (Simulator::Now (), nodeid, mobility->GetPosition (), mobility->GetVelocity ());
+}
+void
+MobilityHelper::EnableAscii (Ptr<MobilityTraceWriter> writer, uint32_t nodeid)
+{
+  if (nodeid < NodeList::GetNNodes ())
+    {
+      EnableAscii (writer, NodeContainer (NodeList::GetNode (nodeid)));
+    }
+}
+void
+MobilityHelper::EnableAscii (Ptr<MobilityTraceWriter> writer, NodeContainer n)
+{
+  for (NodeContainer::Iterator i = n.Begin (); i != n.End (); ++i)
+    {
+      ConnectCourseChange (*i, MakeBoundCallback (&MobilityHelper::CourseChangedWriter, writer, (*i)->GetId ()));
+    }
+}
+void
+MobilityHelper::EnableAsciiAll (Ptr<MobilityTraceWriter> writer)
+{
+  EnableAscii (writer, NodeContainer::GetGlobal ());
+}
+void
+MobilityHelper::CourseChangedBinary (Ptr<OutputStreamWrapper> stream, uint32_t nodeid, Ptr<const MobilityModel> mobility)
+{
+  MobilityBinaryTrace::Write (*stream->GetStream (), Simulator::Now (), nodeid,
+                              mobility->GetPosition (), mobility->GetVelocity ());
+}
+void
+MobilityHelper::EnableBinary (Ptr<OutputStreamWrapper> stream, uint32_t nodeid)
+{
+  if (nodeid < NodeList::GetNNodes ())
+    {
+      EnableBinary (stream, NodeContainer (NodeList::GetNode (nodeid)));
+    }
+}
+void
+MobilityHelper::EnableBinary (Ptr<OutputStreamWrapper> stream, NodeContainer n)
+{
+  std::ostream *os = stream->GetStream ();
+  if (os->tellp () == std::streampos (0))
+    {
+      MobilityBinaryTrace::WriteHeader (*os);
+    }
+  for (NodeContainer::Iterator i = n.Begin (); i != n.End (); ++i)
+    {
+      ConnectCourseChange (*i, MakeBoundCallback (&MobilityHelper::CourseChangedBinary, stream, (*i)->GetId ()));
+    }
+}
+void
+MobilityHelper::EnableBinaryAll (Ptr<OutputStreamWrapper> stream)
+{
+  EnableBinary (stream, NodeContainer::GetGlobal ());
+}
 int64_t
 MobilityHelper::AssignStreams (NodeContainer c, int64_t stream)
 {
@@ -270,6 +378,68 @@ MobilityHelper::AssignStreams (NodeContainer c, int64_t stream)
   return (currentStream - stream);
 }
 
+void
+MobilityHelper::GetPositions (NodeContainer c, Vector *positions, Vector *velocities)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  std::vector<Ptr<MobilityModel> > models;
+  models.reserve (c.GetN ());
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<MobilityModel> mobility = (*i)->GetObject<MobilityModel> ();
+      NS_ASSERT_MSG (mobility != 0, "Node " << (*i)->GetId () << " has no mobility model");
+      models.push_back (mobility);
+    }
+  if (!models.empty ())
+    {
+      MobilityModel::GetPositions (&models[0], models.size (), positions, velocities);
+    }
+}
+
+Ptr<MobilityNeighborIndex>
+MobilityHelper::InstallNeighborIndex (NodeContainer c, double cellSize)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  Ptr<MobilityNeighborIndex> index = CreateObjectWithAttributes<MobilityNeighborIndex> ("CellSize", DoubleValue (cellSize));
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<MobilityModel> mobility = (*i)->GetObject<MobilityModel> ();
+      NS_ASSERT_MSG (mobility != 0, "Node " << (*i)->GetId () << " has no mobility model");
+      index->Add (mobility);
+    }
+  return index;
+}
+
+Ptr<CourseChangeAggregator>
+MobilityHelper::InstallCourseChangeAggregator (NodeContainer c, Time window)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  Ptr<CourseChangeAggregator> aggregator = CreateObjectWithAttributes<CourseChangeAggregator> ("Window", TimeValue (window));
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<MobilityModel> mobility = (*i)->GetObject<MobilityModel> ();
+      NS_ASSERT_MSG (mobility != 0, "Node " << (*i)->GetId () << " has no mobility model");
+      aggregator->Add (mobility, (*i)->GetId ());
+    }
+  return aggregator;
+}
+
+Ptr<MobilitySampler>
+MobilityHelper::InstallSampler (NodeContainer c, Time period, Ptr<OutputStreamWrapper> stream)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  Ptr<MobilitySampler> sampler = CreateObjectWithAttributes<MobilitySampler> ("Period", TimeValue (period));
+  sampler->SetStream (stream);
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<MobilityModel> mobility = (*i)->GetObject<MobilityModel> ();
+      NS_ASSERT_MSG (mobility != 0, "Node " << (*i)->GetId () << " has no mobility model");
+      sampler->Add (mobility, (*i)->GetId ());
+    }
+  sampler->Start ();
+  return sampler;
+}
+
 double
 MobilityHelper::GetDistanceSquaredBetween (Ptr<Node> n1, Ptr<Node> n2)
 {
@@ -24,6 +24,7 @@
 #include <vector>
 #include "ns3/object-factory.h"
 #include "ns3/attribute.h"
+#include "ns3/nstime.h"
 #include "ns3/output-stream-wrapper.h"
 #include "ns3/position-allocator.h"
 #include "node-container.h"
@@ -32,6 +33,10 @@ namespace ns3 {
 
 class PositionAllocator;
 class MobilityModel;
+class MobilityNeighborIndex;
+class CourseChangeAggregator;
+class MobilityTraceWriter;
+class MobilitySampler;
 
 /**
  * \ingroup mobility
@@ -214,6 +219,28 @@ public:
    */
   void Install (NodeContainer container) const;
 
+  /// Wall clock time spent in the phases of InstallBulk
+  struct InstallTiming
+  {
+    uint32_t created; //!< number of mobility models created
+    double create; //!< seconds spent creating the mobility models
+    double aggregate; //!< seconds spent aggregating them to the nodes
+    double position; //!< seconds spent allocating and setting the positions
+  };
+
+  /**
+   * \brief Layout a collection of nodes as Install does, phase by phase.
+   *
+   * The mobility model type is checked once, all the models are created,
+   * then aggregated to their nodes, then the positions are allocated in one
+   * PositionAllocator::GetNextBatch call and set.  The nodes end up with the
+   * same models and positions as with Install.
+   *
+   * \param container The set of nodes to layout.
+   * \return the time spent in each phase
+   */
+  InstallTiming InstallBulk (NodeContainer container) const;
+
   /**
    * Perform the work of MobilityHelper::Install on _all_ nodes which
    * exist in the simulation.
@@ -249,6 +276,60 @@ public:
    * will not result in any output.
    */
   static void EnableAsciiAll (Ptr<OutputStreamWrapper> stream);
+  /**
+   * \param writer a trace writer, with its stream set
+   * \param nodeid the id of the node to generate output for.
+   *
+   * Enable ascii output, or binary output according to the Format of the
+   * writer, as the EnableAscii method with a stream does, but format and
+   * write the course changes from the thread of the writer.
+   */
+  static void EnableAscii (Ptr<MobilityTraceWriter> writer, uint32_t nodeid);
+  /**
+   * \param writer a trace writer, with its stream set
+   * \param n node container
+   *
+   * Enable output from the thread of the writer for the nodes in the
+   * input container.
+   */
+  static void EnableAscii (Ptr<MobilityTraceWriter> writer, NodeContainer n);
+  /**
+   * \param writer a trace writer, with its stream set
+   *
+   * Enable output from the thread of the writer for every node in the
+   * system.
+   */
+  static void EnableAsciiAll (Ptr<MobilityTraceWriter> writer);
+  /**
+   * \param stream an output stream wrapper, opened in binary mode
+   * \param nodeid the id of the node to generate binary output for.
+   *
+   * Enable binary output to record course changes from the mobility model
+   * associated with the specified nodeid and dump that to the specified
+   * output stream, in the format of MobilityBinaryTrace.  The header is
+   * written if the stream is still empty.  If the Node does not have a
+   * MobilityModel aggregated, this method will not produce any output.
+   */
+  static void EnableBinary (Ptr<OutputStreamWrapper> stream, uint32_t nodeid);
+  /**
+   * \param stream an output stream wrapper, opened in binary mode
+   * \param n node container
+   *
+   * Enable binary output to record course changes from the mobility models
+   * associated to the the nodes in the input container and dump that to the
+   * specified output stream.  Nodes that do not have a MobilityModel
+   * aggregated will not result in any output.
+   */
+  static void EnableBinary (Ptr<OutputStreamWrapper> stream, NodeContainer n);
+  /**
+   * \param stream an output stream wrapper, opened in binary mode
+   *
+   * Enable binary output to record course changes from the mobility models
+   * associated to every node in the system and dump that to the specified
+   * output stream.  Nodes that do not have a MobilityModel aggregated
+   * will not result in any output.
+   */
+  static void EnableBinaryAll (Ptr<OutputStreamWrapper> stream);
   /**
    * Assign a fixed random variable stream number to the random variables
    * used by the mobility models (including any position allocators assigned
@@ -270,6 +351,51 @@ public:
    */
   static double GetDistanceSquaredBetween (Ptr<Node> n1, Ptr<Node> n2);
 
+  /**
+   * Snapshot the positions, and optionally the velocities, of a set of
+   * nodes at the current time with MobilityModel::GetPositions.
+   *
+   * \param c the nodes, each must have a mobility model
+   * \param positions receives one position per node, in container order
+   * \param velocities receives one velocity per node, or null
+   */
+  static void GetPositions (NodeContainer c, Vector *positions, Vector *velocities = 0);
+
+  /**
+   * Index the mobility models of a set of nodes for neighbor queries. The
+   * Install() method should have previously been called by the user.
+   *
+   * \param c the nodes, each must have a mobility model
+   * \param cellSize the width of the cells of the grid, close to the usual
+   * query radius
+   * \return the index, node i of the container has index i
+   */
+  static Ptr<MobilityNeighborIndex> InstallNeighborIndex (NodeContainer c, double cellSize);
+
+  /**
+   * Batch the course changes of a set of nodes. The Install() method
+   * should have previously been called by the user.
+   *
+   * \param c the nodes, each must have a mobility model
+   * \param window the delay between the first course change of a batch and
+   * its delivery
+   * \return the aggregator, reporting the nodes by node id
+   */
+  static Ptr<CourseChangeAggregator> InstallCourseChangeAggregator (NodeContainer c, Time window);
+
+  /**
+   * Sample the positions and velocities of a set of nodes every period,
+   * starting now. The Install() method should have previously been called
+   * by the user. This keeps scheduling events: end the simulation with
+   * Simulator::Stop.
+   *
+   * \param c the nodes, each must have a mobility model
+   * \param period the delay between samples
+   * \param stream the stream to write the samples to, opened in binary mode
+   * \return the sampler, node i of the container is column i
+   */
+  static Ptr<MobilitySampler> InstallSampler (NodeContainer c, Time period, Ptr<OutputStreamWrapper> stream);
+
 private:
 
   /**
@@ -278,6 +404,20 @@ private:
    * \param mobility mobility model
    */
   static void CourseChanged (Ptr<OutputStreamWrapper> stream, Ptr<const MobilityModel> mobility);
+  /**
+   * Output course change events from mobility model to binary output stream
+   * \param stream output stream
+   * \param nodeid id of the node of the mobility model
+   * \param mobility mobility model
+   */
+  static void CourseChangedBinary (Ptr<OutputStreamWrapper> stream, uint32_t nodeid, Ptr<const MobilityModel> mobility);
+  /**
+   * Queue course change events from mobility model to a trace writer
+   * \param writer trace writer
+   * \param nodeid id of the node of the mobility model
+   * \param mobility mobility model
+   */
+  static void CourseChangedWriter (Ptr<MobilityTraceWriter> writer, uint32_t nodeid, Ptr<const MobilityModel> mobility);
   std::vector<Ptr<MobilityModel> > m_mobilityStack; //!< Internal stack of mobility models
   ObjectFactory m_mobility; //!< Object factory to create mobility objects
   Ptr<PositionAllocator> m_position; //!< Position allocator for use in hierarchical mobility model
@@ -0,0 +1,212 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "mobility-sampler.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MobilitySampler");
+
+NS_OBJECT_ENSURE_REGISTERED (MobilitySampler);
+
+/// First eight bytes of a stream
+static const char MAGIC[8] = { 'n', 's', '3', 'm', 'o', 'b', 's', 'm' };
+/// Version of the format
+static const uint32_t VERSION = 1;
+
+TypeId
+MobilitySampler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MobilitySampler")
+    .SetParent<Object> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<MobilitySampler> ()
+    .AddAttribute ("Period",
+                   "Delay between samples",
+                   TimeValue (Seconds (1.0)),
+                   MakeTimeAccessor (&MobilitySampler::m_period),
+                   MakeTimeChecker (NanoSeconds (1)))
+    .AddAttribute ("Velocities",
+                   "Sample the velocities along with the positions",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&MobilitySampler::m_velocities),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+MobilitySampler::MobilitySampler ()
+  : m_samples (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MobilitySampler::~MobilitySampler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MobilitySampler::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_event.Cancel ();
+  m_models.clear ();
+  m_stream = 0;
+  Object::DoDispose ();
+}
+
+void
+MobilitySampler::SetStream (Ptr<OutputStreamWrapper> stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_stream = stream;
+}
+
+void
+MobilitySampler::Add (Ptr<MobilityModel> model, uint32_t id)
+{
+  NS_LOG_FUNCTION (this << model << id);
+  NS_ASSERT_MSG (m_samples == 0, "Node added after the first sample");
+  m_models.push_back (model);
+  m_ids.push_back (id);
+}
+
+uint32_t
+MobilitySampler::GetN (void) const
+{
+  return m_models.size ();
+}
+
+uint64_t
+MobilitySampler::GetSampleCount (void) const
+{
+  return m_samples;
+}
+
+void
+MobilitySampler::Start (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_stream != 0, "No stream set");
+  m_event.Cancel ();
+  // the events hold a reference: the sampler runs even if the caller drops it
+  m_event = Simulator::ScheduleNow (&MobilitySampler::Sample, Ptr<MobilitySampler> (this));
+}
+
+void
+MobilitySampler::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_event.Cancel ();
+  if (m_stream != 0)
+    {
+      m_stream->GetStream ()->flush ();
+    }
+}
+
+void
+MobilitySampler::WriteHeader (void)
+{
+  std::ostream *os = m_stream->GetStream ();
+  uint32_t header[3] = { VERSION, static_cast<uint32_t> (m_ids.size ()), m_velocities ? 1u : 0u };
+  os->write (MAGIC, sizeof (MAGIC));
+  os->write (reinterpret_cast<const char *> (header), sizeof (header));
+  if (!m_ids.empty ())
+    {
+      os->write (reinterpret_cast<const char *> (&m_ids[0]), m_ids.size () * sizeof (uint32_t));
+    }
+}
+
+void
+MobilitySampler::Sample (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_samples == 0)
+    {
+      WriteHeader ();
+    }
+  uint32_t n = m_models.size ();
+  std::ostream *os = m_stream->GetStream ();
+  int64_t time = Simulator::Now ().GetNanoSeconds ();
+  os->write (reinterpret_cast<const char *> (&time), sizeof (time));
+  if (n > 0)
+    {
+      m_positions.resize (n);
+      m_velocitiesBuffer.resize (m_velocities ? n : 0);
+      m_column.resize (n);
+      MobilityModel::GetPositions (&m_models[0], n, &m_positions[0],
+                                   m_velocities ? &m_velocitiesBuffer[0] : 0);
+      const std::vector<Vector> *vectors[2] = { &m_positions, &m_velocitiesBuffer };
+      for (uint32_t v = 0; v < (m_velocities ? 2u : 1u); v++)
+        {
+          const std::vector<Vector> &values = *vectors[v];
+          for (uint32_t c = 0; c < 3; c++)
+            {
+              for (uint32_t i = 0; i < n; i++)
+                {
+                  m_column[i] = c == 0 ? values[i].x : c == 1 ? values[i].y : values[i].z;
+                }
+              os->write (reinterpret_cast<const char *> (&m_column[0]), n * sizeof (double));
+            }
+        }
+    }
+  m_samples++;
+  m_event = Simulator::Schedule (m_period, &MobilitySampler::Sample, Ptr<MobilitySampler> (this));
+}
+
+bool
+MobilitySampler::ReadHeader (std::istream &is, std::vector<uint32_t> &ids, bool &velocities)
+{
+  char magic[sizeof (MAGIC)];
+  uint32_t header[3];
+  is.read (magic, sizeof (magic));
+  is.read (reinterpret_cast<char *> (header), sizeof (header));
+  if (!is || std::memcmp (magic, MAGIC, sizeof (MAGIC)) != 0 || header[0] != VERSION)
+    {
+      return false;
+    }
+  ids.resize (header[1]);
+  velocities = header[2] != 0;
+  if (!ids.empty ())
+    {
+      is.read (reinterpret_cast<char *> (&ids[0]), ids.size () * sizeof (uint32_t));
+    }
+  return bool (is);
+}
+
+bool
+MobilitySampler::ReadBlock (std::istream &is, uint32_t n, bool velocities, Block &block)
+{
+  is.read (reinterpret_cast<char *> (&block.time), sizeof (block.time));
+  std::vector<double> *columns[6] = { &block.x, &block.y, &block.z, &block.vx, &block.vy, &block.vz };
+  for (uint32_t c = 0; c < 6; c++)
+    {
+      columns[c]->resize (c < 3 || velocities ? n : 0);
+      if (!columns[c]->empty ())
+        {
+          is.read (reinterpret_cast<char *> (&(*columns[c])[0]), n * sizeof (double));
+        }
+    }
+  return bool (is);
+}
+
+} // namespace ns3
@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MOBILITY_SAMPLER_H
+#define MOBILITY_SAMPLER_H
+
+#include <stdint.h>
+#include <istream>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/event-id.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/mobility-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Sample the positions and velocities of many nodes at a fixed rate.
+ *
+ * Every Period, the positions and velocities of all the nodes are
+ * evaluated in one MobilityModel::GetPositions pass and written to the
+ * stream as one block of columns, so that the continuous motion of the
+ * nodes is recorded, not only their course changes.
+ *
+ * The stream, in the byte order of the host which wrote it, holds:
+ *  - a header: the magic "ns3mobsm", then as 32 bit integers the format
+ *    version, the number of nodes n and 1 if velocities are sampled, else 0,
+ *    then the n node ids as 32 bit integers,
+ *  - one block per sample: the time in nanoseconds as a 64 bit integer,
+ *    then the columns x, y, z and, if sampled, vx, vy, vz as n doubles each.
+ *
+ * Nodes cannot be added once the first sample was taken.
+ */
+class MobilitySampler : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  MobilitySampler ();
+  virtual ~MobilitySampler ();
+
+  /// One sample of every node, read back from a stream
+  struct Block
+  {
+    int64_t time; //!< time of the sample, in nanoseconds
+    std::vector<double> x; //!< x coordinate of each node
+    std::vector<double> y; //!< y coordinate of each node
+    std::vector<double> z; //!< z coordinate of each node
+    std::vector<double> vx; //!< x velocity of each node, empty if not sampled
+    std::vector<double> vy; //!< y velocity of each node, empty if not sampled
+    std::vector<double> vz; //!< z velocity of each node, empty if not sampled
+  };
+
+  /**
+   * \param stream the stream to write to, opened in binary mode
+   */
+  void SetStream (Ptr<OutputStreamWrapper> stream);
+  /**
+   * Sample a node.
+   * \param model the mobility model of the node
+   * \param id the identifier written for the node, e.g. its node id
+   */
+  void Add (Ptr<MobilityModel> model, uint32_t id);
+  /**
+   * \return the number of nodes sampled
+   */
+  uint32_t GetN (void) const;
+  /**
+   * Take a sample now, then every Period, until Stop.  This keeps
+   * scheduling events: end the simulation with Simulator::Stop.  The
+   * scheduled samples keep the sampler alive.
+   */
+  void Start (void);
+  /**
+   * Stop sampling.
+   */
+  void Stop (void);
+  /**
+   * \return the number of samples taken
+   */
+  uint64_t GetSampleCount (void) const;
+
+  /**
+   * \param is the input stream, at the start of the samples
+   * \param ids receives the id of each node
+   * \param velocities receives true if velocities were sampled
+   * \return true if the stream starts with a header this version can read
+   */
+  static bool ReadHeader (std::istream &is, std::vector<uint32_t> &ids, bool &velocities);
+  /**
+   * \param is the input stream, after the header
+   * \param n the number of nodes
+   * \param velocities true if velocities were sampled
+   * \param block receives the next sample
+   * \return false at the end of the stream
+   */
+  static bool ReadBlock (std::istream &is, uint32_t n, bool velocities, Block &block);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * Take and write a sample, then schedule the next one.
+   */
+  void Sample (void);
+  /**
+   * Write the header of the stream.
+   */
+  void WriteHeader (void);
+
+  Ptr<OutputStreamWrapper> m_stream; //!< the output
+  Time m_period; //!< delay between samples
+  bool m_velocities; //!< true to sample the velocities
+  std::vector<Ptr<MobilityModel> > m_models; //!< models of the nodes sampled
+  std::vector<uint32_t> m_ids; //!< identifiers of the nodes sampled
+  std::vector<Vector> m_positions; //!< positions of the current sample
+  std::vector<Vector> m_velocitiesBuffer; //!< velocities of the current sample
+  std::vector<double> m_column; //!< column being written
+  EventId m_event; //!< next sample
+  uint64_t m_samples; //!< samples taken
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_SAMPLER_H */
@@ -0,0 +1,218 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <chrono>
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/simulator.h"
+#include "ns3/enum.h"
+#include "ns3/uinteger.h"
+#include "mobility-trace-writer.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MobilityTraceWriter");
+
+NS_OBJECT_ENSURE_REGISTERED (MobilityTraceWriter);
+
+TypeId
+MobilityTraceWriter::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MobilityTraceWriter")
+    .SetParent<Object> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<MobilityTraceWriter> ()
+    .AddAttribute ("Format",
+                   "The format of the stream",
+                   EnumValue (MobilityTraceWriter::ASCII),
+                   MakeEnumAccessor (&MobilityTraceWriter::m_format),
+                   MakeEnumChecker (MobilityTraceWriter::ASCII, "Ascii",
+                                    MobilityTraceWriter::BINARY, "Binary"))
+    .AddAttribute ("Backpressure",
+                   "What to do with a course change when the buffer is full",
+                   EnumValue (MobilityTraceWriter::BLOCK),
+                   MakeEnumAccessor (&MobilityTraceWriter::m_backpressure),
+                   MakeEnumChecker (MobilityTraceWriter::BLOCK, "Block",
+                                    MobilityTraceWriter::DROP, "Drop"))
+    .AddAttribute ("Capacity",
+                   "The number of course changes the buffer holds, rounded up to a power of two",
+                   UintegerValue (65536),
+                   MakeUintegerAccessor (&MobilityTraceWriter::m_capacity),
+                   MakeUintegerChecker<uint32_t> (1, 1u << 30))
+  ;
+  return tid;
+}
+
+MobilityTraceWriter::MobilityTraceWriter ()
+  : m_os (0),
+    m_mask (0),
+    m_head (0),
+    m_tail (0),
+    m_stop (false),
+    m_dropped (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MobilityTraceWriter::~MobilityTraceWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Stop ();
+}
+
+void
+MobilityTraceWriter::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Stop ();
+  m_stream = 0;
+  m_os = 0;
+  Object::DoDispose ();
+}
+
+void
+MobilityTraceWriter::SetStream (Ptr<OutputStreamWrapper> stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  NS_ASSERT_MSG (!m_thread.joinable (), "Stream changed while writing");
+  m_stream = stream;
+  m_os = stream->GetStream ();
+}
+
+void
+MobilityTraceWriter::Add (const Time &time, uint32_t node, const Vector &position, const Vector &velocity)
+{
+  if (!m_thread.joinable ())
+    {
+      NS_ASSERT_MSG (m_os != 0, "No stream set");
+      if (m_ring.empty ())
+        {
+          uint64_t size = 1;
+          while (size < m_capacity)
+            {
+              size <<= 1;
+            }
+          m_ring.resize (size);
+          m_mask = size - 1;
+        }
+      if (m_format == BINARY && m_os->tellp () == std::streampos (0))
+        {
+          MobilityBinaryTrace::WriteHeader (*m_os);
+        }
+      m_stop.store (false);
+      m_thread = std::thread (&MobilityTraceWriter::Run, this);
+      Simulator::ScheduleDestroy (&MobilityTraceWriter::Stop, Ptr<MobilityTraceWriter> (this));
+    }
+  uint64_t head = m_head.load (std::memory_order_relaxed);
+  while (head - m_tail.load (std::memory_order_acquire) > m_mask)
+    {
+      if (m_backpressure == DROP)
+        {
+          m_dropped++;
+          return;
+        }
+      std::this_thread::yield ();
+    }
+  MobilityBinaryTrace::Record &record = m_ring[head & m_mask];
+  record.time = time.GetNanoSeconds ();
+  record.node = node;
+  record.reserved = 0;
+  record.position[0] = position.x;
+  record.position[1] = position.y;
+  record.position[2] = position.z;
+  record.velocity[0] = velocity.x;
+  record.velocity[1] = velocity.y;
+  record.velocity[2] = velocity.z;
+  m_head.store (head + 1, std::memory_order_release);
+}
+
+void
+MobilityTraceWriter::Run (void)
+{
+  uint64_t tail = m_tail.load (std::memory_order_relaxed);
+  while (true)
+    {
+      // read m_stop first: the records queued before Stop are then visible
+      bool stop = m_stop.load (std::memory_order_acquire);
+      uint64_t head = m_head.load (std::memory_order_acquire);
+      if (tail == head)
+        {
+          if (stop)
+            {
+              break;
+            }
+          std::this_thread::sleep_for (std::chrono::milliseconds (1));
+          continue;
+        }
+      for (; tail != head; tail++)
+        {
+          const MobilityBinaryTrace::Record &record = m_ring[tail & m_mask];
+          if (m_format == BINARY)
+            {
+              m_os->write (reinterpret_cast<const char *> (&record), sizeof (record));
+            }
+          else
+            {
+              MobilityBinaryTrace::PrintAscii (*m_os, NanoSeconds (record.time), record.node,
+                                               Vector (record.position[0], record.position[1], record.position[2]),
+                                               Vector (record.velocity[0], record.velocity[1], record.velocity[2]));
+            }
+          m_tail.store (tail + 1, std::memory_order_release);
+        }
+    }
+  m_os->flush ();
+}
+
+void
+MobilityTraceWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_thread.joinable ())
+    {
+      return;
+    }
+  while (m_tail.load (std::memory_order_acquire) != m_head.load (std::memory_order_relaxed))
+    {
+      std::this_thread::yield ();
+    }
+  m_os->flush ();
+}
+
+void
+MobilityTraceWriter::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_thread.joinable ())
+    {
+      return;
+    }
+  m_stop.store (true, std::memory_order_release);
+  m_thread.join ();
+}
+
+uint64_t
+MobilityTraceWriter::GetWritten (void) const
+{
+  return m_tail.load (std::memory_order_acquire);
+}
+
+uint64_t
+MobilityTraceWriter::GetDropped (void) const
+{
+  return m_dropped;
+}
+
+} // namespace ns3
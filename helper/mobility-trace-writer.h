@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MOBILITY_TRACE_WRITER_H
+#define MOBILITY_TRACE_WRITER_H
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/output-stream-wrapper.h"
+#include "mobility-binary-trace.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Write course change traces from a background thread.
+ *
+ * The simulator thread only copies each course change into a ring buffer;
+ * a writer thread, started by the first Add, formats the records and
+ * writes them to the stream, in the format of MobilityHelper::EnableAscii
+ * or MobilityHelper::EnableBinary.  The buffer is lock-free with a single
+ * producer: call Add from the simulator thread only.
+ *
+ * When the buffer is full, Add either waits for the writer thread
+ * (Backpressure=Block, the default) or drops the record and counts it
+ * (Backpressure=Drop).  The stream must not be used by anyone else until
+ * Flush or Stop returned; Stop is scheduled by Simulator::Destroy.
+ */
+class MobilityTraceWriter : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  MobilityTraceWriter ();
+  virtual ~MobilityTraceWriter ();
+
+  /// Format of the stream
+  enum Format
+  {
+    ASCII,
+    BINARY
+  };
+  /// Behavior when the buffer is full
+  enum Backpressure
+  {
+    BLOCK,
+    DROP
+  };
+
+  /**
+   * \param stream the stream to write to, opened in binary mode for the
+   * BINARY format
+   */
+  void SetStream (Ptr<OutputStreamWrapper> stream);
+  /**
+   * Queue a course change.
+   * \param time the time of the change
+   * \param node the id of the node
+   * \param position the position of the node
+   * \param velocity the velocity of the node
+   */
+  void Add (const Time &time, uint32_t node, const Vector &position, const Vector &velocity);
+  /**
+   * Wait until every queued record is written, then flush the stream.
+   */
+  void Flush (void);
+  /**
+   * Write the queued records and stop the writer thread.  A later Add
+   * starts it again.
+   */
+  void Stop (void);
+  /**
+   * \return the number of records written
+   */
+  uint64_t GetWritten (void) const;
+  /**
+   * \return the number of records dropped because the buffer was full
+   */
+  uint64_t GetDropped (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * Body of the writer thread.
+   */
+  void Run (void);
+
+  Ptr<OutputStreamWrapper> m_stream; //!< the output
+  std::ostream *m_os; //!< stream of m_stream
+  enum Format m_format; //!< format of the output
+  enum Backpressure m_backpressure; //!< behavior when the buffer is full
+  uint32_t m_capacity; //!< requested number of records of the buffer
+  std::vector<MobilityBinaryTrace::Record> m_ring; //!< the buffer, a power of two records
+  uint64_t m_mask; //!< size of m_ring minus one
+  std::atomic<uint64_t> m_head; //!< records queued, written by the simulator thread
+  std::atomic<uint64_t> m_tail; //!< records written, written by the writer thread
+  std::atomic<bool> m_stop; //!< true to end the writer thread once the buffer is empty
+  uint64_t m_dropped; //!< records dropped
+  std::thread m_thread; //!< the writer thread
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_TRACE_WRITER_H */
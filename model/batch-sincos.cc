@@ -0,0 +1,182 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include "batch-sincos.h"
+
+#if defined (__AVX2__) || defined (__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace ns3 {
+
+#if defined (__AVX2__) || defined (__SSE2__)
+// Cephes sin.c: pi/4 split in three parts for the Cody-Waite reduction
+static const double DP1 = 7.85398125648498535156E-1;
+static const double DP2 = 3.77489470793079817668E-8;
+static const double DP3 = 2.69515142907905952645E-15;
+static const double FOUR_OVER_PI = 1.27323954473516268615;
+// minimax polynomials of sin and cos on [-pi/4, pi/4]
+static const double SIN_COF[6] = {
+  1.58962301576546568060E-10, -2.50507477628578072866E-8,
+  2.75573136213857245213E-6, -1.98412698295895385996E-4,
+  8.33333333332211858878E-3, -1.66666666666666307295E-1
+};
+static const double COS_COF[6] = {
+  -1.13585365213876817300E-11, 2.08757008419747316778E-9,
+  -2.75573141792967388112E-7, 2.48015872888517045348E-5,
+  -1.38888888888730564116E-3, 4.16666666666665929218E-2
+};
+#endif
+
+#if defined (__AVX2__)
+static const size_t LANES = 4;
+
+static void
+SinCosLanes (const double *angle, double *sine, double *cosine)
+{
+  const __m256d signBit = _mm256_set1_pd (-0.0);
+  __m256d a = _mm256_loadu_pd (angle);
+  __m256d x = _mm256_andnot_pd (signBit, a);
+  __m256d xSign = _mm256_and_pd (signBit, a);
+
+  // octant of |x|, rounded up to an even one
+  __m256d y = _mm256_floor_pd (_mm256_mul_pd (x, _mm256_set1_pd (FOUR_OVER_PI)));
+  __m256d odd = _mm256_sub_pd (y, _mm256_mul_pd (_mm256_set1_pd (2.0),
+                                                 _mm256_floor_pd (_mm256_mul_pd (y, _mm256_set1_pd (0.5)))));
+  y = _mm256_add_pd (y, odd);
+  __m256d q = _mm256_sub_pd (y, _mm256_mul_pd (_mm256_set1_pd (8.0),
+                                               _mm256_floor_pd (_mm256_mul_pd (y, _mm256_set1_pd (0.125)))));
+
+  __m256d z = _mm256_sub_pd (x, _mm256_mul_pd (y, _mm256_set1_pd (DP1)));
+  z = _mm256_sub_pd (z, _mm256_mul_pd (y, _mm256_set1_pd (DP2)));
+  z = _mm256_sub_pd (z, _mm256_mul_pd (y, _mm256_set1_pd (DP3)));
+  __m256d zz = _mm256_mul_pd (z, z);
+
+  __m256d ps = _mm256_set1_pd (SIN_COF[0]);
+  __m256d pc = _mm256_set1_pd (COS_COF[0]);
+  for (int i = 1; i < 6; i++)
+    {
+      ps = _mm256_add_pd (_mm256_mul_pd (ps, zz), _mm256_set1_pd (SIN_COF[i]));
+      pc = _mm256_add_pd (_mm256_mul_pd (pc, zz), _mm256_set1_pd (COS_COF[i]));
+    }
+  __m256d s = _mm256_add_pd (z, _mm256_mul_pd (_mm256_mul_pd (z, zz), ps));
+  __m256d c = _mm256_add_pd (_mm256_sub_pd (_mm256_set1_pd (1.0), _mm256_mul_pd (zz, _mm256_set1_pd (0.5))),
+                             _mm256_mul_pd (_mm256_mul_pd (zz, zz), pc));
+
+  // octants 2 and 6 swap the polynomials, 4 and 6 negate the sine, 2 and 4 the cosine
+  __m256d two = _mm256_cmp_pd (q, _mm256_set1_pd (2.0), _CMP_EQ_OQ);
+  __m256d four = _mm256_cmp_pd (q, _mm256_set1_pd (4.0), _CMP_EQ_OQ);
+  __m256d six = _mm256_cmp_pd (q, _mm256_set1_pd (6.0), _CMP_EQ_OQ);
+  __m256d swap = _mm256_or_pd (two, six);
+  __m256d sinValue = _mm256_blendv_pd (s, c, swap);
+  __m256d cosValue = _mm256_blendv_pd (c, s, swap);
+  __m256d sinSign = _mm256_xor_pd (_mm256_and_pd (_mm256_or_pd (four, six), signBit), xSign);
+  __m256d cosSign = _mm256_and_pd (_mm256_or_pd (two, four), signBit);
+  _mm256_storeu_pd (sine, _mm256_xor_pd (sinValue, sinSign));
+  _mm256_storeu_pd (cosine, _mm256_xor_pd (cosValue, cosSign));
+}
+
+#elif defined (__SSE2__)
+static const size_t LANES = 2;
+
+/**
+ * Floor of non-negative values below 2^31, SSE2 has no rounding instruction.
+ * \param x the values
+ * \return floor (x)
+ */
+static inline __m128d
+FloorPositive (__m128d x)
+{
+  return _mm_cvtepi32_pd (_mm_cvttpd_epi32 (x));
+}
+
+static inline __m128d
+Select (__m128d mask, __m128d ifTrue, __m128d ifFalse)
+{
+  return _mm_or_pd (_mm_and_pd (mask, ifTrue), _mm_andnot_pd (mask, ifFalse));
+}
+
+static void
+SinCosLanes (const double *angle, double *sine, double *cosine)
+{
+  const __m128d signBit = _mm_set1_pd (-0.0);
+  __m128d a = _mm_loadu_pd (angle);
+  __m128d x = _mm_andnot_pd (signBit, a);
+  __m128d xSign = _mm_and_pd (signBit, a);
+
+  // octant of |x|, rounded up to an even one
+  __m128d y = FloorPositive (_mm_mul_pd (x, _mm_set1_pd (FOUR_OVER_PI)));
+  __m128d odd = _mm_sub_pd (y, _mm_mul_pd (_mm_set1_pd (2.0), FloorPositive (_mm_mul_pd (y, _mm_set1_pd (0.5)))));
+  y = _mm_add_pd (y, odd);
+  __m128d q = _mm_sub_pd (y, _mm_mul_pd (_mm_set1_pd (8.0), FloorPositive (_mm_mul_pd (y, _mm_set1_pd (0.125)))));
+
+  __m128d z = _mm_sub_pd (x, _mm_mul_pd (y, _mm_set1_pd (DP1)));
+  z = _mm_sub_pd (z, _mm_mul_pd (y, _mm_set1_pd (DP2)));
+  z = _mm_sub_pd (z, _mm_mul_pd (y, _mm_set1_pd (DP3)));
+  __m128d zz = _mm_mul_pd (z, z);
+
+  __m128d ps = _mm_set1_pd (SIN_COF[0]);
+  __m128d pc = _mm_set1_pd (COS_COF[0]);
+  for (int i = 1; i < 6; i++)
+    {
+      ps = _mm_add_pd (_mm_mul_pd (ps, zz), _mm_set1_pd (SIN_COF[i]));
+      pc = _mm_add_pd (_mm_mul_pd (pc, zz), _mm_set1_pd (COS_COF[i]));
+    }
+  __m128d s = _mm_add_pd (z, _mm_mul_pd (_mm_mul_pd (z, zz), ps));
+  __m128d c = _mm_add_pd (_mm_sub_pd (_mm_set1_pd (1.0), _mm_mul_pd (zz, _mm_set1_pd (0.5))),
+                          _mm_mul_pd (_mm_mul_pd (zz, zz), pc));
+
+  // octants 2 and 6 swap the polynomials, 4 and 6 negate the sine, 2 and 4 the cosine
+  __m128d two = _mm_cmpeq_pd (q, _mm_set1_pd (2.0));
+  __m128d four = _mm_cmpeq_pd (q, _mm_set1_pd (4.0));
+  __m128d six = _mm_cmpeq_pd (q, _mm_set1_pd (6.0));
+  __m128d swap = _mm_or_pd (two, six);
+  __m128d sinValue = Select (swap, c, s);
+  __m128d cosValue = Select (swap, s, c);
+  __m128d sinSign = _mm_xor_pd (_mm_and_pd (_mm_or_pd (four, six), signBit), xSign);
+  __m128d cosSign = _mm_and_pd (_mm_or_pd (two, four), signBit);
+  _mm_storeu_pd (sine, _mm_xor_pd (sinValue, sinSign));
+  _mm_storeu_pd (cosine, _mm_xor_pd (cosValue, cosSign));
+}
+
+#else
+static const size_t LANES = 1;
+
+static void
+SinCosLanes (const double *angle, double *sine, double *cosine)
+{
+  *sine = std::sin (*angle);
+  *cosine = std::cos (*angle);
+}
+#endif
+
+void
+BatchSinCos (const double *angle, double *sine, double *cosine, size_t n)
+{
+  size_t i = 0;
+  for (; i + LANES <= n; i += LANES)
+    {
+      SinCosLanes (angle + i, sine + i, cosine + i);
+    }
+  for (; i < n; i++)
+    {
+      sine[i] = std::sin (angle[i]);
+      cosine[i] = std::cos (angle[i]);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,45 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef BATCH_SINCOS_H
+#define BATCH_SINCOS_H
+
+#include <stddef.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Compute the sine and cosine of a batch of angles.
+ *
+ * When the module is compiled with AVX2 or SSE2 enabled, four or two
+ * angles are reduced to [-pi/4, pi/4] and evaluated with the Cephes
+ * minimax polynomials in one go; the results agree with std::sin and
+ * std::cos to within a couple of ulps.  Otherwise this falls back to the
+ * scalar library functions.
+ *
+ * The range reduction is meant for orbit angles: keep |angle| below
+ * about 1e8 radians.
+ *
+ * \param angle the angles, in radians
+ * \param sine receives sin (angle[i])
+ * \param cosine receives cos (angle[i])
+ * \param n the number of angles
+ */
+void BatchSinCos (const double *angle, double *sine, double *cosine, size_t n);
+
+} // namespace ns3
+
+#endif /* BATCH_SINCOS_H */
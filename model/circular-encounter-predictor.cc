@@ -0,0 +1,307 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
+#include "circular-encounter-predictor.h"
+#include "constant-time-circular-motion-model.h"
+#include "semi-random-circular-mobility-model.h"
+#include "circular-swarm-mobility-model.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CircularEncounterPredictor");
+
+NS_OBJECT_ENSURE_REGISTERED (CircularEncounterPredictor);
+
+TypeId
+CircularEncounterPredictor::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CircularEncounterPredictor")
+    .SetParent<Object> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<CircularEncounterPredictor> ()
+    .AddAttribute ("Range",
+                   "Distance below which two drones are in contact",
+                   DoubleValue (100.0),
+                   MakeDoubleAccessor (&CircularEncounterPredictor::m_range),
+                   MakeDoubleChecker<double> (0.0))
+    .AddTraceSource ("EncounterStart",
+                     "Two drones came within range",
+                     MakeTraceSourceAccessor (&CircularEncounterPredictor::m_encounterStartTrace),
+                     "ns3::CircularEncounterPredictor::EncounterTracedCallback")
+    .AddTraceSource ("EncounterEnd",
+                     "Two drones went out of range",
+                     MakeTraceSourceAccessor (&CircularEncounterPredictor::m_encounterEndTrace),
+                     "ns3::CircularEncounterPredictor::EncounterTracedCallback")
+  ;
+  return tid;
+}
+
+CircularEncounterPredictor::CircularEncounterPredictor ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+CircularEncounterPredictor::~CircularEncounterPredictor ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+CircularEncounterPredictor::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Pair>::iterator i = m_pairs.begin (); i != m_pairs.end (); ++i)
+    {
+      i->event.Cancel ();
+    }
+  for (std::vector<Ptr<MobilityModel> >::iterator i = m_models.begin (); i != m_models.end (); ++i)
+    {
+      (*i)->TraceDisconnectWithoutContext ("CourseChange",
+                                           MakeCallback (&CircularEncounterPredictor::CourseChanged, this));
+    }
+  m_models.clear ();
+  m_indices.clear ();
+  m_pairs.clear ();
+  Object::DoDispose ();
+}
+
+uint32_t
+CircularEncounterPredictor::Add (Ptr<MobilityModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  NS_ASSERT_MSG (m_indices.find (PeekPointer (model)) == m_indices.end (), "Drone added twice");
+  uint32_t index = m_models.size ();
+  m_models.push_back (model);
+  m_indices[PeekPointer (model)] = index;
+  Pair pair;
+  pair.inContact = false;
+  pair.inDuration = 0.0;
+  pair.outDuration = 0.0;
+  m_pairs.resize (m_pairs.size () + index, pair);
+  model->TraceConnectWithoutContext ("CourseChange",
+                                     MakeCallback (&CircularEncounterPredictor::CourseChanged, this));
+  for (uint32_t j = 0; j < index; j++)
+    {
+      Predict (index, j);
+    }
+  return index;
+}
+
+uint32_t
+CircularEncounterPredictor::GetN (void) const
+{
+  return m_models.size ();
+}
+
+CircularEncounterPredictor::Pair &
+CircularEncounterPredictor::GetPair (uint32_t i, uint32_t j)
+{
+  NS_ASSERT (i != j && i < GetN () && j < GetN ());
+  if (i < j)
+    {
+      std::swap (i, j);
+    }
+  return m_pairs[i * (i - 1) / 2 + j];
+}
+
+const CircularEncounterPredictor::Pair &
+CircularEncounterPredictor::GetPair (uint32_t i, uint32_t j) const
+{
+  NS_ASSERT (i != j && i < GetN () && j < GetN ());
+  if (i < j)
+    {
+      std::swap (i, j);
+    }
+  return m_pairs[i * (i - 1) / 2 + j];
+}
+
+bool
+CircularEncounterPredictor::IsInContact (uint32_t i, uint32_t j) const
+{
+  return GetPair (i, j).inContact;
+}
+
+Time
+CircularEncounterPredictor::GetNextContactChange (uint32_t i, uint32_t j) const
+{
+  const Pair &pair = GetPair (i, j);
+  if (!pair.event.IsRunning ())
+    {
+      return Time::Max ();
+    }
+  return TimeStep (pair.event.GetTs ());
+}
+
+Time
+CircularEncounterPredictor::SolveContact (const ConstantAngularVelocityHelper &a, const ConstantAngularVelocityHelper &b,
+                                          double range, bool &inContact, double &inDuration, double &outDuration)
+{
+  Time now = Simulator::Now ();
+  double r1 = a.GetRadius ();
+  double r2 = b.GetRadius ();
+  double dz = a.GetCurrentPosition ().z - b.GetCurrentPosition ().z;
+  inDuration = 0.0;
+  outDuration = 0.0;
+  if (r1 == 0 || r2 == 0)
+    {
+      // a drone at the center keeps the same distance to everyone
+      inContact = r1 * r1 + r2 * r2 + dz * dz < range * range;
+      return Time::Max ();
+    }
+  double threshold = (r1 * r1 + r2 * r2 + dz * dz - range * range) / (2 * r1 * r2);
+  if (threshold >= 1.0 || threshold <= -1.0)
+    {
+      // the orbits are always out of range, or always within range
+      inContact = threshold <= -1.0;
+      return Time::Max ();
+    }
+  // contact while the angle difference, brought back to (-pi, pi], is within (-alpha, alpha)
+  double alpha = std::acos (threshold);
+  double phi = std::fmod (a.GetThetaAt (now) - b.GetThetaAt (now), 2 * M_PI);
+  if (phi > M_PI)
+    {
+      phi -= 2 * M_PI;
+    }
+  else if (phi <= -M_PI)
+    {
+      phi += 2 * M_PI;
+    }
+  inContact = std::fabs (phi) < alpha;
+  double rate = a.GetAngularRate () - b.GetAngularRate ();
+  if (rate == 0)
+    {
+      return Time::Max ();
+    }
+  if (rate < 0)
+    {
+      // mirror so that the angle difference grows
+      phi = -phi;
+      rate = -rate;
+    }
+  inDuration = 2 * alpha / rate;
+  outDuration = (2 * M_PI - 2 * alpha) / rate;
+  if (inContact)
+    {
+      return Seconds ((alpha - phi) / rate);
+    }
+  return Seconds (std::fmod (2 * M_PI - alpha - phi, 2 * M_PI) / rate);
+}
+
+bool
+CircularEncounterPredictor::GetOrbitPhase (uint32_t index, ConstantAngularVelocityHelper &phase) const
+{
+  Ptr<MobilityModel> model = m_models[index];
+  Ptr<ConstantTimeCircularMotionModel> constantTime = DynamicCast<ConstantTimeCircularMotionModel> (model);
+  if (constantTime)
+    {
+      return constantTime->GetOrbitPhase (phase);
+    }
+  Ptr<SemiRandomCircularMobilityModel> semiRandom = DynamicCast<SemiRandomCircularMobilityModel> (model);
+  if (semiRandom)
+    {
+      return semiRandom->GetOrbitPhase (phase);
+    }
+  Ptr<CircularSwarmMobilityModel> swarm = DynamicCast<CircularSwarmMobilityModel> (model);
+  if (swarm)
+    {
+      return swarm->GetOrbitPhase (phase);
+    }
+  return false;
+}
+
+void
+CircularEncounterPredictor::Predict (uint32_t i, uint32_t j)
+{
+  NS_LOG_FUNCTION (this << i << j);
+  Pair &pair = GetPair (i, j);
+  pair.event.Cancel ();
+  ConstantAngularVelocityHelper a;
+  ConstantAngularVelocityHelper b;
+  if (!GetOrbitPhase (i, a) || !GetOrbitPhase (j, b))
+    {
+      SetContact (i, j, false);
+      return;
+    }
+  Vector2D ca = a.GetCenter ();
+  Vector2D cb = b.GetCenter ();
+  if (ca.x != cb.x || ca.y != cb.y)
+    {
+      SetContact (i, j, false);
+      return;
+    }
+  bool inContact;
+  Time next = SolveContact (a, b, m_range, inContact, pair.inDuration, pair.outDuration);
+  SetContact (i, j, inContact);
+  if (next != Time::Max ())
+    {
+      pair.event = Simulator::Schedule (next, &CircularEncounterPredictor::ContactChange, this, i, j);
+    }
+}
+
+void
+CircularEncounterPredictor::ContactChange (uint32_t i, uint32_t j)
+{
+  NS_LOG_FUNCTION (this << i << j);
+  Pair &pair = GetPair (i, j);
+  bool inContact = !pair.inContact;
+  SetContact (i, j, inContact);
+  // the windows repeat with the relative period of the two orbits
+  double next = inContact ? pair.inDuration : pair.outDuration;
+  pair.event = Simulator::Schedule (Seconds (next), &CircularEncounterPredictor::ContactChange, this, i, j);
+}
+
+void
+CircularEncounterPredictor::SetContact (uint32_t i, uint32_t j, bool inContact)
+{
+  Pair &pair = GetPair (i, j);
+  if (pair.inContact == inContact)
+    {
+      return;
+    }
+  pair.inContact = inContact;
+  NS_LOG_INFO ("Drones " << i << " and " << j << (inContact ? " enter" : " leave") << " range");
+  if (inContact)
+    {
+      m_encounterStartTrace (m_models[i], m_models[j]);
+    }
+  else
+    {
+      m_encounterEndTrace (m_models[i], m_models[j]);
+    }
+}
+
+void
+CircularEncounterPredictor::CourseChanged (Ptr<const MobilityModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  std::map<const MobilityModel *, uint32_t>::const_iterator it = m_indices.find (PeekPointer (model));
+  NS_ASSERT (it != m_indices.end ());
+  uint32_t index = it->second;
+  for (uint32_t j = 0; j < GetN (); j++)
+    {
+      if (j != index)
+        {
+          Predict (index, j);
+        }
+    }
+}
+
+} // namespace ns3
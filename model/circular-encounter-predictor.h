@@ -0,0 +1,176 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef CIRCULAR_ENCOUNTER_PREDICTOR_H
+#define CIRCULAR_ENCOUNTER_PREDICTOR_H
+
+#include <map>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/traced-callback.h"
+#include "constant-angular-velocity-helper.h"
+#include "mobility-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Predict when drones on concentric orbits come within range.
+ *
+ * Two drones flying orbits of radii r1 and r2 around the same center, at
+ * altitudes z1 and z2, are at distance d with
+ * d^2 = r1^2 + r2^2 - 2 r1 r2 cos (dtheta) + (z1 - z2)^2, so they are in
+ * contact exactly when
+ * cos (dtheta) > (r1^2 + r2^2 + (z1 - z2)^2 - R^2) / (2 r1 r2).
+ * The angle difference dtheta grows linearly at the difference of their
+ * angular rates, so the contact windows are periodic and are solved in
+ * closed form.
+ *
+ * The predictor schedules one event per pair at the next time the pair
+ * enters or leaves range, and fires the EncounterStart and EncounterEnd
+ * trace sources there.  It listens to the CourseChange trace of every
+ * drone and only recomputes the pairs of a drone whose course changed.
+ *
+ * Drones are followed while they fly an orbit of an
+ * ns3::ConstantTimeCircularMotionModel, ns3::SemiRandomCircularMobilityModel
+ * or ns3::CircularSwarmMobilityModel.  A pair is not predicted while one of
+ * its drones moves between orbits or when their orbits are not concentric;
+ * a contact in progress is then closed.
+ */
+class CircularEncounterPredictor : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  CircularEncounterPredictor ();
+  virtual ~CircularEncounterPredictor ();
+
+  /**
+   * TracedCallback signature for contact window boundaries.
+   * \param [in] a the mobility model of the first drone
+   * \param [in] b the mobility model of the second drone
+   */
+  typedef void (* EncounterTracedCallback)(Ptr<const MobilityModel> a, Ptr<const MobilityModel> b);
+
+  /**
+   * Follow a drone and predict its encounters with every drone added so far.
+   * \param model the mobility model of the drone
+   * \return the index of the drone
+   */
+  uint32_t Add (Ptr<MobilityModel> model);
+  /**
+   * \return the number of drones followed
+   */
+  uint32_t GetN (void) const;
+  /**
+   * \param i the index of a drone
+   * \param j the index of another drone
+   * \return true if the two drones are currently within range
+   */
+  bool IsInContact (uint32_t i, uint32_t j) const;
+  /**
+   * \param i the index of a drone
+   * \param j the index of another drone
+   * \return the time at which the pair next enters or leaves range, or
+   * Time::Max () if that is not predicted
+   */
+  Time GetNextContactChange (uint32_t i, uint32_t j) const;
+
+  /**
+   * Solve the contact of two drones on concentric orbits.
+   * \param a the orbit of the first drone
+   * \param b the orbit of the second drone
+   * \param range the communication range
+   * \param inContact set to true if the drones are within range now
+   * \param inDuration set to the length of a contact window, in seconds
+   * \param outDuration set to the time between two contact windows, in seconds
+   * \return the time from now until the contact next changes, Time::Max ()
+   * if it never does
+   */
+  static Time SolveContact (const ConstantAngularVelocityHelper &a, const ConstantAngularVelocityHelper &b,
+                            double range, bool &inContact, double &inDuration, double &outDuration);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// Contact state of a pair of drones
+  struct Pair
+  {
+    bool inContact; //!< true while the drones are within range
+    double inDuration; //!< length of a contact window, in seconds
+    double outDuration; //!< time between two contact windows, in seconds
+    EventId event; //!< next enter or leave event
+  };
+  /**
+   * \param i the index of a drone
+   * \param j the index of another drone
+   * \return the pair of the two drones
+   */
+  Pair & GetPair (uint32_t i, uint32_t j);
+  /**
+   * \param i the index of a drone
+   * \param j the index of another drone
+   * \return the pair of the two drones
+   */
+  const Pair & GetPair (uint32_t i, uint32_t j) const;
+  /**
+   * \param index the index of a drone
+   * \param phase set to the orbit of the drone
+   * \return false if the drone is not flying an orbit
+   */
+  bool GetOrbitPhase (uint32_t index, ConstantAngularVelocityHelper &phase) const;
+  /**
+   * Solve a pair again from the current orbits of its drones.
+   * \param i the index of a drone
+   * \param j the index of another drone
+   */
+  void Predict (uint32_t i, uint32_t j);
+  /**
+   * A pair reached the boundary of a contact window.
+   * \param i the index of a drone
+   * \param j the index of another drone
+   */
+  void ContactChange (uint32_t i, uint32_t j);
+  /**
+   * Record a new contact state and fire the matching trace.
+   * \param i the index of a drone
+   * \param j the index of another drone
+   * \param inContact the new contact state
+   */
+  void SetContact (uint32_t i, uint32_t j, bool inContact);
+  /**
+   * CourseChange trace sink of the drones.
+   * \param model the drone whose course changed
+   */
+  void CourseChanged (Ptr<const MobilityModel> model);
+
+  double m_range; //!< communication range
+  std::vector<Ptr<MobilityModel> > m_models; //!< drones followed
+  std::map<const MobilityModel *, uint32_t> m_indices; //!< index of each drone
+  std::vector<Pair> m_pairs; //!< pair (i, j), j < i, is at i * (i - 1) / 2 + j
+  TracedCallback<Ptr<const MobilityModel>, Ptr<const MobilityModel> > m_encounterStartTrace; //!< contact starts
+  TracedCallback<Ptr<const MobilityModel>, Ptr<const MobilityModel> > m_encounterEndTrace; //!< contact ends
+};
+
+} // namespace ns3
+
+#endif /* CIRCULAR_ENCOUNTER_PREDICTOR_H */
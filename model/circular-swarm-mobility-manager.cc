@@ -0,0 +1,412 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+#include "ns3/log.h"
+#include "circular-swarm-mobility-manager.h"
+#include "circular-swarm-mobility-model.h"
+#include "batch-sincos.h"
+#include "mobility-stats.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CircularSwarmMobilityManager");
+
+NS_OBJECT_ENSURE_REGISTERED (CircularSwarmMobilityManager);
+
+TypeId
+CircularSwarmMobilityManager::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CircularSwarmMobilityManager")
+    .SetParent<Object> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<CircularSwarmMobilityManager> ()
+    .AddAttribute ("Center",
+                   "Center of the orbits of the swarm",
+                   Vector2DValue (Vector2D (0.0, 0.0)),
+                   MakeVector2DAccessor (&CircularSwarmMobilityManager::m_center),
+                   MakeVector2DChecker ())
+    .AddAttribute ("InterOrbitDistance",
+                   "Distance between 2 successive orbits",
+                   DoubleValue (75.0),
+                   MakeDoubleAccessor (&CircularSwarmMobilityManager::SetInterOrbitDistance,
+                                       &CircularSwarmMobilityManager::GetInterOrbitDistance),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("MaximumRadius",
+                   "The maximum surveillance radius that the drones should patrol",
+                   DoubleValue (750.0),
+                   MakeDoubleAccessor (&CircularSwarmMobilityManager::SetMaximumRadius,
+                                       &CircularSwarmMobilityManager::GetMaximumRadius),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("TangentialVelocity",
+                   "Velocity of a drone along its orbit",
+                   DoubleValue (5.0),
+                   MakeDoubleAccessor (&CircularSwarmMobilityManager::m_tangentialVelocity),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("RadialVelocity",
+                   "Velocity of a drone while moving between orbits",
+                   DoubleValue (10.0),
+                   MakeDoubleAccessor (&CircularSwarmMobilityManager::m_radialVelocity),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("TimeToFlyInOrbit",
+                   "The time to fly in an orbit before switching orbits",
+                   TimeValue (Seconds (10.0)),
+                   MakeTimeAccessor (&CircularSwarmMobilityManager::m_timeInOrbit),
+                   MakeTimeChecker ())
+    .AddAttribute ("Epsilon",
+                   "A drone walks to the upper/lower orbit with probability epsilon "
+                   "and flies to a random orbit with probability (1-epsilon)",
+                   DoubleValue (0.99),
+                   MakeDoubleAccessor (&CircularSwarmMobilityManager::m_epsilon),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("WalkOrFlight",
+                   "A random variable which decides between a random walk and a random flight",
+                   StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=1.0]"),
+                   MakePointerAccessor (&CircularSwarmMobilityManager::m_walkOrFlight),
+                   MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("OrbitChoice",
+                   "A random variable which decides which orbit to move to next",
+                   StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=1.0]"),
+                   MakePointerAccessor (&CircularSwarmMobilityManager::m_orbitChoice),
+                   MakePointerChecker<RandomVariableStream> ())
+  ;
+  return tid;
+}
+
+CircularSwarmMobilityManager::CircularSwarmMobilityManager ()
+  : m_orbitDistance (75.0),
+    m_maxRadius (750.0)
+{
+  NS_LOG_FUNCTION (this);
+  m_transitions.Configure (m_orbitDistance, m_maxRadius);
+}
+
+CircularSwarmMobilityManager::~CircularSwarmMobilityManager ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+CircularSwarmMobilityManager::SetInterOrbitDistance (double distance)
+{
+  NS_LOG_FUNCTION (this << distance);
+  m_orbitDistance = distance;
+  m_transitions.Configure (m_orbitDistance, m_maxRadius);
+}
+
+double
+CircularSwarmMobilityManager::GetInterOrbitDistance (void) const
+{
+  return m_orbitDistance;
+}
+
+void
+CircularSwarmMobilityManager::SetMaximumRadius (double radius)
+{
+  NS_LOG_FUNCTION (this << radius);
+  m_maxRadius = radius;
+  m_transitions.Configure (m_orbitDistance, m_maxRadius);
+}
+
+double
+CircularSwarmMobilityManager::GetMaximumRadius (void) const
+{
+  return m_maxRadius;
+}
+
+const OrbitTransitionTable &
+CircularSwarmMobilityManager::GetTransitionTable (void) const
+{
+  return m_transitions;
+}
+
+void
+CircularSwarmMobilityManager::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<EventId>::iterator i = m_events.begin (); i != m_events.end (); ++i)
+    {
+      i->Cancel ();
+    }
+  // the facades hold a pointer to us, break the cycle
+  m_models.clear ();
+  Object::DoDispose ();
+}
+
+uint32_t
+CircularSwarmMobilityManager::Add (Ptr<CircularSwarmMobilityModel> model, const Vector &position)
+{
+  NS_LOG_FUNCTION (this << model << position);
+  uint32_t index = m_radius.size ();
+  m_radius.push_back (0.0);
+  m_theta0.push_back (0.0);
+  m_omega.push_back (0.0);
+  m_direction.push_back (1.0);
+  m_z.push_back (0.0);
+  m_phaseStart.push_back (0.0);
+  m_phaseType.push_back (ORBIT_PHASE);
+  m_events.push_back (EventId ());
+  m_models.push_back (model);
+  SetPosition (index, position);
+  return index;
+}
+
+uint32_t
+CircularSwarmMobilityManager::GetN (void) const
+{
+  return m_radius.size ();
+}
+
+void
+CircularSwarmMobilityManager::SetPosition (uint32_t index, const Vector &position)
+{
+  NS_LOG_FUNCTION (this << index << position);
+  NS_ASSERT (index < GetN ());
+  m_events[index].Cancel ();
+  double dx = position.x - m_center.x;
+  double dy = position.y - m_center.y;
+  m_z[index] = position.z;
+  StartOrbit (index, std::sqrt (dx * dx + dy * dy), std::atan2 (dy, dx));
+  NotifyCourseChange (index);
+}
+
+Vector
+CircularSwarmMobilityManager::GetPosition (uint32_t index) const
+{
+  NS_ASSERT (index < GetN ());
+  double t = Simulator::Now ().GetSeconds () - m_phaseStart[index];
+  if (m_phaseType[index] == ORBIT_PHASE)
+    {
+      double theta = m_theta0[index] + m_direction[index] * m_omega[index] * t;
+      return Vector (m_center.x + m_radius[index] * std::cos (theta),
+                     m_center.y + m_radius[index] * std::sin (theta),
+                     m_z[index]);
+    }
+  double distance = m_radius[index] + m_omega[index] * t;
+  return Vector (m_center.x + distance * std::cos (m_theta0[index]),
+                 m_center.y + distance * std::sin (m_theta0[index]),
+                 m_z[index]);
+}
+
+Vector
+CircularSwarmMobilityManager::GetVelocity (uint32_t index) const
+{
+  NS_ASSERT (index < GetN ());
+  if (m_phaseType[index] == ORBIT_PHASE)
+    {
+      double t = Simulator::Now ().GetSeconds () - m_phaseStart[index];
+      double theta = m_theta0[index] + m_direction[index] * m_omega[index] * t;
+      double speed = m_direction[index] * m_omega[index] * m_radius[index];
+      return Vector (-speed * std::sin (theta), speed * std::cos (theta), 0.0);
+    }
+  return Vector (m_omega[index] * std::cos (m_theta0[index]),
+                 m_omega[index] * std::sin (m_theta0[index]),
+                 0.0);
+}
+
+CircularSwarmMobilityManager::PhaseType
+CircularSwarmMobilityManager::GetPhaseType (uint32_t index) const
+{
+  NS_ASSERT (index < GetN ());
+  return static_cast<PhaseType> (m_phaseType[index]);
+}
+
+bool
+CircularSwarmMobilityManager::GetOrbitPhase (uint32_t index, ConstantAngularVelocityHelper &phase) const
+{
+  NS_ASSERT (index < GetN ());
+  if (m_phaseType[index] != ORBIT_PHASE)
+    {
+      return false;
+    }
+  phase = ConstantAngularVelocityHelper (m_center, Vector2D (m_omega[index], m_direction[index]), GetPosition (index));
+  phase.Unpause ();
+  return true;
+}
+
+TrajectorySegment
+CircularSwarmMobilityManager::GetSegment (uint32_t index) const
+{
+  NS_ASSERT (index < GetN ());
+  // the start is kept in seconds, do not let rounding move it past now
+  Time start = Min (Seconds (m_phaseStart[index]), Simulator::Now ());
+  Time end = m_events[index].IsRunning () ? TimeStep (m_events[index].GetTs ()) : Time::Max ();
+  if (m_phaseType[index] == ORBIT_PHASE)
+    {
+      return TrajectorySegment::CircularArc (start, end, m_center, m_radius[index], m_theta0[index],
+                                             m_direction[index] * m_omega[index], m_z[index]);
+    }
+  Vector origin = Vector (m_center.x + m_radius[index] * std::cos (m_theta0[index]),
+                          m_center.y + m_radius[index] * std::sin (m_theta0[index]),
+                          m_z[index]);
+  return TrajectorySegment::ConstantVelocity (start, end, origin, GetVelocity (index));
+}
+
+void
+CircularSwarmMobilityManager::GetPositions (std::vector<Vector> &positions) const
+{
+  NS_LOG_FUNCTION (this);
+  positions.resize (GetN ());
+  if (GetN () == 0)
+    {
+      return;
+    }
+  EvaluatePositions (0, GetN (), &positions[0]);
+}
+
+void
+CircularSwarmMobilityManager::GetPositions (const uint32_t *indices, uint32_t n, Vector *positions) const
+{
+  NS_LOG_FUNCTION (this << n);
+  EvaluatePositions (indices, n, positions);
+}
+
+void
+CircularSwarmMobilityManager::EvaluatePositions (const uint32_t *indices, uint32_t n, Vector *positions) const
+{
+  if (n == 0)
+    {
+      return;
+    }
+  double now = Simulator::Now ().GetSeconds ();
+  m_distance.resize (n);
+  m_angle.resize (n);
+  m_sine.resize (n);
+  m_cosine.resize (n);
+  for (uint32_t k = 0; k < n; k++)
+    {
+      uint32_t i = indices ? indices[k] : k;
+      NS_ASSERT (i < GetN ());
+      double t = now - m_phaseStart[i];
+      if (m_phaseType[i] == ORBIT_PHASE)
+        {
+          m_distance[k] = m_radius[i];
+          m_angle[k] = m_theta0[i] + m_direction[i] * m_omega[i] * t;
+        }
+      else
+        {
+          m_distance[k] = m_radius[i] + m_omega[i] * t;
+          m_angle[k] = m_theta0[i];
+        }
+    }
+  BatchSinCos (&m_angle[0], &m_sine[0], &m_cosine[0], n);
+  for (uint32_t k = 0; k < n; k++)
+    {
+      uint32_t i = indices ? indices[k] : k;
+      positions[k].x = m_center.x + m_distance[k] * m_cosine[k];
+      positions[k].y = m_center.y + m_distance[k] * m_sine[k];
+      positions[k].z = m_z[i];
+    }
+}
+
+int64_t
+CircularSwarmMobilityManager::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_walkOrFlight->SetStream (stream);
+  m_orbitChoice->SetStream (stream + 1);
+  return 2;
+}
+
+void
+CircularSwarmMobilityManager::StartOrbit (uint32_t index, double radius, double theta)
+{
+  NS_LOG_FUNCTION (this << index << radius << theta);
+  m_phaseType[index] = ORBIT_PHASE;
+  m_phaseStart[index] = Simulator::Now ().GetSeconds ();
+  m_radius[index] = radius;
+  m_theta0[index] = std::fmod (theta, 2 * M_PI);
+  m_omega[index] = radius > 0.0 ? m_tangentialVelocity / radius : 0.0;
+  // odd orbits turn counterclockwise and even orbits clockwise
+  double oddOrEven = std::fmod (radius / m_orbitDistance, 2.0);
+  m_direction[index] = (oddOrEven > 0.0 && oddOrEven <= 1.0) ? 1.0 : -1.0;
+  MOBILITY_STATS_COUNT (this, SCHEDULE);
+  m_events[index] = Simulator::Schedule (m_timeInOrbit, &CircularSwarmMobilityManager::EndOrbit, this, index);
+}
+
+void
+CircularSwarmMobilityManager::EndOrbit (uint32_t index)
+{
+  MOBILITY_STATS_SCOPE (this, UPDATE);
+  NS_LOG_FUNCTION (this << index);
+  double t = Simulator::Now ().GetSeconds () - m_phaseStart[index];
+  double theta = m_theta0[index] + m_direction[index] * m_omega[index] * t;
+  double radius = m_radius[index];
+  int orbit = std::round (radius / m_orbitDistance);
+  double speedFactor = 1.0;
+  int target = ChooseOrbit (orbit, speedFactor);
+  if (target == orbit)
+    {
+      NS_LOG_INFO ("Drone " << index << " stays in orbit " << orbit);
+      // the orbit restarts from a new anchor: the segment of the drone changed
+      StartOrbit (index, radius, theta);
+      NotifyCourseChange (index);
+      return;
+    }
+  double targetRadius = target * m_orbitDistance;
+  double speed = m_radialVelocity * speedFactor;
+  if (targetRadius < radius)
+    {
+      speed = -speed;
+    }
+  NS_LOG_INFO ("Drone " << index << " moves from orbit " << orbit << " to orbit " << target);
+  m_phaseType[index] = RADIAL_PHASE;
+  m_phaseStart[index] = Simulator::Now ().GetSeconds ();
+  m_theta0[index] = std::fmod (theta, 2 * M_PI);
+  m_omega[index] = speed;
+  MOBILITY_STATS_COUNT (this, SCHEDULE);
+  m_events[index] = Simulator::Schedule (Seconds ((targetRadius - radius) / speed),
+                                         &CircularSwarmMobilityManager::EndRadial, this, index, targetRadius);
+  NotifyCourseChange (index);
+}
+
+void
+CircularSwarmMobilityManager::EndRadial (uint32_t index, double radius)
+{
+  MOBILITY_STATS_SCOPE (this, UPDATE);
+  NS_LOG_FUNCTION (this << index << radius);
+  StartOrbit (index, radius, m_theta0[index]);
+  NotifyCourseChange (index);
+}
+
+int
+CircularSwarmMobilityManager::ChooseOrbit (int orbit, double &speedFactor)
+{
+  // same draws and transition law as ConstantTimeCircularMotionModel::DoOrbitSwitch
+  double coinFlip = m_walkOrFlight->GetValue ();
+  double rand = m_orbitChoice->GetValue ();
+  speedFactor = 1.0;
+  if (coinFlip >= m_epsilon)
+    {
+      return m_transitions.SampleFlight (rand);
+    }
+  return m_transitions.SampleWalk (orbit, rand, speedFactor);
+}
+
+void
+CircularSwarmMobilityManager::NotifyCourseChange (uint32_t index) const
+{
+  if (m_models[index])
+    {
+      m_models[index]->NotifySwarmCourseChange ();
+    }
+}
+
+} // namespace ns3
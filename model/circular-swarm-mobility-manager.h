@@ -0,0 +1,232 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef CIRCULAR_SWARM_MOBILITY_MANAGER_H
+#define CIRCULAR_SWARM_MOBILITY_MANAGER_H
+
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/event-id.h"
+#include "ns3/random-variable-stream.h"
+#include "orbit-transition-table.h"
+#include "constant-angular-velocity-helper.h"
+
+namespace ns3 {
+
+class CircularSwarmMobilityModel;
+
+/**
+ * \ingroup mobility
+ * \brief Structure-of-arrays engine for drones orbiting a common center.
+ *
+ * The manager runs the same surveillance pattern as
+ * ns3::ConstantTimeCircularMotionModel for a whole swarm: every drone
+ * flies TimeToFlyInOrbit on its orbit, then takes a random walk or random
+ * flight decision and moves radially to its next orbit.
+ *
+ * Instead of one Object with two helpers and three random variables per
+ * drone, the state of every drone lives in contiguous arrays indexed by the
+ * drone number.  Each phase is described by its start time, a radius, an
+ * angle theta0 and a rate omega:
+ *  - on an orbit the drone is at angle theta0 + direction*omega*t on the
+ *    circle of the given radius,
+ *  - on a radial leg the drone is at distance radius + omega*t from the
+ *    center along angle theta0 (omega is then a signed radial speed).
+ *
+ * Positions are evaluated in closed form and only phase transitions are
+ * scheduled.  Per-node ns3::CircularSwarmMobilityModel facades index into
+ * the manager so that the rest of the simulator sees regular mobility
+ * models, while bulk consumers can use GetPositions to refresh the whole
+ * swarm in one cache-friendly pass.
+ */
+class CircularSwarmMobilityManager : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  CircularSwarmMobilityManager ();
+  virtual ~CircularSwarmMobilityManager ();
+
+  /// Kind of motion a drone is currently in
+  enum PhaseType
+  {
+    ORBIT_PHASE,
+    RADIAL_PHASE
+  };
+
+  /**
+   * Register a drone with the swarm and start surveillance from position.
+   * \param model the facade to notify on course changes, may be null
+   * \param position the initial position of the drone
+   * \return the index of the drone in the swarm
+   */
+  uint32_t Add (Ptr<CircularSwarmMobilityModel> model, const Vector &position);
+  /**
+   * \return the number of drones in the swarm
+   */
+  uint32_t GetN (void) const;
+  /**
+   * Move a drone and restart its surveillance from there.
+   * \param index the drone index
+   * \param position the new position
+   */
+  void SetPosition (uint32_t index, const Vector &position);
+  /**
+   * \param index the drone index
+   * \return the current position of the drone
+   */
+  Vector GetPosition (uint32_t index) const;
+  /**
+   * \param index the drone index
+   * \return the current velocity of the drone
+   */
+  Vector GetVelocity (uint32_t index) const;
+  /**
+   * \param index the drone index
+   * \return the phase the drone is currently in
+   */
+  PhaseType GetPhaseType (uint32_t index) const;
+  /**
+   * Evaluate the position of every drone at the current time.
+   * \param positions resized to GetN () and filled in drone index order
+   */
+  void GetPositions (std::vector<Vector> &positions) const;
+  /**
+   * Evaluate the position of some drones at the current time.
+   * \param indices the indices of the drones
+   * \param n the number of drones
+   * \param positions receives the n positions, in the order of indices
+   */
+  void GetPositions (const uint32_t *indices, uint32_t n, Vector *positions) const;
+  /**
+   * Describe the orbit a drone is flying.
+   * \param index the drone index
+   * \param phase set to a helper following the orbit from the current time
+   * \return false while the drone is moving between orbits
+   */
+  bool GetOrbitPhase (uint32_t index, ConstantAngularVelocityHelper &phase) const;
+  /**
+   * \param index the drone index
+   * \return the orbit arc or radial leg of the drone, until its next decision
+   */
+  TrajectorySegment GetSegment (uint32_t index) const;
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * shared by the swarm.
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned
+   */
+  int64_t AssignStreams (int64_t stream);
+  /**
+   * \return the orbit transition law shared by the swarm
+   */
+  const OrbitTransitionTable & GetTransitionTable (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \param distance the distance between two successive orbits
+   */
+  void SetInterOrbitDistance (double distance);
+  /**
+   * \return the distance between two successive orbits
+   */
+  double GetInterOrbitDistance (void) const;
+  /**
+   * \param radius the radius of the outermost orbit
+   */
+  void SetMaximumRadius (double radius);
+  /**
+   * \return the radius of the outermost orbit
+   */
+  double GetMaximumRadius (void) const;
+  /**
+   * Start an orbit phase at the current time.
+   * \param index the drone index
+   * \param radius the orbit radius
+   * \param theta the angle at which the drone enters the orbit
+   */
+  void StartOrbit (uint32_t index, double radius, double theta);
+  /**
+   * End of an orbit phase: pick the next orbit and fly there.
+   * \param index the drone index
+   */
+  void EndOrbit (uint32_t index);
+  /**
+   * End of a radial leg: start surveillance on the orbit reached.
+   * \param index the drone index
+   * \param radius the radius of the orbit reached
+   */
+  void EndRadial (uint32_t index, double radius);
+  /**
+   * Draw the next orbit from the random walk / random flight law.
+   * \param orbit the current orbit number
+   * \param speedFactor set to the radial speed multiplier of the transition
+   * \return the next orbit number
+   */
+  int ChooseOrbit (int orbit, double &speedFactor);
+  /**
+   * Notify the facade of a drone that its course changed.
+   * \param index the drone index
+   */
+  void NotifyCourseChange (uint32_t index) const;
+  /**
+   * Evaluate drone positions with the vectorized sine and cosine kernel.
+   * \param indices the indices of the drones, or null for drones 0 to n - 1
+   * \param n the number of drones
+   * \param positions receives the n positions
+   */
+  void EvaluatePositions (const uint32_t *indices, uint32_t n, Vector *positions) const;
+
+  Vector2D m_center; //!< center of every orbit
+  double m_orbitDistance; //!< distance between two successive orbits
+  double m_maxRadius; //!< radius of the outermost orbit
+  double m_tangentialVelocity; //!< speed along the orbits
+  double m_radialVelocity; //!< speed along the radial legs
+  double m_epsilon; //!< probability of a random walk decision
+  Time m_timeInOrbit; //!< time flown on an orbit before deciding
+  Ptr<RandomVariableStream> m_walkOrFlight; //!< walk or flight coin
+  Ptr<RandomVariableStream> m_orbitChoice; //!< orbit choice
+  OrbitTransitionTable m_transitions; //!< orbit decision law, compiled when the orbits are set
+
+  // per-drone state, one entry per drone index
+  std::vector<double> m_radius; //!< orbit radius, or leg start distance
+  std::vector<double> m_theta0; //!< angle at phase start, or leg bearing
+  std::vector<double> m_omega; //!< angular rate, or signed radial speed
+  std::vector<double> m_direction; //!< +1 counterclockwise, -1 clockwise
+  std::vector<double> m_z; //!< altitude of the drone
+  std::vector<double> m_phaseStart; //!< start time of the current phase, in seconds
+  std::vector<uint8_t> m_phaseType; //!< a PhaseType per drone
+  std::vector<EventId> m_events; //!< end of the current phase
+  std::vector<Ptr<CircularSwarmMobilityModel> > m_models; //!< facades
+
+  // scratch buffers of GetPositions, kept to avoid reallocating on every refresh
+  mutable std::vector<double> m_distance; //!< distance from the center
+  mutable std::vector<double> m_angle; //!< angle around the center
+  mutable std::vector<double> m_sine; //!< sine of m_angle
+  mutable std::vector<double> m_cosine; //!< cosine of m_angle
+};
+
+} // namespace ns3
+
+#endif /* CIRCULAR_SWARM_MOBILITY_MANAGER_H */
@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/pointer.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "circular-swarm-mobility-model.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CircularSwarmMobilityModel");
+
+NS_OBJECT_ENSURE_REGISTERED (CircularSwarmMobilityModel);
+
+TypeId
+CircularSwarmMobilityModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CircularSwarmMobilityModel")
+    .SetParent<MobilityModel> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<CircularSwarmMobilityModel> ()
+    .AddAttribute ("Manager", "The swarm manager holding the state of this drone.",
+                   PointerValue (),
+                   MakePointerAccessor (&CircularSwarmMobilityModel::m_manager),
+                   MakePointerChecker<CircularSwarmMobilityManager> ())
+  ;
+  return tid;
+}
+
+CircularSwarmMobilityModel::CircularSwarmMobilityModel ()
+  : m_index (0),
+    m_registered (false)
+{
+}
+
+CircularSwarmMobilityModel::~CircularSwarmMobilityModel ()
+{
+}
+
+void
+CircularSwarmMobilityModel::DoDispose (void)
+{
+  m_manager = 0;
+  MobilityModel::DoDispose ();
+}
+
+Ptr<CircularSwarmMobilityManager>
+CircularSwarmMobilityModel::GetManager (void) const
+{
+  return m_manager;
+}
+
+uint32_t
+CircularSwarmMobilityModel::GetIndex (void) const
+{
+  return m_index;
+}
+
+bool
+CircularSwarmMobilityModel::GetOrbitPhase (ConstantAngularVelocityHelper &phase) const
+{
+  if (!m_registered)
+    {
+      return false;
+    }
+  return m_manager->GetOrbitPhase (m_index, phase);
+}
+
+void
+CircularSwarmMobilityModel::NotifySwarmCourseChange (void) const
+{
+  NotifyCourseChange ();
+}
+
+Vector
+CircularSwarmMobilityModel::DoGetPosition (void) const
+{
+  if (!m_registered)
+    {
+      return Vector (0.0, 0.0, 0.0);
+    }
+  return m_manager->GetPosition (m_index);
+}
+
+void
+CircularSwarmMobilityModel::DoSetPosition (const Vector &position)
+{
+  NS_LOG_FUNCTION (this << position);
+  NS_ABORT_MSG_IF (m_manager == 0, "CircularSwarmMobilityModel needs a Manager");
+  if (!m_registered)
+    {
+      // register first: Add notifies the course change, whose sinks query us
+      m_index = m_manager->GetN ();
+      m_registered = true;
+      m_manager->Add (this, position);
+      return;
+    }
+  m_manager->SetPosition (m_index, position);
+}
+
+Vector
+CircularSwarmMobilityModel::DoGetVelocity (void) const
+{
+  if (!m_registered)
+    {
+      return Vector (0.0, 0.0, 0.0);
+    }
+  return m_manager->GetVelocity (m_index);
+}
+
+TrajectorySegment
+CircularSwarmMobilityModel::DoGetCurrentSegment (void) const
+{
+  if (!m_registered)
+    {
+      return TrajectorySegment::ConstantPosition (Simulator::Now (), Time::Max (), DoGetPosition ());
+    }
+  return m_manager->GetSegment (m_index);
+}
+
+uint32_t
+CircularSwarmMobilityModel::DoGetPositions (const Ptr<MobilityModel> *models, uint32_t n,
+                                            Vector *positions, Vector *velocities) const
+{
+  std::vector<uint32_t> indices;
+  TypeId tid = GetTypeId ();
+  for (uint32_t k = 0; k < n; k++)
+    {
+      if (models[k]->GetInstanceTypeId () != tid)
+        {
+          break;
+        }
+      const CircularSwarmMobilityModel *model = static_cast<const CircularSwarmMobilityModel *> (PeekPointer (models[k]));
+      if (!model->m_registered || model->m_manager != m_manager)
+        {
+          break;
+        }
+      indices.push_back (model->m_index);
+    }
+  if (indices.empty ())
+    {
+      // not registered yet, this drone is at the origin
+      positions[0] = DoGetPosition ();
+      if (velocities)
+        {
+          velocities[0] = DoGetVelocity ();
+        }
+      return 1;
+    }
+  m_manager->GetPositions (&indices[0], indices.size (), positions);
+  if (velocities)
+    {
+      for (uint32_t k = 0; k < indices.size (); k++)
+        {
+          velocities[k] = m_manager->GetVelocity (indices[k]);
+        }
+    }
+  return indices.size ();
+}
+
+} // namespace ns3
@@ -0,0 +1,83 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef CIRCULAR_SWARM_MOBILITY_MODEL_H
+#define CIRCULAR_SWARM_MOBILITY_MODEL_H
+
+#include "mobility-model.h"
+#include "circular-swarm-mobility-manager.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Per-node view of a drone managed by a CircularSwarmMobilityManager.
+ *
+ * The model holds no motion state of its own: the first SetPosition
+ * registers the drone with the manager given by the Manager attribute and
+ * every later query is answered by indexing into the manager's arrays.
+ */
+class CircularSwarmMobilityModel : public MobilityModel
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  CircularSwarmMobilityModel ();
+  virtual ~CircularSwarmMobilityModel ();
+
+  /**
+   * \return the manager this drone belongs to
+   */
+  Ptr<CircularSwarmMobilityManager> GetManager (void) const;
+  /**
+   * \return the index of this drone in its manager
+   */
+  uint32_t GetIndex (void) const;
+  /**
+   * Describe the orbit this drone is flying.
+   * \param phase set to a helper following the orbit from the current time
+   * \return false while the drone is moving between orbits
+   */
+  bool GetOrbitPhase (ConstantAngularVelocityHelper &phase) const;
+
+private:
+  friend class CircularSwarmMobilityManager;
+  /**
+   * Called by the manager when the course of this drone changed.
+   */
+  void NotifySwarmCourseChange (void) const;
+  virtual void DoDispose (void);
+  virtual Vector DoGetPosition (void) const;
+  virtual void DoSetPosition (const Vector &position);
+  virtual Vector DoGetVelocity (void) const;
+  /**
+   * Evaluate the run of facades of the same manager starting with this one
+   * in a single pass of the manager.
+   */
+  virtual uint32_t DoGetPositions (const Ptr<MobilityModel> *models, uint32_t n,
+                                   Vector *positions, Vector *velocities) const;
+  virtual TrajectorySegment DoGetCurrentSegment (void) const;
+
+  Ptr<CircularSwarmMobilityManager> m_manager; //!< the swarm manager
+  uint32_t m_index; //!< index of this drone in the manager
+  bool m_registered; //!< true once added to the manager
+};
+
+} // namespace ns3
+
+#endif /* CIRCULAR_SWARM_MOBILITY_MODEL_H */
@@ -17,6 +17,7 @@
  */
 #include "constant-acceleration-mobility-model.h"
 #include "ns3/simulator.h"
+#include "mobility-stats.h"
 
 namespace ns3 {
 
@@ -33,6 +34,7 @@ TypeId ConstantAccelerationMobilityModel::GetTypeId (void)
 
 ConstantAccelerationMobilityModel::ConstantAccelerationMobilityModel ()
 {
+  SetAnalyticSegment (DoGetCurrentSegment ());
 }
 
 ConstantAccelerationMobilityModel::~ConstantAccelerationMobilityModel ()
@@ -58,12 +60,20 @@ ConstantAccelerationMobilityModel::DoGetPosition (void) const
                  m_basePosition.z + m_baseVelocity.z*t + m_acceleration.z*half_t_square);
 }
 
+TrajectorySegment
+ConstantAccelerationMobilityModel::DoGetCurrentSegment (void) const
+{
+  return TrajectorySegment::ConstantAcceleration (m_baseTime, Time::Max (), m_basePosition,
+                                                  m_baseVelocity, m_acceleration);
+}
+
 void 
 ConstantAccelerationMobilityModel::DoSetPosition (const Vector &position)
 {
   m_baseVelocity = DoGetVelocity ();
   m_baseTime = Simulator::Now ();
   m_basePosition = position;
+  SetAnalyticSegment (DoGetCurrentSegment ());
   NotifyCourseChange ();
 }
 
@@ -71,10 +81,12 @@ void
 ConstantAccelerationMobilityModel::SetVelocityAndAcceleration (const Vector &velocity,
                                                                const Vector &acceleration)
 {
+  MOBILITY_STATS_SCOPE (this, UPDATE);
   m_basePosition = DoGetPosition ();
   m_baseTime = Simulator::Now ();
   m_baseVelocity = velocity;
   m_acceleration = acceleration;
+  SetAnalyticSegment (DoGetCurrentSegment ());
   NotifyCourseChange ();
 }
 
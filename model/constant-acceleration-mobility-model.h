@@ -53,6 +53,7 @@ private:
   virtual Vector DoGetPosition (void) const;
   virtual void DoSetPosition (const Vector &position);
   virtual Vector DoGetVelocity (void) const;
+  virtual TrajectorySegment DoGetCurrentSegment (void) const;
 
   Time m_baseTime;  //!< the base time
   Vector m_basePosition; //!< the base position
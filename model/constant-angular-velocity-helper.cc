@@ -2,19 +2,39 @@
 #include "ns3/rectangle.h"
 #include "ns3/box.h"
 #include "ns3/log.h"
+#include "mobility-stats.h"
 #include "constant-angular-velocity-helper.h"
+#include "batch-sincos.h"
+#include <vector>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("ConstantAngularVelocityHelper");
 
+/**
+ * \param theta an angle in radians
+ * \return the same angle brought back to [0, 2*PI)
+ */
+static double
+WrapAngle (double theta)
+{
+  theta = std::fmod (theta, 2*M_PI);
+  return theta < 0 ? theta + 2*M_PI : theta;
+}
+
 ConstantAngularVelocityHelper::ConstantAngularVelocityHelper ()
-  : m_paused (true)
+  : m_theta (0.0),
+    m_theta0 (0.0),
+    m_radius (0.0),
+    m_paused (true)
 {
   NS_LOG_FUNCTION (this);
 }
 ConstantAngularVelocityHelper::ConstantAngularVelocityHelper (const Vector2D &center)
   : center (center),
+    m_theta (0.0),
+    m_theta0 (0.0),
+    m_radius (0.0),
     m_paused (true)
 {
   NS_LOG_FUNCTION (this << center);
@@ -27,6 +47,10 @@ ConstantAngularVelocityHelper::ConstantAngularVelocityHelper (const Vector2D &ce
     m_paused (true)
 {
   NS_LOG_FUNCTION (this << center << omega);
+  m_radius = std::sqrt ((position.x - center.x)*(position.x - center.x) + (position.y - center.y)*(position.y - center.y));
+  m_theta = GetTheta (position);
+  m_lastUpdate = Simulator::Now ();
+  Rebase (m_lastUpdate);
 }
 
 void
@@ -34,8 +58,11 @@ ConstantAngularVelocityHelper::SetPosition (const Vector &position)
 {
   NS_LOG_FUNCTION (this << position);
   m_position = position;
+  m_radius = std::sqrt ((position.x - center.x)*(position.x - center.x) + (position.y - center.y)*(position.y - center.y));
+  m_theta = GetTheta (position);
   m_omega = Vector2D(0.0,1.0);
   m_lastUpdate = Simulator::Now ();
+  Rebase (m_lastUpdate);
 }
 
 Vector
@@ -45,6 +72,57 @@ ConstantAngularVelocityHelper::GetCurrentPosition (void) const
   return m_position;
 }
 
+Vector
+ConstantAngularVelocityHelper::GetPositionAt (const Time &t) const
+{
+  NS_LOG_FUNCTION (this << t);
+  if (m_paused)
+    {
+      return m_position;
+    }
+  double theta = GetThetaAt (t);
+  return Vector (center.x + m_radius * std::cos (theta),
+                 center.y + m_radius * std::sin (theta),
+                 m_position.z);
+}
+
+double
+ConstantAngularVelocityHelper::GetThetaAt (const Time &t) const
+{
+  NS_LOG_FUNCTION (this << t);
+  NS_ASSERT (m_lastUpdate <= t);
+  if (m_paused)
+    {
+      return m_theta;
+    }
+  return WrapAngle (m_theta0 + (t - m_t0).GetSeconds ()*m_omega.x*m_omega.y);
+}
+
+double
+ConstantAngularVelocityHelper::GetAngularRate (void) const
+{
+  return m_paused ? 0.0 : m_omega.x*m_omega.y;
+}
+
+TrajectorySegment
+ConstantAngularVelocityHelper::GetSegment (const Time &end) const
+{
+  NS_LOG_FUNCTION (this << end);
+  if (m_paused)
+    {
+      return TrajectorySegment::ConstantPosition (m_lastUpdate, end, m_position);
+    }
+  return TrajectorySegment::CircularArc (m_t0, end, center, m_radius, m_theta0,
+                                         m_omega.x*m_omega.y, m_position.z);
+}
+
+void
+ConstantAngularVelocityHelper::Rebase (const Time &t) const
+{
+  m_theta0 = m_theta;
+  m_t0 = t;
+}
+
 Vector2D 
 ConstantAngularVelocityHelper::GetOmega (void) const
 {
@@ -52,11 +130,15 @@ ConstantAngularVelocityHelper::GetOmega (void) const
   return m_paused ? Vector2D (0.0, 1.0) : m_omega;
 }
 
+Vector2D
+ConstantAngularVelocityHelper::GetCenter (void) const
+{
+  return center;
+}
+
 double ConstantAngularVelocityHelper::GetRadius() const
 {
-    double dx = m_position.x - center.x;
-    double dy = m_position.y - center.y;
-    return std::sqrt(dx*dx + dy*dy);
+    return m_radius;
 }
 void 
 ConstantAngularVelocityHelper::SetOmega (const Vector2D &omega)
@@ -64,6 +146,7 @@ ConstantAngularVelocityHelper::SetOmega (const Vector2D &omega)
   NS_LOG_FUNCTION (this << omega);
   m_omega = omega;
   m_lastUpdate = Simulator::Now ();
+  Rebase (m_lastUpdate);
 }
 
 void
@@ -71,33 +154,78 @@ ConstantAngularVelocityHelper::SetCenter(const Vector2D &cen)
 {
     NS_LOG_FUNCTION (this << cen);
     center = cen;
+    double dx = m_position.x - center.x;
+    double dy = m_position.y - center.y;
+    m_radius = std::sqrt(dx*dx + dy*dy);
+    m_theta = GetTheta(m_position);
     m_lastUpdate = Simulator::Now ();
+    Rebase (m_lastUpdate);
 }
 
 void
 ConstantAngularVelocityHelper::Update (void) const
 {
   NS_LOG_FUNCTION (this);
+  MOBILITY_STATS_HELPER_SCOPE (UPDATE);
   Time now = Simulator::Now ();
   NS_ASSERT (m_lastUpdate <= now);
-  Time deltaTime = now - m_lastUpdate;
   m_lastUpdate = now;
   if (m_paused)
     {
+      // a paused drone holds its angle, the phase restarts from here
+      Rebase (now);
       return;
     }
-  double deltaS = deltaTime.GetSeconds ();
-  double radius = GetRadius();
-  // augment value of theta between 0 and 2*PI
-  double theta = GetTheta(m_position);
-  theta= theta + deltaS*m_omega.x*m_omega.y;
-    
-    while (theta >= 2*M_PI)
+  // evaluated from the phase anchor rather than accumulated, so no drift
+  double theta = GetThetaAt (now);
+  m_theta = theta;
+  m_position.x = center.x + m_radius * std::cos(theta);
+  m_position.y = center.y + m_radius * std::sin(theta);
+}
+
+void
+ConstantAngularVelocityHelper::UpdateBatch (ConstantAngularVelocityHelper *const *helpers, size_t n,
+                                            std::vector<double> &scratch)
+{
+  NS_LOG_FUNCTION (n);
+  if (n == 0)
+    {
+      return;
+    }
+  Time now = Simulator::Now ();
+  // angles, sines and cosines side by side, only grown, never shrunk
+  if (scratch.size () < 3 * n)
+    {
+      scratch.resize (3 * n);
+    }
+  double *theta = &scratch[0];
+  double *sine = theta + n;
+  double *cosine = sine + n;
+  for (size_t i = 0; i < n; i++)
+    {
+      const ConstantAngularVelocityHelper *helper = helpers[i];
+      NS_ASSERT (helper->m_lastUpdate <= now);
+      helper->m_lastUpdate = now;
+      if (helper->m_paused)
+        {
+          helper->Rebase (now);
+        }
+      else
+        {
+          helper->m_theta = helper->GetThetaAt (now);
+        }
+      theta[i] = helper->m_theta;
+    }
+  BatchSinCos (theta, sine, cosine, n);
+  for (size_t i = 0; i < n; i++)
     {
-        theta -= 2*M_PI;
+      const ConstantAngularVelocityHelper *helper = helpers[i];
+      if (!helper->m_paused)
+        {
+          helper->m_position.x = helper->center.x + helper->m_radius * cosine[i];
+          helper->m_position.y = helper->center.y + helper->m_radius * sine[i];
+        }
     }
-  m_position.x = radius * std::cos(theta);
-  m_position.y = radius *std::sin(theta);
 }
 
 double 
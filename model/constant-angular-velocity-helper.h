@@ -8,13 +8,20 @@
  * Radius of rotation - the radius at which steady state has to be maintained
  * 
  * The center of the circle at which the rotation has to be carried out - A 2D location. 
+ * 
+ * The state is kept as a phase: the angle theta0 reached at time t0 on the circle 
+ * of the given radius around the center. The angle at any later time is 
+ * theta0 + omega*(t - t0), so positions are exact functions of the elapsed time 
+ * and do not drift however often the helper is updated. 
  * */
 #ifndef CONSTANT_ANGULAR_VELOCITY_HELPER_H
 #define CONSTANT_ANGULAR_VELOCITY_HELPER_H
 
+#include <vector>
 #include "ns3/nstime.h"
 #include "ns3/vector.h"
 #include "ns3/box.h"
+#include "trajectory-segment.h"
 
 namespace ns3{
     class ConstantAngularVelocityHelper
@@ -48,6 +55,29 @@ namespace ns3{
         double GetRadius(void) const;
 
         Vector GetCurrentPosition(void) const;
+        /**
+         * Evaluate the orbit in closed form from the last update,
+         * without changing the state of the helper.
+         * \param t a time not earlier than the last update
+         * \return the position on the orbit at time t
+         * */
+        Vector GetPositionAt(const Time &t) const;
+        /**
+         * \param t a time not earlier than the last update
+         * \return the angle around the center at time t, in [0, 2*PI)
+         * */
+        double GetThetaAt(const Time &t) const;
+        /**
+         * \return the signed angular rate in rad/s, zero while paused
+         * */
+        double GetAngularRate(void) const;
+        /**
+         * Describe the motion from the phase anchor on, without changing 
+         * the state of the helper.
+         * \param end the time until which the orbit is known not to change
+         * \return a circular arc, or a constant position segment while paused
+         * */
+        TrajectorySegment GetSegment(const Time &end) const;
         
         /**
          * State related function changes
@@ -61,11 +91,32 @@ namespace ns3{
 
         void Update(void) const;
 
+        /**
+         * Advance n helpers to the current time at once. 
+         * 
+         * The angles of all the helpers are gathered and their sines and
+         * cosines computed by the vectorized BatchSinCos kernel, so a swarm
+         * refresh is not dominated by transcendental math.  The caller keeps
+         * the scratch buffer across calls so that it is not reallocated on
+         * every refresh.
+         * */
+        static void UpdateBatch(ConstantAngularVelocityHelper *const *helpers, size_t n,
+                                std::vector<double> &scratch);
+
     private:
         Vector2D center;
         Vector2D m_omega;
         mutable Time m_lastUpdate; //!< time of last update
         mutable Vector m_position; //!< state variable for current position
+        /**
+         * Re-anchor the phase at the given time from the current angle.
+         * */
+        void Rebase(const Time &t) const;
+
+        mutable double m_theta; //!< angle of m_position around the center, kept instead of recovered with acos
+        mutable double m_theta0; //!< angle of the phase anchor
+        mutable Time m_t0; //!< time of the phase anchor
+        double m_radius; //!< distance of m_position from the center
         mutable bool m_paused;  //!< state variable for paused
     };
 }
@@ -18,6 +18,7 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "constant-position-mobility-model.h"
+#include "ns3/simulator.h"
 
 namespace ns3 {
 
@@ -36,6 +37,7 @@ ConstantPositionMobilityModel::GetTypeId (void)
 
 ConstantPositionMobilityModel::ConstantPositionMobilityModel ()
 {
+  SetAnalyticSegment (TrajectorySegment::ConstantPosition (Simulator::Now (), Time::Max (), m_position));
 }
 ConstantPositionMobilityModel::~ConstantPositionMobilityModel ()
 {
@@ -50,6 +52,7 @@ void
 ConstantPositionMobilityModel::DoSetPosition (const Vector &position)
 {
   m_position = position;
+  SetAnalyticSegment (TrajectorySegment::ConstantPosition (Simulator::Now (), Time::Max (), m_position));
   NotifyCourseChange ();
 }
 Vector
@@ -57,5 +60,10 @@ ConstantPositionMobilityModel::DoGetVelocity (void) const
 {
   return Vector (0.0, 0.0, 0.0);
 }
+TrajectorySegment
+ConstantPositionMobilityModel::DoGetCurrentSegment (void) const
+{
+  return TrajectorySegment::ConstantPosition (Simulator::Now (), Time::Max (), m_position);
+}
 
 } // namespace ns3
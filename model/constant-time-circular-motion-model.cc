@@ -7,6 +7,8 @@
 #include "constant-time-circular-motion-model.h"
 #include "ns3/double.h"
 #include "ns3/vector.h"
+#include "mobility-stats.h"
+#include "orbit-shell.h"
 
 namespace ns3{
 
@@ -47,12 +49,14 @@ NS_OBJECT_ENSURE_REGISTERED (ConstantTimeCircularMotionModel);
             .AddAttribute("InterOrbitDistance",
                         "Distance between 2 successive orbits in the circle",
                         DoubleValue(75.0),
-                        MakeDoubleAccessor(&ConstantTimeCircularMotionModel::m_orbit_dist),
+                        MakeDoubleAccessor(&ConstantTimeCircularMotionModel::SetInterOrbitDistance,
+                                        &ConstantTimeCircularMotionModel::GetInterOrbitDistance),
                         MakeDoubleChecker<double> ())
             .AddAttribute("MaximumRadius",
                         "The maximum surveillance radius that the nodes should patrol",
                         DoubleValue(750.0),
-                        MakeDoubleAccessor(&ConstantTimeCircularMotionModel::m_max_orbit_rad),
+                        MakeDoubleAccessor(&ConstantTimeCircularMotionModel::SetMaximumRadius,
+                                        &ConstantTimeCircularMotionModel::GetMaximumRadius),
                         MakeDoubleChecker<double>())
             .AddAttribute("TimeToFlyInOrbit",
                         "The time to fly in the orbit before switching carrying out orbit switching",
@@ -77,13 +81,35 @@ NS_OBJECT_ENSURE_REGISTERED (ConstantTimeCircularMotionModel);
                         MakePointerChecker<RandomVariableStream>())
             .AddAttribute("FlightChoice",
                         "A random variable which decides which orbit to move to next",
-                        StringValue("ns3::UniformRandomVariable[Min[0.0|Max=2.0]]"),
+                        StringValue("ns3::UniformRandomVariable[Min=0.0|Max=2.0]"),
                         MakePointerAccessor(&ConstantTimeCircularMotionModel::m_rf_choice),
-                        MakePointerChecker<RandomVariableStream>());
+                        MakePointerChecker<RandomVariableStream>())
+            .AddAttribute("AltitudeStep",
+                        "Altitude difference between two successive orbits, which then form stacked "
+                        "(radius, altitude) shells. Radial legs climb or descend to the altitude of the "
+                        "next shell. 0 keeps every drone at its initial altitude. The altitude given "
+                        "to SetPosition is not snapped to a shell, the first radial leg levels the drone off",
+                        DoubleValue(0.0),
+                        MakeDoubleAccessor(&ConstantTimeCircularMotionModel::m_altitude_step),
+                        MakeDoubleChecker<double>())
+            .AddAttribute("BaseAltitude",
+                        "Altitude of the shell of orbit 0 when AltitudeStep is not 0",
+                        DoubleValue(0.0),
+                        MakeDoubleAccessor(&ConstantTimeCircularMotionModel::m_base_altitude),
+                        MakeDoubleChecker<double>())
+            .AddAttribute("UpdateMode",
+                        "Polling mode steps the drone every 0.1 s, "
+                        "Analytic mode evaluates the current orbit arc or radial leg in closed form "
+                        "and schedules one event per phase transition",
+                        EnumValue(ConstantTimeCircularMotionModel::POLLING_MODE),
+                        MakeEnumAccessor(&ConstantTimeCircularMotionModel::m_update_mode),
+                        MakeEnumChecker(ConstantTimeCircularMotionModel::POLLING_MODE,"Polling",
+                        ConstantTimeCircularMotionModel::ANALYTIC_MODE,"Analytic"));
         return tid;
     }
     ConstantTimeCircularMotionModel::ConstantTimeCircularMotionModel()
     {
+        m_transitions.Configure(m_orbit_dist,m_max_orbit_rad);
         m_helper.SetCenter(center);
         DoInitialize();
     }
@@ -92,6 +118,97 @@ NS_OBJECT_ENSURE_REGISTERED (ConstantTimeCircularMotionModel);
         //DoSetPosition(m_initial_position);
         number_of_orbits = m_max_orbit_rad/m_orbit_dist;
     }
+    void ConstantTimeCircularMotionModel::SetInterOrbitDistance(double distance)
+    {
+        m_orbit_dist = distance;
+        m_transitions.Configure(m_orbit_dist,m_max_orbit_rad);
+    }
+    double ConstantTimeCircularMotionModel::GetInterOrbitDistance() const
+    {
+        return m_orbit_dist;
+    }
+    void ConstantTimeCircularMotionModel::SetMaximumRadius(double radius)
+    {
+        m_max_orbit_rad = radius;
+        m_transitions.Configure(m_orbit_dist,m_max_orbit_rad);
+    }
+    double ConstantTimeCircularMotionModel::GetMaximumRadius() const
+    {
+        return m_max_orbit_rad;
+    }
+    bool ConstantTimeCircularMotionModel::GetOrbitPhase(ConstantAngularVelocityHelper &phase) const
+    {
+        if(!under_surveillance)
+        {
+            return false;
+        }
+        phase = m_helper;
+        return true;
+    }
+    void ConstantTimeCircularMotionModel::TransitToZone(const Vector2D &zone_center, double orbit_distance, double max_radius)
+    {
+        MOBILITY_STATS_SCOPE(this, UPDATE);
+        Vector cur_pos = DoGetPosition();
+        m_event.Cancel();
+        m_helper.Pause();
+        m_vel_helper.Pause();
+        center = zone_center;
+        m_orbit_dist = orbit_distance;
+        m_max_orbit_rad = max_radius;
+        m_transitions.Configure(m_orbit_dist,m_max_orbit_rad);
+        number_of_orbits = m_transitions.GetNOrbits();
+        // aim for the nearest point of the outermost orbit of the new zone
+        double outer_radius = number_of_orbits*m_orbit_dist;
+        double dx = cur_pos.x-center.x;
+        double dy = cur_pos.y-center.y;
+        double distance = std::sqrt(dx*dx + dy*dy);
+        if(distance == 0.0)
+        {
+            dx = 1.0;
+            distance = 1.0;
+        }
+        Vector travel_vec = Vector(center.x + outer_radius*dx/distance - cur_pos.x,
+                                center.y + outer_radius*dy/distance - cur_pos.y, 0.0);
+        double length = std::sqrt(travel_vec.x*travel_vec.x + travel_vec.y*travel_vec.y);
+        NS_LOG_INFO("Transit to zone centered at "<< center << ", " << length << " m away");
+        under_surveillance = false;
+        m_rotating_time = 0.0;
+        m_radial_time = 0.0;
+        m_vel_helper.SetPosition(cur_pos);
+        if(length == 0.0)
+        {
+            m_radial_total_time = 0.0;
+            SetHoldPhase(cur_pos);
+            MOBILITY_STATS_COUNT(this, SCHEDULE);
+            m_event = Simulator::ScheduleNow(&ConstantTimeCircularMotionModel::DoSurveil,this);
+            return;
+        }
+        double travel_time = length/m_radial_vel;
+        m_radial_total_time = travel_time;
+        Vector velocity = Vector(m_radial_vel*travel_vec.x/length,m_radial_vel*travel_vec.y/length,
+                            GetClimbRate(cur_pos.z,number_of_orbits,travel_time));
+        m_vel_helper.SetVelocity(velocity);
+        SetRadialPhase(cur_pos,velocity,travel_time);
+        if(m_update_mode == ConstantTimeCircularMotionModel::ANALYTIC_MODE)
+        {
+            MOBILITY_STATS_COUNT(this, SCHEDULE);
+            m_event = Simulator::Schedule(m_phase_end - Simulator::Now(),
+                                &ConstantTimeCircularMotionModel::EndAnalyticRadial,this);
+        }
+        else
+        {
+            m_vel_helper.Update();
+            m_vel_helper.Unpause();
+            MOBILITY_STATS_COUNT(this, SCHEDULE);
+            m_event = Simulator::Schedule(Seconds(0.1),
+                                &ConstantTimeCircularMotionModel::UpdatePosition,this);
+        }
+        NotifyCourseChange();
+    }
+    const OrbitTransitionTable &ConstantTimeCircularMotionModel::GetTransitionTable() const
+    {
+        return m_transitions;
+    }
     void ConstantTimeCircularMotionModel::DoConfigureAngVelHelper(const Vector &position)
     {
         // set angular velocity in the circular mobility model
@@ -115,12 +232,14 @@ NS_OBJECT_ENSURE_REGISTERED (ConstantTimeCircularMotionModel);
 
     void ConstantTimeCircularMotionModel::UpdatePosition()
     {
+        MOBILITY_STATS_SCOPE(this, UPDATE);
         if(under_surveillance)
         {
             if(m_rotating_time >= m_time_rotate.GetSeconds())
             {
                 m_rotating_time = 0.0;
                 m_helper.Pause();
+                MOBILITY_STATS_COUNT(this, SCHEDULE);
                 Simulator::ScheduleNow(&ConstantTimeCircularMotionModel::DoOrbitSwitch,this);
                 return;
             }
@@ -134,15 +253,145 @@ NS_OBJECT_ENSURE_REGISTERED (ConstantTimeCircularMotionModel);
                 m_radial_total_time = 0.0;
                 m_radial_time = 0.0;
                 m_vel_helper.Pause();
+                MOBILITY_STATS_COUNT(this, SCHEDULE);
                 Simulator::ScheduleNow(&ConstantTimeCircularMotionModel::DoSurveil,this);
                 return;
             }
             m_vel_helper.Update();
             m_radial_time += 0.1;
         }
+        MOBILITY_STATS_COUNT(this, SCHEDULE);
         m_event = Simulator::Schedule(Seconds(0.1),&ConstantTimeCircularMotionModel::UpdatePosition,this);
     }
 
+    uint32_t ConstantTimeCircularMotionModel::GetPollingSteps(double duration)
+    {
+        // replay the accumulation done by UpdatePosition so that the phase ends 
+        // on exactly the same tick as it would in polling mode
+        uint32_t steps = 0;
+        double elapsed = 0.0;
+        while(elapsed < duration)
+        {
+            elapsed += 0.1;
+            steps++;
+        }
+        return steps;
+    }
+
+    double ConstantTimeCircularMotionModel::GetClimbRate(double z, int orbit, double travel_time) const
+    {
+        // spread the climb over the ticks the leg actually moves for, so that 
+        // the drone levels off on the shell in both update modes
+        uint32_t steps = GetPollingSteps(travel_time);
+        return GetOrbitShellClimbRate(z,m_base_altitude,m_altitude_step,orbit,0.1*steps);
+    }
+
+    void ConstantTimeCircularMotionModel::SetOrbitPhase()
+    {
+        Vector position = m_helper.GetCurrentPosition();
+        Vector2D omega = m_helper.GetOmega();
+        m_phase_on_orbit = true;
+        m_phase_start = Simulator::Now();
+        m_phase_origin = position;
+        m_phase_radius = m_helper.GetRadius();
+        m_phase_theta0 = m_helper.GetTheta(position);
+        m_phase_rate = omega.x*omega.y;
+        // the polling mode moves for steps ticks and notices the end of the phase one tick later
+        uint32_t steps = GetPollingSteps(m_time_rotate.GetSeconds());
+        m_phase_active = MilliSeconds(100*static_cast<uint64_t>(steps));
+        m_phase_end = m_phase_start + MilliSeconds(100*static_cast<uint64_t>(steps+1));
+    }
+
+    void ConstantTimeCircularMotionModel::SetRadialPhase(const Vector &position, const Vector &velocity, double travel_time)
+    {
+        m_phase_on_orbit = false;
+        m_phase_start = Simulator::Now();
+        m_phase_origin = position;
+        m_phase_velocity = velocity;
+        uint32_t steps = GetPollingSteps(travel_time);
+        m_phase_active = MilliSeconds(100*static_cast<uint64_t>(steps));
+        m_phase_end = m_phase_start + MilliSeconds(100*static_cast<uint64_t>(steps+1));
+    }
+
+    void ConstantTimeCircularMotionModel::SetHoldPhase(const Vector &position)
+    {
+        // the drone waits at position for a DoSurveil scheduled at the current time
+        m_phase_on_orbit = false;
+        m_phase_start = Simulator::Now();
+        m_phase_origin = position;
+        m_phase_velocity = Vector(0.0,0.0,0.0);
+        m_phase_active = Seconds(0.0);
+        m_phase_end = m_phase_start;
+    }
+
+    void ConstantTimeCircularMotionModel::EndAnalyticOrbit()
+    {
+        MOBILITY_STATS_SCOPE(this, UPDATE);
+        // hand the frozen end of the arc back to the helper, the orbit switch works from there
+        m_helper.SetPosition(GetPhasePosition(Simulator::Now()));
+        m_helper.Pause();
+        m_rotating_time = 0.0;
+        DoOrbitSwitch();
+    }
+
+    void ConstantTimeCircularMotionModel::EndAnalyticRadial()
+    {
+        MOBILITY_STATS_SCOPE(this, UPDATE);
+        m_vel_helper.SetPosition(GetPhasePosition(Simulator::Now()));
+        m_vel_helper.Pause();
+        m_radial_total_time = 0.0;
+        m_radial_time = 0.0;
+        DoSurveil();
+    }
+
+    Vector ConstantTimeCircularMotionModel::GetPhasePosition(const Time &at) const
+    {
+        Time elapsed = at - m_phase_start;
+        if(elapsed > m_phase_active)
+        {
+            elapsed = m_phase_active;
+        }
+        double t = elapsed.GetSeconds();
+        if(m_phase_on_orbit)
+        {
+            double theta = m_phase_theta0 + m_phase_rate*t;
+            return Vector(center.x + m_phase_radius*std::cos(theta),
+                        center.y + m_phase_radius*std::sin(theta),
+                        m_phase_origin.z);
+        }
+        return Vector(m_phase_origin.x + m_phase_velocity.x*t,
+                    m_phase_origin.y + m_phase_velocity.y*t,
+                    m_phase_origin.z + m_phase_velocity.z*t);
+    }
+
+    Vector ConstantTimeCircularMotionModel::GetPhaseVelocity(const Time &at) const
+    {
+        if(at - m_phase_start >= m_phase_active)
+        {
+            // the drone stands still for the rest of the phase, see GetPhasePosition
+            return Vector(0.0,0.0,0.0);
+        }
+        if(m_phase_on_orbit)
+        {
+            double theta = m_phase_theta0 + m_phase_rate*(at - m_phase_start).GetSeconds();
+            double speed = m_phase_radius*m_phase_rate;
+            return Vector(-1*speed*std::sin(theta),speed*std::cos(theta),0.0);
+        }
+        return m_phase_velocity;
+    }
+
+    Vector ConstantTimeCircularMotionModel::GetPositionAt(const Time &t) const
+    {
+        NS_ASSERT_MSG(t >= m_phase_start, "GetPositionAt can not look before the start of the current phase");
+        NS_ASSERT_MSG(t <= m_phase_end, "GetPositionAt can not look past the next orbit decision at " << m_phase_end);
+        return GetPhasePosition(t);
+    }
+
+    Time ConstantTimeCircularMotionModel::GetNextDecisionTime() const
+    {
+        return m_phase_end;
+    }
+
     ConstantTimeCircularMotionModel::~ConstantTimeCircularMotionModel()
     {
     }
@@ -157,12 +406,15 @@ NS_OBJECT_ENSURE_REGISTERED (ConstantTimeCircularMotionModel);
         DoConfigureAngVelHelper(position);
         // change position here
         current_position = position;
+        SetHoldPhase(position);
+        MOBILITY_STATS_COUNT(this, SCHEDULE);
         m_event = Simulator::ScheduleNow(&ConstantTimeCircularMotionModel::DoSurveil,this);
         under_surveillance = true;
         //time_travelled += time_step;
     }
     void ConstantTimeCircularMotionModel::DoSurveil()
     {
+        MOBILITY_STATS_SCOPE(this, UPDATE);
         m_vel_helper.Update();
         m_vel_helper.Pause();
         m_helper.Update();
@@ -182,11 +434,23 @@ NS_OBJECT_ENSURE_REGISTERED (ConstantTimeCircularMotionModel);
         DoConfigureAngVelHelper(m_vel_helper.GetCurrentPosition());
         m_helper.Unpause();
         under_surveillance = true;
+        SetOrbitPhase();
+        // a new orbit phase starts, listeners predicting the trajectory have to know
+        NotifyCourseChange();
+        if(m_update_mode == ConstantTimeCircularMotionModel::ANALYTIC_MODE)
+        {
+            MOBILITY_STATS_COUNT(this, SCHEDULE);
+            m_event = Simulator::Schedule(m_phase_end - Simulator::Now(),
+                                &ConstantTimeCircularMotionModel::EndAnalyticOrbit,this);
+            return;
+        }
+        MOBILITY_STATS_COUNT(this, SCHEDULE);
         m_event = Simulator::Schedule(Seconds(0.1),&ConstantTimeCircularMotionModel::UpdatePosition,this);
         //m_helper.SetPosition(m_position);
     }
     void ConstantTimeCircularMotionModel::DoOrbitSwitch()
     {
+        MOBILITY_STATS_SCOPE(this, UPDATE);
         // whether the node is currently conducting surveillance or orbit switching
         under_surveillance = false;
         m_helper.Update();
@@ -198,156 +462,77 @@ NS_OBJECT_ENSURE_REGISTERED (ConstantTimeCircularMotionModel);
         // generate random number based on random walk or random flight mode
         double coin_flip = m_rw_rf_choice->GetValue();
         double travel_time = 0.0;
-        double radial_component_vel = m_radial_vel;
         int orbit_number = std::round(m_helper.GetRadius()/m_orbit_dist);
         double radius = m_helper.GetRadius();
         // variable for staying in the same orbit without any switching
         bool no_orbit_switch = false;
         NS_LOG_INFO("Starting orbit switch");
+        double rand = m_rw_choice->GetValue();
+        double speed_factor = 1.0;
+        int fin_orbit_num;
         if(coin_flip >= m_epsilon)
         {
             NS_LOG_INFO("Random flight mode with epsilon: "<<coin_flip);
-            double total_orbits = (m_max_orbit_rad)/(m_orbit_dist);
-            double probability_step = 1.0/(total_orbits);
-            double rand = m_rw_choice->GetValue();
-            int fin_orbit_num = std::floor(rand/probability_step) +1;
-            if(fin_orbit_num > total_orbits)
-                fin_orbit_num-=1;
-            if(fin_orbit_num < orbit_number)
-            {
-                // if the drone is in the last orbit, only move downwards, not upwards
-                travel_vec = Vector(center.x - cur_pos.x, center.y - cur_pos.y,cur_pos.z);
-                travel_time = ((radius)- (fin_orbit_num)*(m_orbit_dist))/(m_radial_vel);
-                NS_LOG_INFO("Moving to orbit "<< fin_orbit_num << " from orbit "<< orbit_number);
-                NS_LOG_INFO("Travelling from radius: "<<radius <<" to radius: "<< (fin_orbit_num)*(m_orbit_dist));
-            }
-            else if(fin_orbit_num > orbit_number)
-            {
-                // same with when the orbit is the first orbit, only move upwards not downwards
-                travel_vec = Vector(cur_pos.x-center.x, cur_pos.y-center.y ,cur_pos.z);
-                //travel_time = (fin_orbit_num-orbit_number)*(m_orbit_dist)/(m_radial_vel);
-                travel_time = ((fin_orbit_num)*(m_orbit_dist)-(radius))/(m_radial_vel);
-                NS_LOG_INFO("Moving to orbit "<< fin_orbit_num << " from orbit "<< orbit_number);
-                NS_LOG_INFO("Travelling from radius: "<<radius <<" to radius: "<< (fin_orbit_num)*(m_orbit_dist));
-            }
-            else
-            {
-                //double step = 2.0/number_of_orbits;
-                //int orbit_number = std::floor(rand/step);
-                //travel_vec = Vector(cur_pos.x-center.x, cur_pos.y-center.y ,cur_pos.z);
-                travel_time = m_orbit_dist/m_radial_vel;
-                no_orbit_switch = true;
-                NS_LOG_INFO("Staying in the same orbit");
-            }
+            fin_orbit_num = m_transitions.SampleFlight(rand);
         }
         else
         {
-            // probabilities of moving to upper orbit, lower orbit or stay in same orbit
-            // undergoing random walk
-            NS_LOG_INFO("Random walk mode with epsilon "<< coin_flip);
-            double rand = m_rw_choice->GetValue();
-            NS_LOG_INFO("Random walk mode with rand: "<< rand);
-            if(m_helper.GetRadius() >= m_max_orbit_rad - m_orbit_dist)
-            {
-                // if the drone is in the last orbit, only move downwards, not upwards
-                // transition to (n-2)th orbit with probability (n-2)/2n
-                // transition to (n-1)th orbit with probability (n-1)/2n
-                // stay in same orbit with probability 3/2n
-                if(rand<= (0.5-(1.0)/number_of_orbits))
-                {
-                    travel_vec = Vector(center.x-cur_pos.x,center.y-cur_pos.y,cur_pos.z);
-                    //travel_time = (m_orbit_dist)/(m_radial_vel);
-                    radial_component_vel = 2*m_radial_vel;
-                    travel_time = ((radius)-(orbit_number-2)*(m_orbit_dist))/(radial_component_vel);
-                    NS_LOG_INFO("Moving to orbit "<< number_of_orbits -2 << " from orbit "<< orbit_number);
-                    NS_LOG_INFO("Travelling from radius: "<<radius <<" to radius: "<< (orbit_number-2)*(m_orbit_dist));
-                }
-                else if(rand <= (1-((1.5)/number_of_orbits)) && rand >= (0.5-(1.0)/number_of_orbits))
-                {
-                    travel_vec = Vector(center.x-cur_pos.x,center.y-cur_pos.y,cur_pos.z);
-                    travel_time = ((radius) - (orbit_number-1)*(m_orbit_dist))/(m_radial_vel);
-                    //travel_time = (m_orbit_dist)/(m_radial_vel);
-                    //radial_component_vel = 2*m_radial_vel;
-                    NS_LOG_INFO("Moving to orbit "<< number_of_orbits -1 << " from orbit "<< orbit_number);
-                    NS_LOG_INFO("Travelling from radius: "<<radius <<" to radius: "<< (orbit_number-1)*(m_orbit_dist));
-                }
-                else 
-                {
-                    // just stay in the orbit
-                    travel_time = m_orbit_dist/m_radial_vel;
-                    no_orbit_switch = true;
-                    NS_LOG_INFO("Staying in the same orbit");
-                }
-            }
-            else if(m_helper.GetRadius() < 1.5*m_orbit_dist)
-            {
-                // same with when the orbit is the first orbit, only move upwards not downwards
-                travel_vec = Vector(cur_pos.x-center.x,cur_pos.y-center.y,cur_pos.z);
-                // move to orbit 2 with probability 1/2 and stay in orbit with probability 1/2 
-                if(rand<= (0.5))
-                {
-                    travel_vec = Vector(cur_pos.x-center.x,cur_pos.y-center.y,0);
-                    travel_time = ((orbit_number+1)*(m_orbit_dist)-radius)/(m_radial_vel);
-                    //travel_time = (m_orbit_dist)/(m_radial_vel);
-                    radial_component_vel = m_radial_vel;
-                    NS_LOG_INFO("Moving to orbit "<< 2 << " from orbit "<< orbit_number);
-                    NS_LOG_INFO("Travelling from radius: "<<radius <<" to radius: "<< (2)*(m_orbit_dist));
-                }
-                else 
-                {
-                    //travel_vec = Vector(center.x-cur_pos.x,center.y-cur_pos.y,cur_pos.z);
-                    travel_time = (m_orbit_dist)/(m_radial_vel);
-                    no_orbit_switch = true;
-                    NS_LOG_INFO("Staying in orbit 1");
-                }
-            }
-            else
-            {
-                //double rand = m_rw_choice->GetValue();
-                // distribution of the orbit
-                // move to the upward orbit with probability 1/2
-                // move to the lower orbit with probability (i-1)/(2i)
-                // stay in the orbit with probability 1/(2i)
-                if(rand <= 0.5)
-                {
-                    // travel outwards with probability 0.5
-                    travel_vec = Vector(cur_pos.x-center.x,cur_pos.y-center.y,cur_pos.z);
-                    travel_time = ((orbit_number+1)*(m_orbit_dist)-radius)/(m_radial_vel);
-                    radial_component_vel = m_radial_vel;
-                    NS_LOG_INFO("Moving to orbit "<< orbit_number+1 << " from orbit "<< orbit_number);
-                    NS_LOG_INFO("Travelling from radius: "<<radius <<" to radius: "<< (orbit_number+1)*(m_orbit_dist));
-                }
-                else if(rand > 0.5 && rand <= 1-(0.5/orbit_number))
-                {
-                    // travel inwards with probability 0.5 - 0.5/i
-                    travel_vec = Vector(center.x-cur_pos.x,center.y-cur_pos.y,cur_pos.z);
-                    travel_time = (radius - (orbit_number-1)*(m_orbit_dist))/(m_radial_vel);
-                    radial_component_vel = m_radial_vel;
-                    NS_LOG_INFO("Moving to orbit "<< orbit_number -1 << " from orbit "<< orbit_number);
-                    NS_LOG_INFO("Travelling from radius: "<<radius <<" to radius: "<< (orbit_number-1)*(m_orbit_dist));
-                }
-                else
-                {
-                    // stay in the orbit with the remaining probability
-                    travel_time = (m_orbit_dist)/(m_radial_vel);
-                    no_orbit_switch = true;
-                    NS_LOG_INFO("Staying in the same orbit");
-                }
-            }
+            NS_LOG_INFO("Random walk mode with epsilon "<< coin_flip << " and rand: " << rand);
+            fin_orbit_num = m_transitions.SampleWalk(orbit_number,rand,speed_factor);
+        }
+        double radial_component_vel = speed_factor*m_radial_vel;
+        if(fin_orbit_num < orbit_number)
+        {
+            travel_vec = Vector(center.x - cur_pos.x, center.y - cur_pos.y,cur_pos.z);
+            travel_time = ((radius)- (fin_orbit_num)*(m_orbit_dist))/(radial_component_vel);
+        }
+        else if(fin_orbit_num > orbit_number)
+        {
+            travel_vec = Vector(cur_pos.x-center.x, cur_pos.y-center.y ,cur_pos.z);
+            travel_time = ((fin_orbit_num)*(m_orbit_dist)-(radius))/(radial_component_vel);
+        }
+        else
+        {
+            travel_time = m_orbit_dist/m_radial_vel;
+            no_orbit_switch = true;
         }
         if(no_orbit_switch)
         {
+            NS_LOG_INFO("Staying in orbit "<< orbit_number);
+        }
+        else
+        {
+            NS_LOG_INFO("Moving to orbit "<< fin_orbit_num << " from orbit "<< orbit_number);
+            NS_LOG_INFO("Travelling from radius: "<<radius <<" to radius: "<< (fin_orbit_num)*(m_orbit_dist));
+        }
+        if(no_orbit_switch)
+        {
+            SetHoldPhase(cur_pos);
+            MOBILITY_STATS_COUNT(this, SCHEDULE);
             m_event = Simulator::ScheduleNow(&ConstantTimeCircularMotionModel::DoSurveil,this);
         }
         else
         {
             m_radial_total_time = travel_time;
             double theta = m_helper.GetTheta(travel_vec);
-            m_vel_helper.SetVelocity(Vector(radial_component_vel*std::cos(theta),radial_component_vel*std::sin(theta),0));
-            m_vel_helper.Update();
-            m_vel_helper.Unpause();
-            m_event = Simulator::Schedule(Seconds(0.1),
-                                &ConstantTimeCircularMotionModel::UpdatePosition,this);
+            Vector velocity = Vector(radial_component_vel*std::cos(theta),radial_component_vel*std::sin(theta),
+                                GetClimbRate(cur_pos.z,fin_orbit_num,travel_time));
+            m_vel_helper.SetVelocity(velocity);
+            SetRadialPhase(cur_pos,velocity,travel_time);
+            if(m_update_mode == ConstantTimeCircularMotionModel::ANALYTIC_MODE)
+            {
+                MOBILITY_STATS_COUNT(this, SCHEDULE);
+                m_event = Simulator::Schedule(m_phase_end - Simulator::Now(),
+                                    &ConstantTimeCircularMotionModel::EndAnalyticRadial,this);
+            }
+            else
+            {
+                m_vel_helper.Update();
+                m_vel_helper.Unpause();
+                MOBILITY_STATS_COUNT(this, SCHEDULE);
+                m_event = Simulator::Schedule(Seconds(0.1),
+                                    &ConstantTimeCircularMotionModel::UpdatePosition,this);
+            }
             NotifyCourseChange();
         }
     }
@@ -355,6 +540,10 @@ NS_OBJECT_ENSURE_REGISTERED (ConstantTimeCircularMotionModel);
     Vector
     ConstantTimeCircularMotionModel::DoGetVelocity (void) const
     {
+        if(m_update_mode == ConstantTimeCircularMotionModel::ANALYTIC_MODE)
+        {
+            return GetPhaseVelocity(Simulator::Now());
+        }
         if(under_surveillance)
         {
             double theta = m_helper.GetTheta(m_helper.GetCurrentPosition());
@@ -365,9 +554,34 @@ NS_OBJECT_ENSURE_REGISTERED (ConstantTimeCircularMotionModel);
             return m_vel_helper.GetVelocity();
         }
     }
+    TrajectorySegment ConstantTimeCircularMotionModel::DoGetCurrentSegment(void) const
+    {
+        Time moving_end = m_phase_start + m_phase_active;
+        if(Simulator::Now() >= moving_end)
+        {
+            // frozen at the end of the phase until the next decision
+            return TrajectorySegment::ConstantPosition(moving_end, Max(m_phase_end, Simulator::Now()),
+                                                    GetPhasePosition(moving_end));
+        }
+        if(m_phase_on_orbit)
+        {
+            return TrajectorySegment::CircularArc(m_phase_start, moving_end, center, m_phase_radius,
+                                                m_phase_theta0, m_phase_rate, m_phase_origin.z);
+        }
+        return TrajectorySegment::ConstantVelocity(m_phase_start, moving_end, m_phase_origin, m_phase_velocity);
+    }
     Vector ConstantTimeCircularMotionModel::DoGetPosition(void) const
     {
-        return m_helper.GetCurrentPosition();
+        if(m_update_mode == ConstantTimeCircularMotionModel::ANALYTIC_MODE)
+        {
+            return GetPhasePosition(Simulator::Now());
+        }
+        // on a radial leg the orbit helper is paused, the leg is tracked by m_vel_helper
+        if(under_surveillance)
+        {
+            return m_helper.GetCurrentPosition();
+        }
+        return m_vel_helper.GetCurrentPosition();
     }
     double ConstantTimeCircularMotionModel::DoGetRadius()
     {
@@ -1,8 +1,9 @@
-#ifndef SEMI_RANDOM_CIRCULAR_MOBILITY_MODEL_H
-#define SEMI_RANDOM_CIRCULAR_MOBILITY_MODEL_H
+#ifndef CONSTANT_TIME_CIRCULAR_MOTION_MODEL_H
+#define CONSTANT_TIME_CIRCULAR_MOTION_MODEL_H
 
 #include "constant-angular-velocity-helper.h"
 #include "constant-velocity-helper.h"
+#include "orbit-transition-table.h"
 #include "mobility-model.h"
 #include "position-allocator.h"
 #include "ns3/ptr.h"
@@ -20,6 +21,59 @@ namespace ns3{
         static TypeId GetTypeId (void);
         ConstantTimeCircularMotionModel ();
         virtual ~ConstantTimeCircularMotionModel();
+        /**
+         * How the model advances a drone along its current phase.
+         * 
+         * POLLING_MODE wakes up every 0.1 s and steps the helpers forward.
+         * ANALYTIC_MODE evaluates the current orbit arc or radial leg in closed 
+         * form and only schedules an event when the phase ends. Phase durations
+         * are quantized to the same 0.1 s ticks as the polling mode so both modes
+         * follow the same trajectory and consume the same random draws.
+         * */
+        enum UpdateMode {
+            POLLING_MODE,
+            ANALYTIC_MODE
+        };
+        /**
+         * Look ahead on the current orbit arc or radial leg without 
+         * simulating or scheduling anything.
+         * 
+         * The position is evaluated in closed form, so it is cheap enough to be
+         * called by predictive routing for every candidate next hop. In polling 
+         * mode GetPosition only moves on 0.1 s ticks while this returns the
+         * continuous trajectory between them.
+         * 
+         * \param t a time between now and GetNextDecisionTime ()
+         * \return the position of the drone at time t
+         * */
+        Vector GetPositionAt(const Time &t) const;
+        /**
+         * \return the time at which the current phase ends and the drone 
+         * takes its next random orbit decision.
+         * */
+        Time GetNextDecisionTime(void) const;
+        /**
+         * \return the orbit transition law compiled from the InterOrbitDistance
+         * and MaximumRadius attributes, e.g. to compute the stationary orbit 
+         * distribution of the drones.
+         * */
+        const OrbitTransitionTable &GetTransitionTable(void) const;
+        /**
+         * Describe the orbit the drone is flying, e.g. to predict when it 
+         * comes within range of another drone. 
+         * \param phase set to a copy of the orbit helper
+         * \return false while the drone is not on an orbit
+         * */
+        bool GetOrbitPhase(ConstantAngularVelocityHelper &phase) const;
+        /**
+         * Leave the current patrol zone for another one. 
+         * 
+         * The drone flies in a straight line at RadialVelocity to the nearest
+         * point of the outermost orbit of the new zone and resumes surveillance
+         * there, with the Center, InterOrbitDistance and MaximumRadius of the 
+         * new zone. 
+         * */
+        void TransitToZone(const Vector2D &zone_center, double orbit_distance, double max_radius);
         /**
          * This mobility model is a newer model that focuses on 
          * continuous time oriented surveillance where all the mobile nodes
@@ -33,6 +87,11 @@ namespace ns3{
          * 
          * This model is free of the exchange point orbit switching, drones switch orbits whenever they 
          * complete x amount of time in the orbit 
+         * 
+         * With a non zero AltitudeStep orbit i is flown at altitude BaseAltitude + i*AltitudeStep,
+         * and the radial legs between orbits climb or descend in a straight line. SetPosition 
+         * keeps the altitude it is given: place the drone on the shell of its orbit, otherwise 
+         * it flies its first orbit off the shell and only levels off at the end of its first leg. 
          * */
 
         private:
@@ -41,10 +100,48 @@ namespace ns3{
             void DoConfigureAngVelHelper(const Vector &position);
             void DoInitializePrivate(void);
             void UpdatePosition(void);
+            /**
+             * Attribute setters, the transition table is recompiled whenever
+             * the geometry of the orbits changes.
+             * */
+            void SetInterOrbitDistance(double distance);
+            double GetInterOrbitDistance(void) const;
+            void SetMaximumRadius(double radius);
+            double GetMaximumRadius(void) const;
+            /**
+             * Number of 0.1 s polling ticks during which the drone actually moves
+             * in a phase lasting at least duration seconds.
+             * */
+            static uint32_t GetPollingSteps(double duration);
+            /**
+             * Vertical speed of a leg of travel_time seconds starting at altitude z 
+             * and ending on the shell of the given orbit.
+             * */
+            double GetClimbRate(double z, int orbit, double travel_time) const;
+            /**
+             * Record the closed form orbit phase starting from the current 
+             * state of m_helper.
+             * */
+            void SetOrbitPhase(void);
+            /**
+             * Record the closed form radial leg starting at position
+             * with the given velocity.
+             * */
+            void SetRadialPhase(const Vector &position, const Vector &velocity, double travel_time);
+            void SetHoldPhase(const Vector &position);
+            void EndAnalyticOrbit(void);
+            void EndAnalyticRadial(void);
+            Vector GetPhasePosition(const Time &at) const;
+            Vector GetPhaseVelocity(const Time &at) const;
             virtual void DoInitialize(void);
             virtual Vector DoGetPosition(void) const;
             virtual void DoSetPosition(const Vector &position);
             virtual Vector DoGetVelocity(void) const;
+            /**
+             * The segment follows the continuous trajectory of the current 
+             * phase like GetPositionAt, even in polling mode.
+             * */
+            virtual TrajectorySegment DoGetCurrentSegment(void) const;
             virtual double DoGetRadius();
             virtual int64_t DoAssignStreams(int64_t);
 
@@ -62,8 +159,11 @@ namespace ns3{
         double m_radial_time = 0.0;
         double m_radial_total_time = 0.0;
         double m_radial_vel;
-        double m_orbit_dist;
-        double m_max_orbit_rad;
+        double m_orbit_dist = 75.0;
+        double m_max_orbit_rad = 750.0;
+        double m_altitude_step; //!< altitude difference between successive orbit shells, 0 for flat orbits
+        double m_base_altitude; //!< altitude of the shell of orbit 0
+        OrbitTransitionTable m_transitions; //!< orbit decision law, compiled at attribute set time
         double time_step;
         EventId m_event; //!< stored event ID 
         double time_to_travel=0.0;
@@ -72,6 +172,17 @@ namespace ns3{
         Ptr<RandomVariableStream> m_rw_rf_choice;
         Ptr<RandomVariableStream> m_rw_choice;
         Ptr<RandomVariableStream> m_rf_choice;
+        enum UpdateMode m_update_mode;
+        // closed form state of the current phase, drives ANALYTIC_MODE and GetPositionAt
+        bool m_phase_on_orbit = false; //!< true on an orbit arc, false on a radial leg or hold
+        Time m_phase_start; //!< time at which the current phase started
+        Time m_phase_active; //!< time spent moving before the phase freezes
+        Time m_phase_end; //!< time of the next orbit decision
+        double m_phase_theta0 = 0.0; //!< angle at the start of the orbit arc
+        double m_phase_radius = 0.0; //!< radius of the orbit arc
+        double m_phase_rate = 0.0; //!< signed angular velocity of the orbit arc
+        Vector m_phase_origin; //!< start of the radial leg, or the orbit z coordinate
+        Vector m_phase_velocity; //!< velocity along the radial leg
     };
 }
 #endif
\ No newline at end of file
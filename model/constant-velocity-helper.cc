@@ -21,6 +21,7 @@
 #include "ns3/rectangle.h"
 #include "ns3/box.h"
 #include "ns3/log.h"
+#include "mobility-stats.h"
 #include "constant-velocity-helper.h"
 
 namespace ns3 {
@@ -62,12 +63,37 @@ ConstantVelocityHelper::GetCurrentPosition (void) const
   return m_position;
 }
 
+Vector
+ConstantVelocityHelper::GetPositionAt (const Time &t) const
+{
+  NS_LOG_FUNCTION (this << t);
+  NS_ASSERT (m_lastUpdate <= t);
+  if (m_paused)
+    {
+      return m_position;
+    }
+  double deltaS = (t - m_lastUpdate).GetSeconds ();
+  return Vector (m_position.x + m_velocity.x * deltaS,
+                 m_position.y + m_velocity.y * deltaS,
+                 m_position.z + m_velocity.z * deltaS);
+}
+
 Vector 
 ConstantVelocityHelper::GetVelocity (void) const
 {
   NS_LOG_FUNCTION (this);
   return m_paused ? Vector (0.0, 0.0, 0.0) : m_velocity;
 }
+TrajectorySegment
+ConstantVelocityHelper::GetSegment (const Time &end) const
+{
+  NS_LOG_FUNCTION (this << end);
+  if (m_paused)
+    {
+      return TrajectorySegment::ConstantPosition (m_lastUpdate, end, m_position);
+    }
+  return TrajectorySegment::ConstantVelocity (m_lastUpdate, end, m_position, m_velocity);
+}
 void 
 ConstantVelocityHelper::SetVelocity (const Vector &vel)
 {
@@ -80,6 +106,7 @@ void
 ConstantVelocityHelper::Update (void) const
 {
   NS_LOG_FUNCTION (this);
+  MOBILITY_STATS_HELPER_SCOPE (UPDATE);
   Time now = Simulator::Now ();
   NS_ASSERT (m_lastUpdate <= now);
   Time deltaTime = now - m_lastUpdate;
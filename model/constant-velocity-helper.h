@@ -23,6 +23,7 @@
 #include "ns3/nstime.h"
 #include "ns3/vector.h"
 #include "ns3/box.h"
+#include "trajectory-segment.h"
 
 namespace ns3 {
 
@@ -60,11 +61,26 @@ public:
    * \return Position vector
    */
   Vector GetCurrentPosition (void) const;
+  /**
+   * Get the position at a given time, extrapolated from the last update
+   * without changing the state of the helper
+   * \param t a time not earlier than the last update
+   * \return Position vector
+   */
+  Vector GetPositionAt (const Time &t) const;
   /**
    * Get velocity; if paused, will return a zero vector
    * \return Velocity vector
    */
   Vector GetVelocity (void) const;
+  /**
+   * Describe the motion from the last update on, without changing the
+   * state of the helper
+   * \param end the time until which the motion is known not to change
+   * \return a constant velocity segment, or a constant position one
+   * while paused
+   */
+  TrajectorySegment GetSegment (const Time &end) const;
   /**
    * Set new velocity vector
    * \param vel Velocity vector
@@ -19,6 +19,7 @@
  */
 #include "constant-velocity-mobility-model.h"
 #include "ns3/simulator.h"
+#include "mobility-stats.h"
 
 namespace ns3 {
 
@@ -35,6 +36,7 @@ TypeId ConstantVelocityMobilityModel::GetTypeId (void)
 
 ConstantVelocityMobilityModel::ConstantVelocityMobilityModel ()
 {
+  SetAnalyticSegment (m_helper.GetSegment (Time::Max ()));
 }
 
 ConstantVelocityMobilityModel::~ConstantVelocityMobilityModel ()
@@ -44,9 +46,11 @@ ConstantVelocityMobilityModel::~ConstantVelocityMobilityModel ()
 void
 ConstantVelocityMobilityModel::SetVelocity (const Vector &speed)
 {
+  MOBILITY_STATS_SCOPE (this, UPDATE);
   m_helper.Update ();
   m_helper.SetVelocity (speed);
   m_helper.Unpause ();
+  SetAnalyticSegment (m_helper.GetSegment (Time::Max ()));
   NotifyCourseChange ();
 }
 
@@ -61,6 +65,7 @@ void
 ConstantVelocityMobilityModel::DoSetPosition (const Vector &position)
 {
   m_helper.SetPosition (position);
+  SetAnalyticSegment (m_helper.GetSegment (Time::Max ()));
   NotifyCourseChange ();
 }
 Vector
@@ -68,5 +73,11 @@ ConstantVelocityMobilityModel::DoGetVelocity (void) const
 {
   return m_helper.GetVelocity ();
 }
+TrajectorySegment
+ConstantVelocityMobilityModel::DoGetCurrentSegment (void) const
+{
+  m_helper.Update ();
+  return m_helper.GetSegment (Time::Max ());
+}
 
 } // namespace ns3
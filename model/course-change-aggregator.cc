@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
+#include "course-change-aggregator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CourseChangeAggregator");
+
+NS_OBJECT_ENSURE_REGISTERED (CourseChangeAggregator);
+
+TypeId
+CourseChangeAggregator::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CourseChangeAggregator")
+    .SetParent<Object> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<CourseChangeAggregator> ()
+    .AddAttribute ("Window",
+                   "Delay between the first course change of a batch and its delivery",
+                   TimeValue (Seconds (0.0)),
+                   MakeTimeAccessor (&CourseChangeAggregator::m_window),
+                   MakeTimeChecker (Seconds (0.0)))
+    .AddTraceSource ("CourseChanges",
+                     "The nodes whose course changed since the last batch",
+                     MakeTraceSourceAccessor (&CourseChangeAggregator::m_courseChangesTrace),
+                     "ns3::CourseChangeAggregator::BatchTracedCallback")
+  ;
+  return tid;
+}
+
+CourseChangeAggregator::CourseChangeAggregator ()
+  : m_changes (0),
+    m_batches (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+CourseChangeAggregator::~CourseChangeAggregator ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+CourseChangeAggregator::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_flush.Cancel ();
+  for (std::vector<Ptr<MobilityModel> >::iterator i = m_models.begin (); i != m_models.end (); ++i)
+    {
+      (*i)->TraceDisconnectWithoutContext ("CourseChange",
+                                           MakeCallback (&CourseChangeAggregator::CourseChanged, this));
+    }
+  m_models.clear ();
+  m_indices.clear ();
+  m_pending.clear ();
+  m_batchModels.clear ();
+  Object::DoDispose ();
+}
+
+void
+CourseChangeAggregator::Add (Ptr<MobilityModel> model, uint32_t id)
+{
+  NS_LOG_FUNCTION (this << model << id);
+  NS_ASSERT_MSG (m_indices.find (PeekPointer (model)) == m_indices.end (), "Node added twice");
+  m_indices[PeekPointer (model)] = m_models.size ();
+  m_models.push_back (model);
+  m_ids.push_back (id);
+  m_isPending.push_back (false);
+  model->TraceConnectWithoutContext ("CourseChange",
+                                     MakeCallback (&CourseChangeAggregator::CourseChanged, this));
+}
+
+uint32_t
+CourseChangeAggregator::GetN (void) const
+{
+  return m_models.size ();
+}
+
+uint64_t
+CourseChangeAggregator::GetChangeCount (void) const
+{
+  return m_changes;
+}
+
+uint64_t
+CourseChangeAggregator::GetBatchCount (void) const
+{
+  return m_batches;
+}
+
+void
+CourseChangeAggregator::CourseChanged (Ptr<const MobilityModel> model)
+{
+  std::map<const MobilityModel *, uint32_t>::const_iterator it = m_indices.find (PeekPointer (model));
+  NS_ASSERT (it != m_indices.end ());
+  m_changes++;
+  if (!m_isPending[it->second])
+    {
+      m_isPending[it->second] = true;
+      m_pending.push_back (it->second);
+    }
+  if (!m_flush.IsRunning ())
+    {
+      m_flush = Simulator::Schedule (m_window, &CourseChangeAggregator::Flush, this);
+    }
+}
+
+void
+CourseChangeAggregator::Flush (void)
+{
+  NS_LOG_FUNCTION (this << m_pending.size ());
+  m_flush.Cancel ();
+  if (m_pending.empty ())
+    {
+      return;
+    }
+  uint32_t n = m_pending.size ();
+  m_batchModels.resize (n);
+  m_batchPositions.resize (n);
+  m_batchVelocities.resize (n);
+  for (uint32_t k = 0; k < n; k++)
+    {
+      m_batchModels[k] = m_models[m_pending[k]];
+    }
+  MobilityModel::GetPositions (&m_batchModels[0], n, &m_batchPositions[0], &m_batchVelocities[0]);
+  // sinks may move nodes and flush again, deliver a batch of our own
+  std::vector<Change> batch;
+  batch.swap (m_batch);
+  batch.resize (n);
+  for (uint32_t k = 0; k < n; k++)
+    {
+      batch[k].id = m_ids[m_pending[k]];
+      batch[k].position = m_batchPositions[k];
+      batch[k].velocity = m_batchVelocities[k];
+      m_isPending[m_pending[k]] = false;
+    }
+  m_pending.clear ();
+  m_batches++;
+  m_courseChangesTrace (batch);
+  batch.swap (m_batch);
+}
+
+} // namespace ns3
@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef COURSE_CHANGE_AGGREGATOR_H
+#define COURSE_CHANGE_AGGREGATOR_H
+
+#include <map>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/event-id.h"
+#include "ns3/traced-callback.h"
+#include "mobility-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Deliver the course changes of many nodes in batches.
+ *
+ * Instead of connecting every sink to the CourseChange trace source of
+ * every node, connect it once to the CourseChanges trace source of the
+ * aggregator.  The first course change notified after a batch was
+ * delivered starts a new one, which is delivered Window later: with the
+ * default zero Window, after the events already scheduled at the same
+ * simulation time.
+ *
+ * A node appears at most once per batch, however many times its course
+ * changed, with its position and velocity evaluated once when the batch is
+ * delivered, in one MobilityModel::GetPositions pass.
+ */
+class CourseChangeAggregator : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  CourseChangeAggregator ();
+  virtual ~CourseChangeAggregator ();
+
+  /// State of a node whose course changed
+  struct Change
+  {
+    uint32_t id; //!< identifier of the node
+    Vector position; //!< position when the batch was delivered
+    Vector velocity; //!< velocity when the batch was delivered
+  };
+
+  /**
+   * TracedCallback signature for batches of course changes.
+   * \param [in] changes the nodes whose course changed, in the order of
+   * their first change
+   */
+  typedef void (* BatchTracedCallback)(const std::vector<Change> &changes);
+
+  /**
+   * Follow the course changes of a node.
+   * \param model the mobility model of the node
+   * \param id the identifier reported for the node, e.g. its node id
+   */
+  void Add (Ptr<MobilityModel> model, uint32_t id);
+  /**
+   * \return the number of nodes followed
+   */
+  uint32_t GetN (void) const;
+  /**
+   * Deliver the pending batch now, e.g. at the end of the simulation.
+   */
+  void Flush (void);
+  /**
+   * \return the number of course changes notified by the nodes
+   */
+  uint64_t GetChangeCount (void) const;
+  /**
+   * \return the number of batches delivered
+   */
+  uint64_t GetBatchCount (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * CourseChange trace sink of the nodes.
+   * \param model the node whose course changed
+   */
+  void CourseChanged (Ptr<const MobilityModel> model);
+
+  Time m_window; //!< delay between the first change of a batch and its delivery
+  std::vector<Ptr<MobilityModel> > m_models; //!< nodes followed
+  std::vector<uint32_t> m_ids; //!< identifier of each node
+  std::map<const MobilityModel *, uint32_t> m_indices; //!< index of each node
+  std::vector<bool> m_isPending; //!< true if the node is in the pending batch
+  std::vector<uint32_t> m_pending; //!< nodes of the pending batch
+  EventId m_flush; //!< delivery of the pending batch
+  uint64_t m_changes; //!< course changes notified
+  uint64_t m_batches; //!< batches delivered
+  std::vector<Ptr<MobilityModel> > m_batchModels; //!< scratch list of the models of a batch
+  std::vector<Vector> m_batchPositions; //!< scratch list of their positions
+  std::vector<Vector> m_batchVelocities; //!< scratch list of their velocities
+  std::vector<Change> m_batch; //!< storage reused by the next batch
+  TracedCallback<const std::vector<Change> &> m_courseChangesTrace; //!< batch delivery
+};
+
+} // namespace ns3
+
+#endif /* COURSE_CHANGE_AGGREGATOR_H */
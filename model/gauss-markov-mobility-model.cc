@@ -24,6 +24,7 @@
 #include "ns3/string.h"
 #include "gauss-markov-mobility-model.h"
 #include "position-allocator.h"
+#include "mobility-stats.h"
 
 namespace ns3 {
 
@@ -90,6 +91,7 @@ GaussMarkovMobilityModel::GaussMarkovMobilityModel ()
   m_meanVelocity = 0.0;
   m_meanDirection = 0.0;
   m_meanPitch = 0.0;
+  MOBILITY_STATS_COUNT (this, SCHEDULE);
   m_event = Simulator::ScheduleNow (&GaussMarkovMobilityModel::Start, this);
   m_helper.Unpause ();
 }
@@ -97,6 +99,7 @@ GaussMarkovMobilityModel::GaussMarkovMobilityModel ()
 void
 GaussMarkovMobilityModel::Start (void)
 {
+  MOBILITY_STATS_SCOPE (this, UPDATE);
   if (m_meanVelocity == 0.0)
     {
       //Initialize the mean velocity, direction, and pitch variables
@@ -161,6 +164,7 @@ GaussMarkovMobilityModel::DoWalk (Time delayLeft)
   // If out of bounds, then alter the velocity vector and average direction to keep the position in bounds
   if (m_bounds.IsInside (nextPosition))
     {
+      MOBILITY_STATS_COUNT (this, SCHEDULE);
       m_event = Simulator::Schedule (delayLeft, &GaussMarkovMobilityModel::Start, this);
     }
   else
@@ -187,6 +191,7 @@ GaussMarkovMobilityModel::DoWalk (Time delayLeft)
       m_Pitch = m_meanPitch;
       m_helper.SetVelocity (speed);
       m_helper.Unpause ();
+      MOBILITY_STATS_COUNT (this, SCHEDULE);
       m_event = Simulator::Schedule (delayLeft, &GaussMarkovMobilityModel::Start, this);
     }
   NotifyCourseChange ();
@@ -210,6 +215,7 @@ GaussMarkovMobilityModel::DoSetPosition (const Vector &position)
 {
   m_helper.SetPosition (position);
   m_event.Cancel ();
+  MOBILITY_STATS_COUNT (this, SCHEDULE);
   m_event = Simulator::ScheduleNow (&GaussMarkovMobilityModel::Start, this);
 }
 Vector
@@ -217,6 +223,13 @@ GaussMarkovMobilityModel::DoGetVelocity (void) const
 {
   return m_helper.GetVelocity ();
 }
+TrajectorySegment
+GaussMarkovMobilityModel::DoGetCurrentSegment (void) const
+{
+  // the helper moves in a straight line until the next scheduled event
+  m_helper.Update ();
+  return m_helper.GetSegment (m_event.IsRunning () ? TimeStep (m_event.GetTs ()) : Time::Max ());
+}
 
 int64_t
 GaussMarkovMobilityModel::DoAssignStreams (int64_t stream)
@@ -100,6 +100,7 @@ private:
   virtual Vector DoGetPosition (void) const;
   virtual void DoSetPosition (const Vector &position);
   virtual Vector DoGetVelocity (void) const;
+  virtual TrajectorySegment DoGetCurrentSegment (void) const;
   virtual int64_t DoAssignStreams (int64_t);
   ConstantVelocityHelper m_helper; //!< constant velocity helper
   Time m_timeStep; //!< duraiton after which direction and speed should change
@@ -0,0 +1,366 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
+#include "kinetic-range-monitor.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("KineticRangeMonitor");
+
+NS_OBJECT_ENSURE_REGISTERED (KineticRangeMonitor);
+
+/// Smallest step of the conservative advancement, in seconds
+static const double MIN_STEP = 1e-6;
+/// Largest number of steps of one conservative advancement search
+static const uint32_t MAX_STEPS = 100000;
+/// Distance to the range below which a revision keeps the known state, in meters
+static const double STATE_TOLERANCE = 1e-6;
+
+TypeId
+KineticRangeMonitor::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::KineticRangeMonitor")
+    .SetParent<Object> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<KineticRangeMonitor> ()
+    .AddAttribute ("Range",
+                   "Distance below which two nodes are within range",
+                   DoubleValue (100.0),
+                   MakeDoubleAccessor (&KineticRangeMonitor::m_range),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("Lookahead",
+                   "Longest search for a crossing along curved segments, "
+                   "the certificate is revised there.",
+                   TimeValue (Seconds (60.0)),
+                   MakeTimeAccessor (&KineticRangeMonitor::m_lookahead),
+                   MakeTimeChecker ())
+    .AddAttribute ("PollInterval",
+                   "Revision period of the pairs with a node whose model does not "
+                   "describe its trajectory ahead.",
+                   TimeValue (Seconds (1.0)),
+                   MakeTimeAccessor (&KineticRangeMonitor::m_pollInterval),
+                   MakeTimeChecker ())
+    .AddTraceSource ("RangeEnter",
+                     "Two nodes came within range",
+                     MakeTraceSourceAccessor (&KineticRangeMonitor::m_rangeEnterTrace),
+                     "ns3::KineticRangeMonitor::RangeTracedCallback")
+    .AddTraceSource ("RangeLeave",
+                     "Two nodes went out of range",
+                     MakeTraceSourceAccessor (&KineticRangeMonitor::m_rangeLeaveTrace),
+                     "ns3::KineticRangeMonitor::RangeTracedCallback")
+  ;
+  return tid;
+}
+
+KineticRangeMonitor::KineticRangeMonitor ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+KineticRangeMonitor::~KineticRangeMonitor ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+KineticRangeMonitor::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Pair>::iterator i = m_pairs.begin (); i != m_pairs.end (); ++i)
+    {
+      i->event.Cancel ();
+    }
+  for (std::vector<Ptr<MobilityModel> >::iterator i = m_models.begin (); i != m_models.end (); ++i)
+    {
+      (*i)->TraceDisconnectWithoutContext ("CourseChange",
+                                           MakeCallback (&KineticRangeMonitor::CourseChanged, this));
+    }
+  m_models.clear ();
+  m_indices.clear ();
+  m_pairs.clear ();
+  Object::DoDispose ();
+}
+
+uint32_t
+KineticRangeMonitor::Add (Ptr<MobilityModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  NS_ASSERT_MSG (m_indices.find (PeekPointer (model)) == m_indices.end (), "Node added twice");
+  uint32_t index = m_models.size ();
+  m_models.push_back (model);
+  m_indices[PeekPointer (model)] = index;
+  Pair pair;
+  pair.inRange = false;
+  m_pairs.resize (m_pairs.size () + index, pair);
+  model->TraceConnectWithoutContext ("CourseChange",
+                                     MakeCallback (&KineticRangeMonitor::CourseChanged, this));
+  for (uint32_t j = 0; j < index; j++)
+    {
+      Predict (index, j);
+    }
+  return index;
+}
+
+uint32_t
+KineticRangeMonitor::GetN (void) const
+{
+  return m_models.size ();
+}
+
+KineticRangeMonitor::Pair &
+KineticRangeMonitor::GetPair (uint32_t i, uint32_t j)
+{
+  NS_ASSERT (i != j && i < GetN () && j < GetN ());
+  if (i < j)
+    {
+      std::swap (i, j);
+    }
+  return m_pairs[i * (i - 1) / 2 + j];
+}
+
+const KineticRangeMonitor::Pair &
+KineticRangeMonitor::GetPair (uint32_t i, uint32_t j) const
+{
+  NS_ASSERT (i != j && i < GetN () && j < GetN ());
+  if (i < j)
+    {
+      std::swap (i, j);
+    }
+  return m_pairs[i * (i - 1) / 2 + j];
+}
+
+bool
+KineticRangeMonitor::IsInRange (uint32_t i, uint32_t j) const
+{
+  return GetPair (i, j).inRange;
+}
+
+Time
+KineticRangeMonitor::GetNextEvent (uint32_t i, uint32_t j) const
+{
+  const Pair &pair = GetPair (i, j);
+  if (!pair.event.IsRunning ())
+    {
+      return Time::Max ();
+    }
+  return TimeStep (pair.event.GetTs ());
+}
+
+bool
+KineticRangeMonitor::IsLinear (const TrajectorySegment &segment)
+{
+  return segment.GetType () == TrajectorySegment::CONSTANT_POSITION
+         || segment.GetType () == TrajectorySegment::CONSTANT_VELOCITY;
+}
+
+double
+KineticRangeMonitor::GetSpeedBound (const TrajectorySegment &segment, const Time &from, const Time &until)
+{
+  switch (segment.GetType ())
+    {
+    case TrajectorySegment::CONSTANT_POSITION:
+      return 0.0;
+    case TrajectorySegment::CONSTANT_VELOCITY:
+      return CalculateDistance (segment.GetVelocity (), Vector (0.0, 0.0, 0.0));
+    case TrajectorySegment::CONSTANT_ACCELERATION:
+      // the speed is the norm of an affine function of time, it peaks at an end
+      return std::max (CalculateDistance (segment.GetVelocityAt (from), Vector (0.0, 0.0, 0.0)),
+                       CalculateDistance (segment.GetVelocityAt (until), Vector (0.0, 0.0, 0.0)));
+    case TrajectorySegment::CIRCULAR_ARC:
+      return segment.GetRadius () * std::fabs (segment.GetAngularRate ());
+    }
+  return 0.0;
+}
+
+bool
+KineticRangeMonitor::FindCrossing (const TrajectorySegment &a, const TrajectorySegment &b, double range,
+                                   bool inRange, const Time &from, const Time &until, Time &at)
+{
+  at = until;
+  if (until <= from)
+    {
+      return false;
+    }
+  if (IsLinear (a) && IsLinear (b))
+    {
+      // |p + v t|^2 = range^2, the pair is within range between the two roots
+      Vector pa = a.GetPositionAt (from);
+      Vector pb = b.GetPositionAt (from);
+      Vector va = a.GetVelocityAt (from);
+      Vector vb = b.GetVelocityAt (from);
+      Vector p = Vector (pa.x - pb.x, pa.y - pb.y, pa.z - pb.z);
+      Vector v = Vector (va.x - vb.x, va.y - vb.y, va.z - vb.z);
+      double qa = v.x * v.x + v.y * v.y + v.z * v.z;
+      double qb = 2 * (p.x * v.x + p.y * v.y + p.z * v.z);
+      double qc = p.x * p.x + p.y * p.y + p.z * p.z - range * range;
+      double discriminant = qb * qb - 4 * qa * qc;
+      if (qa == 0 || discriminant <= 0)
+        {
+          return false;
+        }
+      double root = std::sqrt (discriminant);
+      double t = inRange ? (-qb + root) / (2 * qa) : (-qb - root) / (2 * qa);
+      // a root in the past means the state was decided at a crossing by rounding
+      if (t <= 0 || from + Seconds (t) > until)
+        {
+          return false;
+        }
+      at = from + Seconds (t);
+      return true;
+    }
+  // conservative advancement: no crossing closer than |d - range| / vmax
+  double horizon = (until - from).GetSeconds ();
+  double vmax = GetSpeedBound (a, from, until) + GetSpeedBound (b, from, until);
+  if (vmax == 0)
+    {
+      return false;
+    }
+  double t = 0.0;
+  for (uint32_t step = 0; step < MAX_STEPS; step++)
+    {
+      Time now = from + Seconds (t);
+      double d = CalculateDistance (a.GetPositionAt (now), b.GetPositionAt (now));
+      double next = std::min (t + std::max (std::fabs (d - range) / vmax, MIN_STEP), horizon);
+      Time then = from + Seconds (next);
+      if ((CalculateDistance (a.GetPositionAt (then), b.GetPositionAt (then)) < range) != inRange)
+        {
+          // bisect down to the first time with the new state
+          double lo = t;
+          double hi = next;
+          while (hi - lo > 1e-9)
+            {
+              double mid = (lo + hi) / 2;
+              Time middle = from + Seconds (mid);
+              if ((CalculateDistance (a.GetPositionAt (middle), b.GetPositionAt (middle)) < range) != inRange)
+                {
+                  hi = mid;
+                }
+              else
+                {
+                  lo = mid;
+                }
+            }
+          at = from + Seconds (hi);
+          return true;
+        }
+      if (next >= horizon)
+        {
+          return false;
+        }
+      t = next;
+    }
+  at = from + Seconds (t);
+  return false;
+}
+
+void
+KineticRangeMonitor::Certify (uint32_t i, uint32_t j, const TrajectorySegment &a, const TrajectorySegment &b)
+{
+  Pair &pair = GetPair (i, j);
+  pair.event.Cancel ();
+  Time now = Simulator::Now ();
+  Time end = Min (a.GetEnd (), b.GetEnd ());
+  if (end <= now)
+    {
+      // one of the models only knows where it is now
+      pair.event = Simulator::Schedule (m_pollInterval, &KineticRangeMonitor::Predict, this, i, j);
+      return;
+    }
+  if (!IsLinear (a) || !IsLinear (b))
+    {
+      end = Min (end, now + m_lookahead);
+    }
+  Time at;
+  if (FindCrossing (a, b, m_range, pair.inRange, now, end, at))
+    {
+      NS_LOG_LOGIC ("Nodes " << i << " and " << j << " cross the range at " << at);
+      pair.event = Simulator::Schedule (at - now, &KineticRangeMonitor::Crossing, this, i, j);
+    }
+  else if (at != Time::Max ())
+    {
+      // the certificate holds until a segment ends or the search stopped
+      pair.event = Simulator::Schedule (at - now, &KineticRangeMonitor::Predict, this, i, j);
+    }
+}
+
+void
+KineticRangeMonitor::Predict (uint32_t i, uint32_t j)
+{
+  NS_LOG_FUNCTION (this << i << j);
+  Time now = Simulator::Now ();
+  TrajectorySegment a = m_models[i]->GetCurrentSegment ();
+  TrajectorySegment b = m_models[j]->GetCurrentSegment ();
+  double distance = CalculateDistance (a.GetPositionAt (now), b.GetPositionAt (now));
+  // right at a crossing, trust the state the crossing event set
+  if (std::fabs (distance - m_range) > STATE_TOLERANCE)
+    {
+      SetInRange (i, j, distance < m_range);
+    }
+  Certify (i, j, a, b);
+}
+
+void
+KineticRangeMonitor::Crossing (uint32_t i, uint32_t j)
+{
+  NS_LOG_FUNCTION (this << i << j);
+  SetInRange (i, j, !GetPair (i, j).inRange);
+  Certify (i, j, m_models[i]->GetCurrentSegment (), m_models[j]->GetCurrentSegment ());
+}
+
+void
+KineticRangeMonitor::SetInRange (uint32_t i, uint32_t j, bool inRange)
+{
+  Pair &pair = GetPair (i, j);
+  if (pair.inRange == inRange)
+    {
+      return;
+    }
+  pair.inRange = inRange;
+  NS_LOG_INFO ("Nodes " << i << " and " << j << (inRange ? " enter" : " leave") << " range");
+  if (inRange)
+    {
+      m_rangeEnterTrace (m_models[i], m_models[j]);
+    }
+  else
+    {
+      m_rangeLeaveTrace (m_models[i], m_models[j]);
+    }
+}
+
+void
+KineticRangeMonitor::CourseChanged (Ptr<const MobilityModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  std::map<const MobilityModel *, uint32_t>::const_iterator it = m_indices.find (PeekPointer (model));
+  NS_ASSERT (it != m_indices.end ());
+  uint32_t index = it->second;
+  for (uint32_t j = 0; j < GetN (); j++)
+    {
+      if (j != index)
+        {
+          Predict (index, j);
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,193 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef KINETIC_RANGE_MONITOR_H
+#define KINETIC_RANGE_MONITOR_H
+
+#include <map>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/traced-callback.h"
+#include "mobility-model.h"
+#include "trajectory-segment.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Event driven detection of nodes entering and leaving range.
+ *
+ * The monitor is a kinetic data structure: for every pair of nodes it keeps
+ * one certificate, the next time at which the pair enters or leaves Range,
+ * computed from the MobilityModel::GetCurrentSegment of both nodes, and
+ * schedules one event there.  Certificates are revised when one of the two
+ * nodes fires CourseChange, or when one of the two segments ends.
+ *
+ * The crossing of two straight segments is solved in closed form.  Other
+ * segments (arcs, accelerations) are searched by conservative advancement:
+ * the distance can not change faster than the sum of the speed bounds of the
+ * two segments, so the search steps by |distance - Range| over that bound
+ * and never steps over a crossing.  Such searches stop after Lookahead, where
+ * the certificate is revised.
+ *
+ * Models without an analytic segment, whose segment ends at the current
+ * time, are polled every PollInterval.
+ *
+ * The RangeEnter and RangeLeave trace sources fire at the crossings.
+ * Unlike ns3::CircularEncounterPredictor, the monitor handles any mix of
+ * mobility models.
+ */
+class KineticRangeMonitor : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  KineticRangeMonitor ();
+  virtual ~KineticRangeMonitor ();
+
+  /**
+   * TracedCallback signature for range crossings.
+   * \param [in] a the mobility model of the first node
+   * \param [in] b the mobility model of the second node
+   */
+  typedef void (* RangeTracedCallback)(Ptr<const MobilityModel> a, Ptr<const MobilityModel> b);
+
+  /**
+   * Follow a node and certify its range with every node added so far.
+   * \param model the mobility model of the node
+   * \return the index of the node
+   */
+  uint32_t Add (Ptr<MobilityModel> model);
+  /**
+   * \return the number of nodes followed
+   */
+  uint32_t GetN (void) const;
+  /**
+   * \param i the index of a node
+   * \param j the index of another node
+   * \return true if the two nodes are currently within range
+   */
+  bool IsInRange (uint32_t i, uint32_t j) const;
+  /**
+   * \param i the index of a node
+   * \param j the index of another node
+   * \return the time of the next scheduled crossing or revision of the pair,
+   * or Time::Max () if none is scheduled
+   */
+  Time GetNextEvent (uint32_t i, uint32_t j) const;
+
+  /**
+   * Find when the range state of two segments next changes.
+   * \param a the segment of the first node
+   * \param b the segment of the second node
+   * \param range the communication range
+   * \param inRange the range state at time from
+   * \param from the start of the search
+   * \param until the end of the search, no later than the end of either
+   * segment
+   * \param at set to the time of the crossing if found, otherwise to the time
+   * up to which no crossing happens
+   * \return true if a crossing was found
+   */
+  static bool FindCrossing (const TrajectorySegment &a, const TrajectorySegment &b, double range,
+                            bool inRange, const Time &from, const Time &until, Time &at);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// Certificate of a pair of nodes
+  struct Pair
+  {
+    bool inRange; //!< true while the nodes are within range
+    EventId event; //!< next crossing or revision
+  };
+  /**
+   * \param i the index of a node
+   * \param j the index of another node
+   * \return the pair of the two nodes
+   */
+  Pair & GetPair (uint32_t i, uint32_t j);
+  /**
+   * \param i the index of a node
+   * \param j the index of another node
+   * \return the pair of the two nodes
+   */
+  const Pair & GetPair (uint32_t i, uint32_t j) const;
+  /**
+   * \param segment a segment
+   * \return true if the segment moves in a straight line at constant speed
+   */
+  static bool IsLinear (const TrajectorySegment &segment);
+  /**
+   * \param segment a segment
+   * \param from the start of an interval within the segment
+   * \param until the end of the interval
+   * \return an upper bound of the speed along the segment over the interval
+   */
+  static double GetSpeedBound (const TrajectorySegment &segment, const Time &from, const Time &until);
+  /**
+   * Revise the certificate of a pair from the current positions and segments.
+   * \param i the index of a node
+   * \param j the index of another node
+   */
+  void Predict (uint32_t i, uint32_t j);
+  /**
+   * Schedule the next crossing, or revision, of a pair from its current
+   * range state.
+   * \param i the index of a node
+   * \param j the index of another node
+   * \param a the current segment of node i
+   * \param b the current segment of node j
+   */
+  void Certify (uint32_t i, uint32_t j, const TrajectorySegment &a, const TrajectorySegment &b);
+  /**
+   * A pair crossed the range.
+   * \param i the index of a node
+   * \param j the index of another node
+   */
+  void Crossing (uint32_t i, uint32_t j);
+  /**
+   * Record a new range state and fire the matching trace.
+   * \param i the index of a node
+   * \param j the index of another node
+   * \param inRange the new range state
+   */
+  void SetInRange (uint32_t i, uint32_t j, bool inRange);
+  /**
+   * CourseChange trace sink of the nodes.
+   * \param model the node whose course changed
+   */
+  void CourseChanged (Ptr<const MobilityModel> model);
+
+  double m_range; //!< communication range
+  Time m_lookahead; //!< longest search along curved segments
+  Time m_pollInterval; //!< revision period of non analytic models
+  std::vector<Ptr<MobilityModel> > m_models; //!< nodes followed
+  std::map<const MobilityModel *, uint32_t> m_indices; //!< index of each node
+  std::vector<Pair> m_pairs; //!< pair (i, j), j < i, is at i * (i - 1) / 2 + j
+  TracedCallback<Ptr<const MobilityModel>, Ptr<const MobilityModel> > m_rangeEnterTrace; //!< nodes come within range
+  TracedCallback<Ptr<const MobilityModel>, Ptr<const MobilityModel> > m_rangeLeaveTrace; //!< nodes go out of range
+};
+
+} // namespace ns3
+
+#endif /* KINETIC_RANGE_MONITOR_H */
@@ -22,6 +22,9 @@
 
 #include "mobility-model.h"
 #include "ns3/trace-source-accessor.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
+#include "mobility-stats.h"
 
 namespace ns3 {
 
@@ -44,6 +47,12 @@ MobilityModel::GetTypeId (void)
                    VectorValue (Vector (0.0, 0.0, 0.0)), // ignored initial value.
                    MakeVectorAccessor (&MobilityModel::GetVelocity),
                    MakeVectorChecker ())
+    .AddAttribute ("CachePositions",
+                   "Remember the position and velocity computed at the current time "
+                   "until the time advances, SetPosition is called or the course changes.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&MobilityModel::m_cacheEnabled),
+                   MakeBooleanChecker ())
     .AddTraceSource ("CourseChange", 
                      "The value of the position and/or velocity vector changed",
                      MakeTraceSourceAccessor (&MobilityModel::m_courseChangeTrace),
@@ -53,6 +62,13 @@ MobilityModel::GetTypeId (void)
 }
 
 MobilityModel::MobilityModel ()
+  : m_cacheEnabled (false),
+    m_positionCached (false),
+    m_velocityCached (false),
+    m_cacheHits (0),
+    m_cacheMisses (0),
+    m_analytic (false),
+    m_analyticType (TrajectorySegment::CONSTANT_POSITION)
 {
 }
 
@@ -63,25 +79,157 @@ MobilityModel::~MobilityModel ()
 Vector
 MobilityModel::GetPosition (void) const
 {
-  return DoGetPosition ();
+  if (!m_cacheEnabled)
+    {
+      MOBILITY_STATS_SCOPE (this, GET_POSITION);
+      return DoGetPosition ();
+    }
+  Time now = Simulator::Now ();
+  if (m_positionCached && m_positionTime == now)
+    {
+      m_cacheHits++;
+      return m_cachedPosition;
+    }
+  m_cacheMisses++;
+  MOBILITY_STATS_SCOPE (this, GET_POSITION);
+  m_cachedPosition = DoGetPosition ();
+  m_positionTime = now;
+  m_positionCached = true;
+  return m_cachedPosition;
 }
 Vector
 MobilityModel::GetVelocity (void) const
 {
-  return DoGetVelocity ();
+  if (!m_cacheEnabled)
+    {
+      MOBILITY_STATS_SCOPE (this, GET_VELOCITY);
+      return DoGetVelocity ();
+    }
+  Time now = Simulator::Now ();
+  if (m_velocityCached && m_velocityTime == now)
+    {
+      m_cacheHits++;
+      return m_cachedVelocity;
+    }
+  m_cacheMisses++;
+  MOBILITY_STATS_SCOPE (this, GET_VELOCITY);
+  m_cachedVelocity = DoGetVelocity ();
+  m_velocityTime = now;
+  m_velocityCached = true;
+  return m_cachedVelocity;
 }
 
 void 
 MobilityModel::SetPosition (const Vector &position)
 {
+  MOBILITY_STATS_SCOPE (this, UPDATE);
+  m_positionCached = false;
+  m_velocityCached = false;
   DoSetPosition (position);
+  // DoSetPosition may have queried the old state
+  m_positionCached = false;
+  m_velocityCached = false;
+}
+
+TrajectorySegment
+MobilityModel::GetCurrentSegment (void) const
+{
+  TrajectorySegment segment = DoGetCurrentSegment ();
+  NS_ASSERT_MSG (segment.IsValidAt (Simulator::Now ()), "Segment " << segment << " does not cover the current time");
+  return segment;
+}
+
+TrajectorySegment
+MobilityModel::DoGetCurrentSegment (void) const
+{
+  Time now = Simulator::Now ();
+  return TrajectorySegment::ConstantVelocity (now, now, GetPosition (), GetVelocity ());
+}
+
+bool
+MobilityModel::IsAnalytic (void) const
+{
+  return m_analytic;
+}
+
+void
+MobilityModel::SetAnalyticSegment (const TrajectorySegment &segment)
+{
+  NS_ASSERT_MSG (segment.GetType () != TrajectorySegment::CIRCULAR_ARC, "Only polynomial segments can be published");
+  NS_ASSERT_MSG (segment.GetEnd () == Time::Max (), "Published segments must not end");
+  m_analytic = true;
+  m_analyticType = segment.GetType ();
+  m_analyticStart = segment.GetStart ();
+  m_analyticPosition = segment.GetPosition ();
+  m_analyticVelocity = segment.GetVelocity ();
+  m_analyticAcceleration = segment.GetAcceleration ();
+}
+
+void
+MobilityModel::ClearAnalyticSegment (void)
+{
+  m_analytic = false;
+}
+
+inline void
+MobilityModel::GetAnalyticState (const Time &now, Vector *position, Vector *velocity) const
+{
+  switch (m_analyticType)
+    {
+    case TrajectorySegment::CONSTANT_VELOCITY:
+      {
+        double t = (now - m_analyticStart).GetSeconds ();
+        *position = Vector (m_analyticPosition.x + m_analyticVelocity.x * t,
+                            m_analyticPosition.y + m_analyticVelocity.y * t,
+                            m_analyticPosition.z + m_analyticVelocity.z * t);
+        if (velocity)
+          {
+            *velocity = m_analyticVelocity;
+          }
+        return;
+      }
+    case TrajectorySegment::CONSTANT_ACCELERATION:
+      {
+        double t = (now - m_analyticStart).GetSeconds ();
+        double halfSquare = 0.5 * t * t;
+        *position = Vector (m_analyticPosition.x + m_analyticVelocity.x * t + m_analyticAcceleration.x * halfSquare,
+                            m_analyticPosition.y + m_analyticVelocity.y * t + m_analyticAcceleration.y * halfSquare,
+                            m_analyticPosition.z + m_analyticVelocity.z * t + m_analyticAcceleration.z * halfSquare);
+        if (velocity)
+          {
+            *velocity = Vector (m_analyticVelocity.x + m_analyticAcceleration.x * t,
+                                m_analyticVelocity.y + m_analyticAcceleration.y * t,
+                                m_analyticVelocity.z + m_analyticAcceleration.z * t);
+          }
+        return;
+      }
+    default:
+      *position = m_analyticPosition;
+      if (velocity)
+        {
+          *velocity = Vector (0.0, 0.0, 0.0);
+        }
+      return;
+    }
+}
+
+uint64_t
+MobilityModel::GetCacheHits (void) const
+{
+  return m_cacheHits;
+}
+
+uint64_t
+MobilityModel::GetCacheMisses (void) const
+{
+  return m_cacheMisses;
 }
 
 double 
 MobilityModel::GetDistanceFrom (Ptr<const MobilityModel> other) const
 {
-  Vector oPosition = other->DoGetPosition ();
-  Vector position = DoGetPosition ();
+  Vector oPosition = other->GetPosition ();
+  Vector position = GetPosition ();
   return CalculateDistance (position, oPosition);
 }
 
@@ -94,9 +242,52 @@ MobilityModel::GetRelativeSpeed (Ptr<const MobilityModel> other) const
 void
 MobilityModel::NotifyCourseChange (void) const
 {
+  MOBILITY_STATS_SCOPE (this, COURSE_CHANGE);
+  m_positionCached = false;
+  m_velocityCached = false;
   m_courseChangeTrace (this);
 }
 
+void
+MobilityModel::GetPositions (const Ptr<MobilityModel> *models, uint32_t n,
+                             Vector *positions, Vector *velocities)
+{
+  Time now = Simulator::Now ();
+  uint32_t i = 0;
+  while (i < n)
+    {
+      const MobilityModel *model = PeekPointer (models[i]);
+      if (model->m_analytic)
+        {
+          MOBILITY_STATS_COUNT (model, GET_POSITION);
+          model->GetAnalyticState (now, positions + i, velocities ? velocities + i : 0);
+          i++;
+          continue;
+        }
+      uint32_t done;
+      {
+        MOBILITY_STATS_SCOPE (model, GET_POSITION);
+        done = models[i]->DoGetPositions (models + i, n - i, positions + i,
+                                          velocities ? velocities + i : 0);
+        MOBILITY_STATS_SET_COUNT (done);
+      }
+      NS_ASSERT (done >= 1 && done <= n - i);
+      i += done;
+    }
+}
+
+uint32_t
+MobilityModel::DoGetPositions (const Ptr<MobilityModel> *models, uint32_t n,
+                               Vector *positions, Vector *velocities) const
+{
+  positions[0] = GetPosition ();
+  if (velocities)
+    {
+      velocities[0] = GetVelocity ();
+    }
+  return 1;
+}
+
 int64_t
 MobilityModel::AssignStreams (int64_t start)
 {
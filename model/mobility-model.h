@@ -22,7 +22,9 @@
 
 #include "ns3/vector.h"
 #include "ns3/object.h"
+#include "ns3/nstime.h"
 #include "ns3/traced-callback.h"
+#include "trajectory-segment.h"
 
 namespace ns3 {
 
@@ -35,6 +37,20 @@ namespace ns3 {
  * metric international units.
  *
  * This is a base class for all specific mobility models.
+ *
+ * When the CachePositions attribute is set, the position and velocity
+ * computed by the subclass are remembered for the rest of the current
+ * simulation time, so that the many receivers of a broadcast asking for
+ * the position of its sender only compute it once.  The cache is cleared
+ * by SetPosition and NotifyCourseChange; only enable it for models which
+ * notify every change of their trajectory, and not for models which move
+ * in their own events without notifying.
+ *
+ * Models whose whole trajectory is a constant position, velocity or
+ * acceleration from a base time publish it with SetAnalyticSegment.  The
+ * bulk GetPositions evaluates such models in place from that state,
+ * without the virtual DoGetPosition and DoGetVelocity calls; the results
+ * agree with GetPosition and GetVelocity to within rounding.
  */
 class MobilityModel : public Object
 {
@@ -78,6 +94,47 @@ public:
    * \return the number of stream indices assigned by this model
    */
   int64_t AssignStreams (int64_t stream);
+  /**
+   * Fill the position, and optionally the velocity, of a list of mobility
+   * models at the current time in one pass.
+   *
+   * Runs of consecutive models that can be evaluated together are handed
+   * to the bulk implementation of their type, so keep models of the same
+   * kind next to each other in the list.  Models which published their
+   * trajectory with SetAnalyticSegment are evaluated in place.
+   *
+   * \param models the mobility models
+   * \param n the number of models
+   * \param positions receives the n positions
+   * \param velocities receives the n velocities, or null
+   */
+  static void GetPositions (const Ptr<MobilityModel> *models, uint32_t n,
+                            Vector *positions, Vector *velocities = 0);
+  /**
+   * \return the number of position and velocity queries answered from
+   * the cache
+   */
+  uint64_t GetCacheHits (void) const;
+  /**
+   * \return the number of position and velocity queries computed by the
+   * subclass while the cache was enabled
+   */
+  uint64_t GetCacheMisses (void) const;
+  /**
+   * Describe how the node moves from now on, e.g. to estimate link
+   * lifetimes or to index nodes by trajectory instead of by sampling.
+   *
+   * \return a segment valid at the current time; the motion it describes
+   * holds until its end time unless SetPosition is called or a course
+   * change is notified first
+   */
+  TrajectorySegment GetCurrentSegment (void) const;
+  /**
+   * \return true if the model published its trajectory with
+   * SetAnalyticSegment, so that GetPositions evaluates it without virtual
+   * calls
+   */
+  bool IsAnalytic (void) const;
 
   /**
    *  TracedCallback signature.
@@ -92,7 +149,27 @@ protected:
    * position changes to notify course change listeners.
    */
   void NotifyCourseChange (void) const;
+  /**
+   * Publish the closed form of the trajectory, to be called by subclasses
+   * whenever it changes.  Subclasses of a model publishing its trajectory
+   * which change how it moves must call ClearAnalyticSegment.
+   *
+   * \param segment a constant position, velocity or acceleration segment
+   * valid until Time::Max ()
+   */
+  void SetAnalyticSegment (const TrajectorySegment &segment);
+  /**
+   * Evaluate the model through the virtual methods again.
+   */
+  void ClearAnalyticSegment (void);
 private:
+  /**
+   * Evaluate the published trajectory.
+   * \param now the current time
+   * \param position receives the position
+   * \param velocity receives the velocity, or null
+   */
+  void GetAnalyticState (const Time &now, Vector *position, Vector *velocity) const;
   /**
    * \return the current position.
    *
@@ -122,6 +199,29 @@ private:
    * \return the number of streams used
    */
   virtual int64_t DoAssignStreams (int64_t start);
+  /**
+   * Fill the state of a run of models starting with this one.
+   *
+   * The default implementation only handles this model.  Subclasses able
+   * to evaluate several of their instances at once override it and handle
+   * as many of the following models as they can.
+   *
+   * \param models the models left in the list, models[0] is this model
+   * \param n the number of models left in the list
+   * \param positions receives the positions of the models handled
+   * \param velocities receives the velocities of the models handled, or null
+   * \return the number of models handled, at least one
+   */
+  virtual uint32_t DoGetPositions (const Ptr<MobilityModel> *models, uint32_t n,
+                                   Vector *positions, Vector *velocities) const;
+  /**
+   * The default implementation returns a constant velocity segment built
+   * from the current position and velocity and only valid at the current
+   * time.  Subclasses which know their trajectory ahead override it.
+   *
+   * \return the current segment of the trajectory
+   */
+  virtual TrajectorySegment DoGetCurrentSegment (void) const;
 
   /**
    * Used to alert subscribers that a change in direction, velocity,
@@ -129,6 +229,23 @@ private:
    */
   ns3::TracedCallback<Ptr<const MobilityModel> > m_courseChangeTrace;
 
+  bool m_cacheEnabled; //!< true if positions and velocities are memoized
+  mutable bool m_positionCached; //!< true if m_cachedPosition is valid at m_positionTime
+  mutable bool m_velocityCached; //!< true if m_cachedVelocity is valid at m_velocityTime
+  mutable Time m_positionTime; //!< time at which m_cachedPosition was computed
+  mutable Time m_velocityTime; //!< time at which m_cachedVelocity was computed
+  mutable Vector m_cachedPosition; //!< last computed position
+  mutable Vector m_cachedVelocity; //!< last computed velocity
+  mutable uint64_t m_cacheHits; //!< queries answered from the cache
+  mutable uint64_t m_cacheMisses; //!< queries computed while the cache was enabled
+
+  bool m_analytic; //!< true if the trajectory below was published
+  TrajectorySegment::Type m_analyticType; //!< kind of the published trajectory
+  Time m_analyticStart; //!< base time of the published trajectory
+  Vector m_analyticPosition; //!< position at the base time
+  Vector m_analyticVelocity; //!< velocity at the base time
+  Vector m_analyticAcceleration; //!< constant acceleration
+
 };
 
 } // namespace ns3
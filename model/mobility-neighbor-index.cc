@@ -0,0 +1,449 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/simulator.h"
+#include "mobility-neighbor-index.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MobilityNeighborIndex");
+
+NS_OBJECT_ENSURE_REGISTERED (MobilityNeighborIndex);
+
+/// Marks a node which is not in any cell yet
+static const uint32_t NO_SLOT = std::numeric_limits<uint32_t>::max ();
+
+TypeId
+MobilityNeighborIndex::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MobilityNeighborIndex")
+    .SetParent<Object> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<MobilityNeighborIndex> ()
+    .AddAttribute ("CellSize",
+                   "Width of the cells of the grid. "
+                   "Can not be changed once nodes are indexed.",
+                   DoubleValue (100.0),
+                   MakeDoubleAccessor (&MobilityNeighborIndex::SetCellSize,
+                                       &MobilityNeighborIndex::GetCellSize),
+                   MakeDoubleChecker<double> ())
+  ;
+  return tid;
+}
+
+MobilityNeighborIndex::MobilityNeighborIndex ()
+  : m_minX (std::numeric_limits<int64_t>::max ()),
+    m_maxX (std::numeric_limits<int64_t>::min ()),
+    m_minY (std::numeric_limits<int64_t>::max ()),
+    m_maxY (std::numeric_limits<int64_t>::min ()),
+    m_lastRefresh (Seconds (-1.0)),
+    m_dirty (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MobilityNeighborIndex::~MobilityNeighborIndex ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MobilityNeighborIndex::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Ptr<MobilityModel> >::iterator i = m_models.begin (); i != m_models.end (); ++i)
+    {
+      (*i)->TraceDisconnectWithoutContext ("CourseChange",
+                                           MakeCallback (&MobilityNeighborIndex::CourseChanged, this));
+    }
+  m_models.clear ();
+  m_entries.clear ();
+  m_indices.clear ();
+  m_cells.clear ();
+  m_staleModels.clear ();
+  Object::DoDispose ();
+}
+
+void
+MobilityNeighborIndex::SetCellSize (double cellSize)
+{
+  NS_LOG_FUNCTION (this << cellSize);
+  NS_ABORT_MSG_IF (!m_models.empty (), "CellSize can not be changed once nodes are indexed");
+  m_cellSize = cellSize;
+}
+
+double
+MobilityNeighborIndex::GetCellSize (void) const
+{
+  return m_cellSize;
+}
+
+uint64_t
+MobilityNeighborIndex::GetCellKey (int64_t x, int64_t y)
+{
+  return (static_cast<uint64_t> (static_cast<uint32_t> (x)) << 32) | static_cast<uint32_t> (y);
+}
+
+int64_t
+MobilityNeighborIndex::GetCell (double coordinate) const
+{
+  return static_cast<int64_t> (std::floor (coordinate / m_cellSize));
+}
+
+uint32_t
+MobilityNeighborIndex::Add (Ptr<MobilityModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  NS_ABORT_MSG_IF (m_cellSize <= 0, "CellSize must be positive");
+  NS_ASSERT_MSG (m_indices.find (PeekPointer (model)) == m_indices.end (), "Node indexed twice");
+  uint32_t index = m_models.size ();
+  m_models.push_back (model);
+  m_indices[PeekPointer (model)] = index;
+  Entry entry;
+  entry.position = model->GetPosition ();
+  entry.cell = 0;
+  entry.slot = NO_SLOT;
+  entry.exactUntil = Simulator::Now ();
+  entry.leaveAt = Simulator::Now ();
+  // let the next refresh find out whether the node moves
+  entry.dirty = true;
+  m_entries.push_back (entry);
+  m_dirty = true;
+  Place (index);
+  model->TraceConnectWithoutContext ("CourseChange",
+                                     MakeCallback (&MobilityNeighborIndex::CourseChanged, this));
+  return index;
+}
+
+uint32_t
+MobilityNeighborIndex::GetN (void) const
+{
+  return m_models.size ();
+}
+
+Ptr<MobilityModel>
+MobilityNeighborIndex::GetModel (uint32_t i) const
+{
+  NS_ASSERT (i < GetN ());
+  return m_models[i];
+}
+
+int32_t
+MobilityNeighborIndex::GetIndex (Ptr<const MobilityModel> model) const
+{
+  std::map<const MobilityModel *, uint32_t>::const_iterator it = m_indices.find (PeekPointer (model));
+  if (it == m_indices.end ())
+    {
+      return -1;
+    }
+  return it->second;
+}
+
+void
+MobilityNeighborIndex::Place (uint32_t i)
+{
+  Entry &entry = m_entries[i];
+  int64_t x = GetCell (entry.position.x);
+  int64_t y = GetCell (entry.position.y);
+  uint64_t key = GetCellKey (x, y);
+  if (entry.slot != NO_SLOT)
+    {
+      if (key == entry.cell)
+        {
+          return;
+        }
+      // move the last node of the old cell into the freed slot
+      std::map<uint64_t, std::vector<uint32_t> >::iterator old = m_cells.find (entry.cell);
+      std::vector<uint32_t> &nodes = old->second;
+      nodes[entry.slot] = nodes.back ();
+      nodes.pop_back ();
+      if (entry.slot < nodes.size ())
+        {
+          m_entries[nodes[entry.slot]].slot = entry.slot;
+        }
+      if (nodes.empty ())
+        {
+          m_cells.erase (old);
+        }
+    }
+  std::vector<uint32_t> &nodes = m_cells[key];
+  entry.cell = key;
+  entry.slot = nodes.size ();
+  nodes.push_back (i);
+  m_minX = std::min (m_minX, x);
+  m_maxX = std::max (m_maxX, x);
+  m_minY = std::min (m_minY, y);
+  m_maxY = std::max (m_maxY, y);
+}
+
+void
+MobilityNeighborIndex::Refresh (void)
+{
+  Time now = Simulator::Now ();
+  bool newTime = now != m_lastRefresh;
+  if (!newTime && !m_dirty)
+    {
+      return;
+    }
+  m_stale.clear ();
+  m_staleModels.clear ();
+  for (uint32_t i = 0; i < m_entries.size (); i++)
+    {
+      Entry &entry = m_entries[i];
+      if (entry.dirty || (newTime && now >= entry.leaveAt))
+        {
+          // a course change notified during the evaluation marks the node again
+          entry.dirty = false;
+          m_stale.push_back (i);
+          m_staleModels.push_back (m_models[i]);
+        }
+    }
+  m_lastRefresh = now;
+  m_dirty = false;
+  NS_LOG_LOGIC ("Refreshing " << m_stale.size () << " of " << m_entries.size () << " nodes");
+  if (m_stale.empty ())
+    {
+      return;
+    }
+  m_stalePositions.resize (m_stale.size ());
+  m_staleVelocities.resize (m_stale.size ());
+  MobilityModel::GetPositions (&m_staleModels[0], m_staleModels.size (),
+                               &m_stalePositions[0], &m_staleVelocities[0]);
+  for (uint32_t k = 0; k < m_stale.size (); k++)
+    {
+      uint32_t i = m_stale[k];
+      Entry &entry = m_entries[i];
+      entry.position = m_stalePositions[k];
+      Place (i);
+      entry.leaveAt = GetLeaveTime (i, m_staleVelocities[k]);
+      entry.exactUntil = now;
+      const Vector &velocity = m_staleVelocities[k];
+      if (velocity.x == 0 && velocity.y == 0 && velocity.z == 0 && entry.leaveAt > now)
+        {
+          // a node standing still keeps its position as long as its cell
+          entry.exactUntil = entry.leaveAt;
+        }
+    }
+  m_staleModels.clear ();
+}
+
+Time
+MobilityNeighborIndex::GetLeaveTime (uint32_t i, const Vector &velocity) const
+{
+  Time now = Simulator::Now ();
+  TrajectorySegment segment = m_models[i]->GetCurrentSegment ();
+  if (segment.GetType () == TrajectorySegment::CONSTANT_POSITION)
+    {
+      return segment.GetEnd ();
+    }
+  // horizontal distance to the border of the cell
+  const Vector &p = m_entries[i].position;
+  double x = p.x - GetCell (p.x) * m_cellSize;
+  double y = p.y - GetCell (p.y) * m_cellSize;
+  double distance = std::min (std::min (x, m_cellSize - x), std::min (y, m_cellSize - y));
+  double speed = std::sqrt (velocity.x * velocity.x + velocity.y * velocity.y);
+  double delay;
+  switch (segment.GetType ())
+    {
+    case TrajectorySegment::CONSTANT_VELOCITY:
+      delay = distance / speed;
+      break;
+    case TrajectorySegment::CIRCULAR_ARC:
+      delay = distance / (std::abs (segment.GetAngularRate ()) * segment.GetRadius ());
+      break;
+    case TrajectorySegment::CONSTANT_ACCELERATION:
+      {
+        // solve speed t + acceleration t^2 / 2 = distance
+        Vector a = segment.GetAcceleration ();
+        double acceleration = std::sqrt (a.x * a.x + a.y * a.y);
+        delay = acceleration > 0
+          ? (std::sqrt (speed * speed + 2 * acceleration * distance) - speed) / acceleration
+          : distance / speed;
+        break;
+      }
+    default:
+      return now;
+    }
+  if (!(delay < (segment.GetEnd () - now).GetSeconds ()))
+    {
+      // also covers the nodes not moving horizontally
+      return segment.GetEnd ();
+    }
+  return now + Seconds (delay);
+}
+
+const Vector &
+MobilityNeighborIndex::GetPosition (uint32_t i)
+{
+  Entry &entry = m_entries[i];
+  Time now = Simulator::Now ();
+  if (now > entry.exactUntil)
+    {
+      // still in its cell, but moved since it was last evaluated
+      entry.position = m_models[i]->GetPosition ();
+      entry.exactUntil = now;
+    }
+  return entry.position;
+}
+
+double
+MobilityNeighborIndex::GetDistanceSquared (uint32_t i, const Vector &position)
+{
+  const Vector &p = GetPosition (i);
+  double dx = p.x - position.x;
+  double dy = p.y - position.y;
+  double dz = p.z - position.z;
+  return dx * dx + dy * dy + dz * dz;
+}
+
+void
+MobilityNeighborIndex::CollectCell (int64_t x, int64_t y, const Vector &position, double radius,
+                                    std::vector<uint32_t> &neighbors)
+{
+  std::map<uint64_t, std::vector<uint32_t> >::const_iterator cell = m_cells.find (GetCellKey (x, y));
+  if (cell == m_cells.end ())
+    {
+      return;
+    }
+  double radiusSquared = radius * radius;
+  for (std::vector<uint32_t>::const_iterator i = cell->second.begin (); i != cell->second.end (); ++i)
+    {
+      if (GetDistanceSquared (*i, position) <= radiusSquared)
+        {
+          neighbors.push_back (*i);
+        }
+    }
+}
+
+void
+MobilityNeighborIndex::GetNeighbors (const Vector &position, double radius, std::vector<uint32_t> &neighbors)
+{
+  NS_LOG_FUNCTION (this << position << radius);
+  Refresh ();
+  neighbors.clear ();
+  // no node ever lived outside the cells seen so far
+  int64_t xMin = std::max (GetCell (position.x - radius), m_minX);
+  int64_t xMax = std::min (GetCell (position.x + radius), m_maxX);
+  int64_t yMin = std::max (GetCell (position.y - radius), m_minY);
+  int64_t yMax = std::min (GetCell (position.y + radius), m_maxY);
+  for (int64_t x = xMin; x <= xMax; x++)
+    {
+      for (int64_t y = yMin; y <= yMax; y++)
+        {
+          CollectCell (x, y, position, radius, neighbors);
+        }
+    }
+}
+
+void
+MobilityNeighborIndex::GetNeighbors (uint32_t i, double radius, std::vector<uint32_t> &neighbors)
+{
+  NS_LOG_FUNCTION (this << i << radius);
+  NS_ASSERT (i < GetN ());
+  Refresh ();
+  GetNeighbors (GetPosition (i), radius, neighbors);
+  std::vector<uint32_t>::iterator self = std::find (neighbors.begin (), neighbors.end (), i);
+  if (self != neighbors.end ())
+    {
+      *self = neighbors.back ();
+      neighbors.pop_back ();
+    }
+}
+
+void
+MobilityNeighborIndex::GetNearest (const Vector &position, uint32_t k, std::vector<uint32_t> &nearest)
+{
+  NS_LOG_FUNCTION (this << position << k);
+  Refresh ();
+  nearest.clear ();
+  k = std::min (k, GetN ());
+  if (k == 0)
+    {
+      return;
+    }
+  int64_t cx = GetCell (position.x);
+  int64_t cy = GetCell (position.y);
+  int64_t lastRing = std::max (std::max (cx - m_minX, m_maxX - cx),
+                               std::max (cy - m_minY, m_maxY - cy));
+  std::vector<std::pair<double, uint32_t> > candidates;
+  std::vector<uint32_t> cell;
+  double infinity = std::numeric_limits<double>::infinity ();
+  for (int64_t ring = 0; ring <= lastRing; ring++)
+    {
+      // visit the border of the (2 ring + 1) wide square of cells, within
+      // the cells ever used
+      int64_t xMin = std::max (cx - ring, m_minX);
+      int64_t xMax = std::min (cx + ring, m_maxX);
+      int64_t yMin = std::max (cy - ring, m_minY);
+      int64_t yMax = std::min (cy + ring, m_maxY);
+      for (int64_t x = xMin; x <= xMax; x++)
+        {
+          bool side = x == cx - ring || x == cx + ring;
+          for (int64_t y = yMin; y <= yMax; y++)
+            {
+              if (!side && y != cy - ring && y != cy + ring)
+                {
+                  // jump over the inside of the square
+                  y = std::max (y, cy + ring - 1);
+                  continue;
+                }
+              cell.clear ();
+              CollectCell (x, y, position, infinity, cell);
+              for (std::vector<uint32_t>::const_iterator i = cell.begin (); i != cell.end (); ++i)
+                {
+                  candidates.push_back (std::make_pair (GetDistanceSquared (*i, position), *i));
+                }
+            }
+        }
+      if (candidates.size () < k)
+        {
+          continue;
+        }
+      // the cells left are at least as far as the border of the square
+      double border = std::min (std::min (position.x - (cx - ring) * m_cellSize,
+                                          (cx + ring + 1) * m_cellSize - position.x),
+                                std::min (position.y - (cy - ring) * m_cellSize,
+                                          (cy + ring + 1) * m_cellSize - position.y));
+      std::nth_element (candidates.begin (), candidates.begin () + (k - 1), candidates.end ());
+      if (candidates[k - 1].first <= border * border)
+        {
+          break;
+        }
+    }
+  std::partial_sort (candidates.begin (), candidates.begin () + k, candidates.end ());
+  for (uint32_t i = 0; i < k; i++)
+    {
+      nearest.push_back (candidates[i].second);
+    }
+}
+
+void
+MobilityNeighborIndex::CourseChanged (Ptr<const MobilityModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  std::map<const MobilityModel *, uint32_t>::const_iterator it = m_indices.find (PeekPointer (model));
+  NS_ASSERT (it != m_indices.end ());
+  m_entries[it->second].dirty = true;
+  m_dirty = true;
+}
+
+} // namespace ns3
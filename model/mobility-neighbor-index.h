@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MOBILITY_NEIGHBOR_INDEX_H
+#define MOBILITY_NEIGHBOR_INDEX_H
+
+#include <map>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "mobility-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Answer "which nodes are near this point" without scanning every node.
+ *
+ * The nodes are bucketed by their horizontal position into a uniform grid
+ * of CellSize wide square cells.  A radius query only looks at the cells
+ * overlapping the disk, and a k-nearest query at the rings of cells around
+ * the query point until no unvisited cell can hold a nearer node.  Distances
+ * are three-dimensional, like MobilityModel::GetDistanceFrom.  Pick a
+ * CellSize close to the usual query radius.
+ *
+ * The grid is refreshed lazily by the first query of each simulation time:
+ *  - a node which notified a course change since the last refresh is
+ *    evaluated again,
+ *  - a node whose MobilityModel::GetCurrentSegment is a constant position
+ *    is not evaluated again before the end of that segment,
+ *  - a node flying a segment of known speed is not evaluated again before
+ *    it can reach the border of its cell, or before the end of the segment,
+ *  - every other node is evaluated again, in one MobilityModel::GetPositions
+ *    pass, and only changes cell when it crossed a cell border.
+ *
+ * The nodes which stay in their cell are only evaluated when a query visits
+ * their cell.  All the queries made at the same simulation time, e.g. the
+ * receivers of a broadcast round, share one refresh.
+ */
+class MobilityNeighborIndex : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  MobilityNeighborIndex ();
+  virtual ~MobilityNeighborIndex ();
+
+  /**
+   * Index a node.
+   * \param model the mobility model of the node
+   * \return the index of the node
+   */
+  uint32_t Add (Ptr<MobilityModel> model);
+  /**
+   * \return the number of nodes indexed
+   */
+  uint32_t GetN (void) const;
+  /**
+   * \param i the index of a node
+   * \return the mobility model of the node
+   */
+  Ptr<MobilityModel> GetModel (uint32_t i) const;
+  /**
+   * \param model the mobility model of a node
+   * \return the index of the node, or -1 if it is not indexed
+   */
+  int32_t GetIndex (Ptr<const MobilityModel> model) const;
+
+  /**
+   * Find the nodes within a distance of a position.
+   * \param position the center of the query
+   * \param radius the distance, in meters
+   * \param neighbors cleared and filled with the indices of the nodes, in no
+   * particular order
+   */
+  void GetNeighbors (const Vector &position, double radius, std::vector<uint32_t> &neighbors);
+  /**
+   * Find the nodes within a distance of an indexed node, itself excluded.
+   * \param i the index of the node
+   * \param radius the distance, in meters
+   * \param neighbors cleared and filled with the indices of the nodes, in no
+   * particular order
+   */
+  void GetNeighbors (uint32_t i, double radius, std::vector<uint32_t> &neighbors);
+  /**
+   * Find the nodes nearest to a position.
+   * \param position the center of the query
+   * \param k the number of nodes to find
+   * \param nearest cleared and filled with the indices of the min (k, GetN ())
+   * nearest nodes, nearest first
+   */
+  void GetNearest (const Vector &position, uint32_t k, std::vector<uint32_t> &nearest);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \param cellSize the width of the cells, set before the first node is indexed
+   */
+  void SetCellSize (double cellSize);
+  /**
+   * \return the width of the cells
+   */
+  double GetCellSize (void) const;
+  /**
+   * \param x the x coordinate of a cell
+   * \param y the y coordinate of a cell
+   * \return the key of the cell in m_cells
+   */
+  static uint64_t GetCellKey (int64_t x, int64_t y);
+  /**
+   * \param coordinate a position coordinate
+   * \return the coordinate of the cell holding it
+   */
+  int64_t GetCell (double coordinate) const;
+  /**
+   * Move a node to the cell of its current position.
+   * \param i the index of the node
+   */
+  void Place (uint32_t i);
+  /**
+   * Bring the cells of the nodes up to date with the current time.
+   */
+  void Refresh (void);
+  /**
+   * \param i the index of a node
+   * \param velocity the velocity of the node now
+   * \return the earliest time at which the node may leave its cell
+   */
+  Time GetLeaveTime (uint32_t i, const Vector &velocity) const;
+  /**
+   * \param i the index of a node
+   * \return the position of the node now
+   */
+  const Vector &GetPosition (uint32_t i);
+  /**
+   * Visit the nodes of a cell.
+   * \param x the x coordinate of the cell
+   * \param y the y coordinate of the cell
+   * \param position the center of the query
+   * \param radius the distance, in meters
+   * \param neighbors receives the indices of the nodes within radius
+   */
+  void CollectCell (int64_t x, int64_t y, const Vector &position, double radius,
+                    std::vector<uint32_t> &neighbors);
+  /**
+   * \param i the index of a node
+   * \param position a position
+   * \return the squared distance between the node and the position
+   */
+  double GetDistanceSquared (uint32_t i, const Vector &position);
+  /**
+   * CourseChange trace sink of the nodes.
+   * \param model the node whose course changed
+   */
+  void CourseChanged (Ptr<const MobilityModel> model);
+
+  /// Grid entry of a node
+  struct Entry
+  {
+    Vector position; //!< position at the last evaluation
+    uint64_t cell; //!< key of the cell holding the node
+    uint32_t slot; //!< index of the node in the list of its cell
+    Time exactUntil; //!< position is known to hold until then
+    Time leaveAt; //!< the node is known to stay in its cell until then
+    bool dirty; //!< a course change was notified since the last refresh
+  };
+
+  double m_cellSize; //!< width of the cells of the grid
+  std::vector<Ptr<MobilityModel> > m_models; //!< nodes indexed
+  std::vector<Entry> m_entries; //!< grid entry of each node
+  std::map<const MobilityModel *, uint32_t> m_indices; //!< index of each node
+  std::map<uint64_t, std::vector<uint32_t> > m_cells; //!< nodes of each non empty cell
+  int64_t m_minX; //!< smallest x cell coordinate ever used
+  int64_t m_maxX; //!< largest x cell coordinate ever used
+  int64_t m_minY; //!< smallest y cell coordinate ever used
+  int64_t m_maxY; //!< largest y cell coordinate ever used
+  Time m_lastRefresh; //!< time of the last refresh
+  bool m_dirty; //!< a course change was notified since the last refresh
+  std::vector<uint32_t> m_stale; //!< scratch list of the nodes to evaluate
+  std::vector<Ptr<MobilityModel> > m_staleModels; //!< scratch list of their models
+  std::vector<Vector> m_stalePositions; //!< scratch list of their positions
+  std::vector<Vector> m_staleVelocities; //!< scratch list of their velocities
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_NEIGHBOR_INDEX_H */
@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "mobility-snapshot.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MobilitySnapshot");
+
+NS_OBJECT_ENSURE_REGISTERED (MobilitySnapshot);
+
+uint64_t MobilitySnapshot::g_epochs = 0;
+
+TypeId
+MobilitySnapshot::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MobilitySnapshot")
+    .SetParent<Object> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<MobilitySnapshot> ()
+  ;
+  return tid;
+}
+
+MobilitySnapshot::MobilitySnapshot ()
+  : m_epoch (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MobilitySnapshot::~MobilitySnapshot ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+Ptr<const MobilitySnapshot>
+MobilitySnapshot::Take (const std::vector<Ptr<MobilityModel> > &models)
+{
+  NS_LOG_FUNCTION (models.size ());
+  Ptr<MobilitySnapshot> snapshot = CreateObject<MobilitySnapshot> ();
+  snapshot->m_epoch = g_epochs++;
+  snapshot->m_time = Simulator::Now ();
+  snapshot->m_kinematics.Take (models);
+  for (uint32_t i = 0; i < models.size (); i++)
+    {
+      snapshot->m_indices[PeekPointer (models[i])] = i;
+    }
+  NS_ASSERT_MSG (snapshot->m_indices.size () == models.size (), "Node added twice");
+  return snapshot;
+}
+
+uint64_t
+MobilitySnapshot::GetEpoch (void) const
+{
+  return m_epoch;
+}
+
+Time
+MobilitySnapshot::GetTime (void) const
+{
+  return m_time;
+}
+
+uint32_t
+MobilitySnapshot::GetN (void) const
+{
+  return m_kinematics.GetN ();
+}
+
+int32_t
+MobilitySnapshot::GetIndex (const MobilityModel *model) const
+{
+  std::map<const MobilityModel *, uint32_t>::const_iterator it = m_indices.find (model);
+  if (it == m_indices.end ())
+    {
+      return -1;
+    }
+  return it->second;
+}
+
+Vector
+MobilitySnapshot::GetPosition (uint32_t i) const
+{
+  return m_kinematics.GetPosition (i);
+}
+
+Vector
+MobilitySnapshot::GetVelocity (uint32_t i) const
+{
+  return m_kinematics.GetVelocity (i);
+}
+
+double
+MobilitySnapshot::GetDistance (uint32_t i, uint32_t j) const
+{
+  return CalculateDistance (m_kinematics.GetPosition (i), m_kinematics.GetPosition (j));
+}
+
+const KinematicSnapshot &
+MobilitySnapshot::GetKinematics (void) const
+{
+  return m_kinematics;
+}
+
+} // namespace ns3
@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MOBILITY_SNAPSHOT_H
+#define MOBILITY_SNAPSHOT_H
+
+#include <map>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "mobility-model.h"
+#include "pairwise-kinematics.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Immutable positions and velocities of a set of nodes at one time,
+ * readable from any thread.
+ *
+ * MobilityModel::GetPosition is not thread safe: most models bring their
+ * state up to date inside the const getters.  A snapshot evaluates the
+ * models once, on the simulator thread, and is never modified afterwards,
+ * so any number of worker threads can then read it without locking, e.g.
+ * to compute the propagation loss of a large set of receivers.
+ *
+ * Every snapshot gets the next epoch number, so that data derived from a
+ * snapshot can be checked against the current one.
+ *
+ * Hand the workers a reference or a raw pointer to the snapshot and keep
+ * the Ptr on the simulator thread: the reference count of ns-3 objects is
+ * not atomic.  For the same reason, the nodes are looked up by raw
+ * MobilityModel pointer.
+ */
+class MobilitySnapshot : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  MobilitySnapshot ();
+  virtual ~MobilitySnapshot ();
+
+  /**
+   * Evaluate a set of nodes at the current time.  Only call this on the
+   * simulator thread.
+   * \param models the mobility models of the nodes
+   * \return the snapshot, node i being models[i]
+   */
+  static Ptr<const MobilitySnapshot> Take (const std::vector<Ptr<MobilityModel> > &models);
+
+  /**
+   * \return the number of snapshots taken before this one
+   */
+  uint64_t GetEpoch (void) const;
+  /**
+   * \return the simulation time of the snapshot
+   */
+  Time GetTime (void) const;
+  /**
+   * \return the number of nodes
+   */
+  uint32_t GetN (void) const;
+  /**
+   * \param model the mobility model of a node
+   * \return the index of the node, or -1 if it is not in the snapshot
+   */
+  int32_t GetIndex (const MobilityModel *model) const;
+  /**
+   * \param i the index of a node
+   * \return the position of the node
+   */
+  Vector GetPosition (uint32_t i) const;
+  /**
+   * \param i the index of a node
+   * \return the velocity of the node
+   */
+  Vector GetVelocity (uint32_t i) const;
+  /**
+   * \param i the index of a node
+   * \param j the index of another node
+   * \return the distance between the two nodes
+   */
+  double GetDistance (uint32_t i, uint32_t j) const;
+  /**
+   * \return the coordinates of the nodes, e.g. for PairwiseKinematics
+   */
+  const KinematicSnapshot & GetKinematics (void) const;
+
+private:
+  static uint64_t g_epochs; //!< number of snapshots taken
+
+  uint64_t m_epoch; //!< epoch of the snapshot
+  Time m_time; //!< simulation time of the snapshot
+  KinematicSnapshot m_kinematics; //!< positions and velocities
+  std::map<const MobilityModel *, uint32_t> m_indices; //!< index of each node
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_SNAPSHOT_H */
@@ -0,0 +1,222 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <chrono>
+#include <vector>
+#include "ns3/simulator.h"
+#include "mobility-stats.h"
+
+namespace ns3 {
+
+/// Counts and times of one model type
+struct MobilityStatsEntry
+{
+  TypeId tid; //!< the model type
+  bool used; //!< true once something was counted
+  uint64_t count[MobilityStats::COUNTER_COUNT]; //!< operations counted
+  int64_t nanoseconds[MobilityStats::COUNTER_COUNT]; //!< wall time of the operations
+};
+
+/**
+ * \return the entries, indexed by TypeId uid
+ */
+static std::vector<MobilityStatsEntry> &
+GetEntries (void)
+{
+  static std::vector<MobilityStatsEntry> entries;
+  return entries;
+}
+
+/// TypeId uid of the innermost scope, 0 outside any
+static uint16_t g_currentUid = 0;
+/// Kind of operation of the innermost scope
+static MobilityStats::Counter g_currentCounter = MobilityStats::COUNTER_COUNT;
+
+/**
+ * \param uid a TypeId uid
+ * \return the entry of the type, created if needed
+ */
+static MobilityStatsEntry &
+GetEntry (uint16_t uid)
+{
+  std::vector<MobilityStatsEntry> &entries = GetEntries ();
+  if (uid >= entries.size ())
+    {
+      MobilityStatsEntry entry = MobilityStatsEntry ();
+      entries.resize (uid + 1, entry);
+    }
+  return entries[uid];
+}
+
+/**
+ * \return the wall clock, in nanoseconds
+ */
+static int64_t
+GetWallClock (void)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds> (
+    std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+MobilityStats::Scope::Scope (const ObjectBase *object, Counter counter)
+  : m_counter (counter),
+    m_count (1)
+{
+  TypeId tid = object->GetInstanceTypeId ();
+  m_uid = tid.GetUid ();
+  MobilityStatsEntry &entry = GetEntry (m_uid);
+  entry.tid = tid;
+  Enter ();
+}
+
+MobilityStats::Scope::Scope (Counter counter)
+  : m_uid (g_currentUid),
+    m_counter (counter),
+    m_count (1)
+{
+  Enter ();
+}
+
+void
+MobilityStats::Scope::Enter (void)
+{
+  m_outer = g_currentUid;
+  m_outerCounter = g_currentCounter;
+  m_nested = m_outer == m_uid && m_outerCounter == m_counter;
+  g_currentUid = m_uid;
+  g_currentCounter = m_counter;
+  m_start = GetWallClock ();
+}
+
+void
+MobilityStats::Scope::SetCount (uint64_t count)
+{
+  m_count = count;
+}
+
+MobilityStats::Scope::~Scope ()
+{
+  g_currentUid = m_outer;
+  g_currentCounter = m_outerCounter;
+  if (m_nested)
+    {
+      return;
+    }
+  // uid 0 gathers the helpers used outside any model scope
+  MobilityStatsEntry &entry = GetEntry (m_uid);
+  entry.used = true;
+  entry.count[m_counter] += m_count;
+  entry.nanoseconds[m_counter] += GetWallClock () - m_start;
+}
+
+bool
+MobilityStats::IsEnabled (void)
+{
+#ifdef NS3_MOBILITY_STATS
+  return true;
+#else
+  return false;
+#endif
+}
+
+void
+MobilityStats::Count (const ObjectBase *object, Counter counter)
+{
+  TypeId tid = object->GetInstanceTypeId ();
+  MobilityStatsEntry &entry = GetEntry (tid.GetUid ());
+  entry.tid = tid;
+  entry.used = true;
+  entry.count[counter]++;
+}
+
+uint64_t
+MobilityStats::GetCount (TypeId tid, Counter counter)
+{
+  std::vector<MobilityStatsEntry> &entries = GetEntries ();
+  return tid.GetUid () < entries.size () ? entries[tid.GetUid ()].count[counter] : 0;
+}
+
+double
+MobilityStats::GetSeconds (TypeId tid, Counter counter)
+{
+  std::vector<MobilityStatsEntry> &entries = GetEntries ();
+  return tid.GetUid () < entries.size () ? entries[tid.GetUid ()].nanoseconds[counter] * 1e-9 : 0.0;
+}
+
+const char *
+MobilityStats::GetCounterName (Counter counter)
+{
+  switch (counter)
+    {
+    case SCHEDULE:
+      return "schedule";
+    case GET_POSITION:
+      return "position";
+    case GET_VELOCITY:
+      return "velocity";
+    case UPDATE:
+      return "update";
+    case COURSE_CHANGE:
+      return "courseChange";
+    default:
+      return "";
+    }
+}
+
+void
+MobilityStats::Print (std::ostream &os)
+{
+  std::vector<MobilityStatsEntry> &entries = GetEntries ();
+  os << "time=" << Simulator::Now ().GetSeconds () << "s" << std::endl;
+  for (uint32_t uid = 0; uid < entries.size (); uid++)
+    {
+      if (!entries[uid].used)
+        {
+          continue;
+        }
+      os << (uid == 0 ? std::string ("(no model)") : entries[uid].tid.GetName ());
+      for (uint32_t c = 0; c < COUNTER_COUNT; c++)
+        {
+          os << " " << GetCounterName (Counter (c)) << "=" << entries[uid].count[c];
+          if (c != SCHEDULE)
+            {
+              os << "/" << entries[uid].nanoseconds[c] * 1e-9 << "s";
+            }
+        }
+      os << std::endl;
+    }
+}
+
+void
+MobilityStats::EnablePeriodicPrint (Time interval, std::ostream *os)
+{
+  Simulator::Schedule (interval, &MobilityStats::PeriodicPrint, interval, os);
+}
+
+void
+MobilityStats::PeriodicPrint (Time interval, std::ostream *os)
+{
+  Print (*os);
+  Simulator::Schedule (interval, &MobilityStats::PeriodicPrint, interval, os);
+}
+
+void
+MobilityStats::Reset (void)
+{
+  GetEntries ().clear ();
+}
+
+} // namespace ns3
@@ -0,0 +1,208 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MOBILITY_STATS_H
+#define MOBILITY_STATS_H
+
+#include <stdint.h>
+#include <ostream>
+#include "ns3/object-base.h"
+#include "ns3/type-id.h"
+#include "ns3/nstime.h"
+
+/**
+ * \ingroup mobility
+ * Count an operation of an object, e.g. MOBILITY_STATS_COUNT (this, SCHEDULE).
+ * Compiled out unless NS3_MOBILITY_STATS is defined.
+ */
+#ifdef NS3_MOBILITY_STATS
+#define MOBILITY_STATS_COUNT(object, counter) \
+  ns3::MobilityStats::Count (object, ns3::MobilityStats::counter)
+#else
+#define MOBILITY_STATS_COUNT(object, counter)
+#endif
+
+/**
+ * \ingroup mobility
+ * Count and time an operation of an object until the end of the enclosing
+ * block, e.g. MOBILITY_STATS_SCOPE (this, GET_POSITION).
+ * Compiled out unless NS3_MOBILITY_STATS is defined.
+ */
+#ifdef NS3_MOBILITY_STATS
+#define MOBILITY_STATS_SCOPE(object, counter) \
+  ns3::MobilityStats::Scope mobilityStatsScope (object, ns3::MobilityStats::counter)
+#else
+#define MOBILITY_STATS_SCOPE(object, counter)
+#endif
+
+/**
+ * \ingroup mobility
+ * Count and time an operation of a helper until the end of the enclosing
+ * block, on behalf of the object of the innermost enclosing
+ * MOBILITY_STATS_SCOPE.  Compiled out unless NS3_MOBILITY_STATS is defined.
+ */
+#ifdef NS3_MOBILITY_STATS
+#define MOBILITY_STATS_HELPER_SCOPE(counter) \
+  ns3::MobilityStats::Scope mobilityStatsScope (ns3::MobilityStats::counter)
+#else
+#define MOBILITY_STATS_HELPER_SCOPE(counter)
+#endif
+
+/**
+ * \ingroup mobility
+ * Count the innermost MOBILITY_STATS_SCOPE as that many operations instead
+ * of one, e.g. for a bulk query.  Compiled out unless NS3_MOBILITY_STATS is
+ * defined.
+ */
+#ifdef NS3_MOBILITY_STATS
+#define MOBILITY_STATS_SET_COUNT(count) \
+  mobilityStatsScope.SetCount (count)
+#else
+#define MOBILITY_STATS_SET_COUNT(count)
+#endif
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Count and time the work of the mobility models, per model type.
+ *
+ * Configure with --enable-mobility-stats, which defines
+ * NS3_MOBILITY_STATS, to count for each TypeId:
+ *  - SCHEDULE: the events scheduled,
+ *  - GET_POSITION: the DoGetPosition calls, not answered by the cache,
+ *    and the models evaluated by MobilityModel::GetPositions, velocities
+ *    included; analytic models evaluated in place are counted, not timed,
+ *  - GET_VELOCITY: the DoGetVelocity calls, not answered by the cache,
+ *  - UPDATE: the scheduled handlers and setters of the models, and the
+ *    Update calls of the velocity helpers outside them, counted for the
+ *    model whose state was being updated or queried,
+ *  - COURSE_CHANGE: the course change notifications.
+ *
+ * The wall time of the last four, sinks of the course changes included,
+ * is accumulated too.  An operation nested in another of the same kind
+ * for the same model type is neither counted nor timed again.  Times are
+ * otherwise inclusive: the position query of a hierarchical model includes
+ * those of its children.  Without
+ * NS3_MOBILITY_STATS the instrumentation macros expand to nothing and the
+ * counters stay at zero.
+ */
+class MobilityStats
+{
+public:
+  /// Kind of operation
+  enum Counter
+  {
+    SCHEDULE,
+    GET_POSITION,
+    GET_VELOCITY,
+    UPDATE,
+    COURSE_CHANGE,
+    COUNTER_COUNT
+  };
+
+  /**
+   * Times an operation until destroyed.
+   */
+  class Scope
+  {
+public:
+    /**
+     * \param object the object doing the operation
+     * \param counter the kind of operation
+     */
+    Scope (const ObjectBase *object, Counter counter);
+    /**
+     * \param counter the kind of operation, done on behalf of the object of
+     * the enclosing scope
+     */
+    Scope (Counter counter);
+    ~Scope ();
+    /**
+     * \param count the number of operations to count when destroyed
+     */
+    void SetCount (uint64_t count);
+
+private:
+    /**
+     * Enter the scope.
+     */
+    void Enter (void);
+
+    uint16_t m_uid; //!< TypeId uid of the object
+    uint16_t m_outer; //!< TypeId uid of the enclosing scope
+    Counter m_counter; //!< kind of operation
+    Counter m_outerCounter; //!< kind of operation of the enclosing scope
+    bool m_nested; //!< true inside a scope of the same uid and kind
+    uint64_t m_count; //!< operations to count
+    int64_t m_start; //!< wall clock at the start, in nanoseconds
+  };
+
+  /**
+   * \return true if the module was compiled with NS3_MOBILITY_STATS
+   */
+  static bool IsEnabled (void);
+  /**
+   * Count an operation, without timing it.
+   * \param object the object doing the operation
+   * \param counter the kind of operation
+   */
+  static void Count (const ObjectBase *object, Counter counter);
+  /**
+   * \param tid a model type
+   * \param counter a kind of operation
+   * \return the number of operations counted
+   */
+  static uint64_t GetCount (TypeId tid, Counter counter);
+  /**
+   * \param tid a model type
+   * \param counter a kind of operation
+   * \return the wall time spent in the operations, in seconds
+   */
+  static double GetSeconds (TypeId tid, Counter counter);
+  /**
+   * Print one line per model type with the counts and times.
+   * \param os the output stream
+   */
+  static void Print (std::ostream &os);
+  /**
+   * Print the counts and times every interval of simulation time.  This
+   * keeps scheduling events: end the simulation with Simulator::Stop.
+   * \param interval the period
+   * \param os the output stream, which must outlive the simulation
+   */
+  static void EnablePeriodicPrint (Time interval, std::ostream *os);
+  /**
+   * Set every counter back to zero.
+   */
+  static void Reset (void);
+
+private:
+  /**
+   * Print, then print again after an interval.
+   * \param interval the period
+   * \param os the output stream
+   */
+  static void PeriodicPrint (Time interval, std::ostream *os);
+  /**
+   * \param counter a kind of operation
+   * \return the name of the operation
+   */
+  static const char * GetCounterName (Counter counter);
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_STATS_H */
@@ -0,0 +1,31 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "orbit-shell.h"
+
+namespace ns3 {
+
+double
+GetOrbitShellClimbRate (double z, double baseAltitude, double altitudeStep, int orbit, double duration)
+{
+  if (altitudeStep == 0.0 || duration <= 0.0)
+    {
+      return 0.0;
+    }
+  return (baseAltitude + orbit * altitudeStep - z) / duration;
+}
+
+} // namespace ns3
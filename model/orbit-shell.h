@@ -0,0 +1,41 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef ORBIT_SHELL_H
+#define ORBIT_SHELL_H
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Vertical speed of a radial leg ending on the altitude shell of an orbit.
+ *
+ * With a non zero altitude step, orbit i is flown at altitude
+ * baseAltitude + i*altitudeStep.  The circular motion models climb or
+ * descend along their radial legs at this rate so that the drone levels
+ * off on the shell of the orbit it arrives at.
+ *
+ * \param z the altitude at the start of the leg
+ * \param baseAltitude the altitude of the shell of orbit 0
+ * \param altitudeStep the altitude difference between successive orbits
+ * \param orbit the orbit the leg ends on
+ * \param duration the time the drone moves along the leg, in seconds
+ * \return the climb rate in m/s, 0 for flat orbits or an empty leg
+ */
+double GetOrbitShellClimbRate (double z, double baseAltitude, double altitudeStep, int orbit, double duration);
+
+} // namespace ns3
+
+#endif /* ORBIT_SHELL_H */
@@ -0,0 +1,221 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "orbit-transition-table.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("OrbitTransitionTable");
+
+const uint32_t OrbitTransitionTable::MAX_OUTCOMES;
+
+OrbitTransitionTable::OrbitTransitionTable ()
+  : m_nOrbits (0),
+    m_totalOrbits (0.0),
+    m_flightStep (1.0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+OrbitTransitionTable::Configure (double orbitDistance, double maxRadius)
+{
+  NS_LOG_FUNCTION (this << orbitDistance << maxRadius);
+  NS_ABORT_MSG_IF (orbitDistance <= 0, "InterOrbitDistance must be positive");
+  NS_ABORT_MSG_IF (maxRadius < 0, "MaximumRadius must not be negative");
+  m_totalOrbits = maxRadius / orbitDistance;
+  m_nOrbits = static_cast<uint32_t> (m_totalOrbits);
+  m_flightStep = 1.0 / m_totalOrbits;
+  // thresholds are computed with the very expressions the models used to
+  // evaluate on every switch, so a given draw picks the same orbit
+  int n = m_nOrbits;
+  m_rows.assign (m_nOrbits + 1, Row ());
+  for (uint32_t i = 0; i <= m_nOrbits; i++)
+    {
+      Row &row = m_rows[i];
+      int orbit = i;
+      if (i >= m_totalOrbits - 1)
+        {
+          // outer orbits only move inwards
+          row.size = 3;
+          row.threshold[0] = 0.5 - 1.0 / n;
+          row.offset[0] = -2;
+          row.speedFactor[0] = 2.0;
+          row.threshold[1] = 1 - 1.5 / n;
+          row.offset[1] = -1;
+          row.speedFactor[1] = 1.0;
+        }
+      else if (i < 1.5)
+        {
+          // the first orbit only moves outwards
+          row.size = 2;
+          row.threshold[0] = 0.5;
+          row.offset[0] = 1;
+          row.speedFactor[0] = 1.0;
+        }
+      else
+        {
+          row.size = 3;
+          row.threshold[0] = 0.5;
+          row.offset[0] = 1;
+          row.speedFactor[0] = 1.0;
+          row.threshold[1] = 1 - 0.5 / orbit;
+          row.offset[1] = -1;
+          row.speedFactor[1] = 1.0;
+        }
+      // the last outcome is staying in the orbit and takes the rest of [0, 1]
+      row.threshold[row.size - 1] = 1.0;
+      row.offset[row.size - 1] = 0;
+      row.speedFactor[row.size - 1] = 1.0;
+    }
+}
+
+uint32_t
+OrbitTransitionTable::GetNOrbits (void) const
+{
+  return m_nOrbits;
+}
+
+const OrbitTransitionTable::Row &
+OrbitTransitionTable::GetRow (int orbit) const
+{
+  NS_ASSERT_MSG (!m_rows.empty (), "OrbitTransitionTable used before Configure");
+  // drones outside the patrolled area follow the law of the nearest orbit
+  if (orbit < 0)
+    {
+      return m_rows.front ();
+    }
+  if (static_cast<uint32_t> (orbit) > m_nOrbits)
+    {
+      return m_rows.back ();
+    }
+  return m_rows[orbit];
+}
+
+int
+OrbitTransitionTable::SampleWalk (int orbit, double u, double &speedFactor) const
+{
+  const Row &row = GetRow (orbit);
+  uint32_t k = 0;
+  while (k + 1 < row.size && u > row.threshold[k])
+    {
+      k++;
+    }
+  speedFactor = row.speedFactor[k];
+  return std::max (orbit + row.offset[k], 0);
+}
+
+int
+OrbitTransitionTable::SampleFlight (double u) const
+{
+  int orbit = std::floor (u / m_flightStep) + 1;
+  if (orbit > m_totalOrbits)
+    {
+      orbit -= 1;
+    }
+  return orbit;
+}
+
+double
+OrbitTransitionTable::GetWalkProbability (uint32_t from, uint32_t to) const
+{
+  NS_ASSERT (from <= m_nOrbits && to <= m_nOrbits);
+  const Row &row = m_rows[from];
+  double covered = 0.0;
+  double probability = 0.0;
+  for (uint32_t k = 0; k < row.size; k++)
+    {
+      double upper = std::min (std::max (row.threshold[k], 0.0), 1.0);
+      if (k + 1 == row.size)
+        {
+          upper = 1.0;
+        }
+      int target = std::max (static_cast<int> (from) + row.offset[k], 0);
+      if (static_cast<uint32_t> (target) == to && upper > covered)
+        {
+          probability += upper - covered;
+        }
+      covered = std::max (covered, upper);
+    }
+  return probability;
+}
+
+double
+OrbitTransitionTable::GetFlightProbability (uint32_t to) const
+{
+  NS_ASSERT (to <= m_nOrbits);
+  double probability = 0.0;
+  for (uint32_t j = 1; (j - 1) * m_flightStep < 1.0; j++)
+    {
+      double target = j > m_totalOrbits ? j - 1 : j;
+      if (target == to)
+        {
+          probability += std::min (j * m_flightStep, 1.0) - (j - 1) * m_flightStep;
+        }
+    }
+  return probability;
+}
+
+double
+OrbitTransitionTable::GetTransitionProbability (uint32_t from, uint32_t to, double epsilon) const
+{
+  return epsilon * GetWalkProbability (from, to) + (1 - epsilon) * GetFlightProbability (to);
+}
+
+std::vector<double>
+OrbitTransitionTable::GetStationaryDistribution (double epsilon) const
+{
+  NS_LOG_FUNCTION (this << epsilon);
+  uint32_t size = m_nOrbits + 1;
+  std::vector<double> matrix (size * size);
+  for (uint32_t i = 0; i < size; i++)
+    {
+      for (uint32_t j = 0; j < size; j++)
+        {
+          matrix[i * size + j] = GetTransitionProbability (i, j, epsilon);
+        }
+    }
+  std::vector<double> current (size, 1.0 / size);
+  std::vector<double> next (size);
+  for (uint32_t iteration = 0; iteration < 100000; iteration++)
+    {
+      std::fill (next.begin (), next.end (), 0.0);
+      for (uint32_t i = 0; i < size; i++)
+        {
+          for (uint32_t j = 0; j < size; j++)
+            {
+              next[j] += current[i] * matrix[i * size + j];
+            }
+        }
+      double change = 0.0;
+      for (uint32_t j = 0; j < size; j++)
+        {
+          change += std::fabs (next[j] - current[j]);
+        }
+      current.swap (next);
+      if (change < 1e-14)
+        {
+          break;
+        }
+    }
+  return current;
+}
+
+} // namespace ns3
@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef ORBIT_TRANSITION_TABLE_H
+#define ORBIT_TRANSITION_TABLE_H
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Compiled orbit transition law of the circular surveillance models.
+ *
+ * Orbit i is the circle of radius i * InterOrbitDistance and there are
+ * n = floor (MaximumRadius / InterOrbitDistance) orbits.  When a drone
+ * leaves its orbit it either takes a random walk step or a random flight:
+ *  - random walk from the first orbit (i <= 1): move out with
+ *    probability 1/2, stay otherwise,
+ *  - random walk from a middle orbit: move out with probability 1/2, in
+ *    with probability 1/2 - 1/(2i), stay with probability 1/(2i),
+ *  - random walk from the outer orbits (i >= n - 1): jump two orbits in at
+ *    twice the radial speed with probability 1/2 - 1/n, move one orbit in
+ *    with probability 1/2 - 1/(2n), stay with probability 3/(2n),
+ *  - random flight: move to an orbit drawn uniformly in 1..n.
+ *
+ * Configure compiles the per-orbit cumulative probabilities once, so that
+ * sampling a transition from a uniform draw is a lookup of at most three
+ * thresholds.  The same table gives the transition matrix of the orbit
+ * Markov chain and its stationary distribution, which can be checked
+ * against the orbit occupancy observed in a simulation.
+ */
+class OrbitTransitionTable
+{
+public:
+  OrbitTransitionTable ();
+
+  /**
+   * Compile the transition law.
+   * \param orbitDistance the distance between two successive orbits
+   * \param maxRadius the radius of the outermost orbit
+   */
+  void Configure (double orbitDistance, double maxRadius);
+  /**
+   * \return the number of orbits n; rows of the table cover orbits 0..n
+   */
+  uint32_t GetNOrbits (void) const;
+  /**
+   * Sample a random walk step.
+   * \param orbit the current orbit number
+   * \param u a uniform draw in [0, 1]
+   * \param speedFactor set to the radial speed multiplier of the step
+   * \return the next orbit number
+   */
+  int SampleWalk (int orbit, double u, double &speedFactor) const;
+  /**
+   * Sample a random flight.
+   * \param u a uniform draw in [0, 1]
+   * \return the next orbit number, in 1..n
+   */
+  int SampleFlight (double u) const;
+  /**
+   * \param from the current orbit, in 0..n
+   * \param to the next orbit, in 0..n
+   * \return the probability that a random walk step goes from one to the other
+   */
+  double GetWalkProbability (uint32_t from, uint32_t to) const;
+  /**
+   * \param to the next orbit, in 0..n
+   * \return the probability that a random flight lands on it
+   */
+  double GetFlightProbability (uint32_t to) const;
+  /**
+   * \param from the current orbit, in 0..n
+   * \param to the next orbit, in 0..n
+   * \param epsilon the probability of a random walk decision
+   * \return the probability of going from one orbit to the other at an
+   * orbit decision
+   */
+  double GetTransitionProbability (uint32_t from, uint32_t to, double epsilon) const;
+  /**
+   * Compute the stationary distribution of the orbit chain by power
+   * iteration.  It is the long run fraction of orbit decisions taken on
+   * each orbit.
+   * \param epsilon the probability of a random walk decision
+   * \return one probability per orbit 0..n
+   */
+  std::vector<double> GetStationaryDistribution (double epsilon) const;
+
+private:
+  /// Maximum number of outcomes of a random walk step
+  static const uint32_t MAX_OUTCOMES = 3;
+  /// Random walk law from one orbit
+  struct Row
+  {
+    uint32_t size; //!< number of outcomes
+    double threshold[MAX_OUTCOMES]; //!< cumulative probability, the last outcome catches the rest
+    int offset[MAX_OUTCOMES]; //!< orbit change of each outcome
+    double speedFactor[MAX_OUTCOMES]; //!< radial speed multiplier of each outcome
+  };
+  /**
+   * \param orbit an orbit number
+   * \return the row holding the random walk law of that orbit
+   */
+  const Row & GetRow (int orbit) const;
+
+  uint32_t m_nOrbits; //!< number of orbits
+  double m_totalOrbits; //!< MaximumRadius / InterOrbitDistance, not rounded
+  double m_flightStep; //!< width of the draw interval of each flight target
+  std::vector<Row> m_rows; //!< random walk law of orbits 0..n
+};
+
+} // namespace ns3
+
+#endif /* ORBIT_TRANSITION_TABLE_H */
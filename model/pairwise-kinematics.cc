@@ -0,0 +1,409 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#include "ns3/assert.h"
+#include "mobility-model.h"
+#include "pairwise-kinematics.h"
+
+#if defined (__AVX2__) || defined (__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace ns3 {
+
+KinematicSnapshot::KinematicSnapshot ()
+{
+}
+
+void
+KinematicSnapshot::Take (const std::vector<Ptr<MobilityModel> > &models)
+{
+  Resize (models.size ());
+  if (models.empty ())
+    {
+      return;
+    }
+  std::vector<Vector> positions (models.size ());
+  std::vector<Vector> velocities (models.size ());
+  MobilityModel::GetPositions (&models[0], models.size (), &positions[0], &velocities[0]);
+  for (size_t i = 0; i < models.size (); i++)
+    {
+      Set (i, positions[i], velocities[i]);
+    }
+}
+
+void
+KinematicSnapshot::Resize (size_t n)
+{
+  x.resize (n, 0.0);
+  y.resize (n, 0.0);
+  z.resize (n, 0.0);
+  vx.resize (n, 0.0);
+  vy.resize (n, 0.0);
+  vz.resize (n, 0.0);
+}
+
+size_t
+KinematicSnapshot::GetN (void) const
+{
+  return x.size ();
+}
+
+void
+KinematicSnapshot::Set (size_t i, const Vector &position, const Vector &velocity)
+{
+  NS_ASSERT (i < GetN ());
+  x[i] = position.x;
+  y[i] = position.y;
+  z[i] = position.z;
+  vx[i] = velocity.x;
+  vy[i] = velocity.y;
+  vz[i] = velocity.z;
+}
+
+Vector
+KinematicSnapshot::GetPosition (size_t i) const
+{
+  NS_ASSERT (i < GetN ());
+  return Vector (x[i], y[i], z[i]);
+}
+
+Vector
+KinematicSnapshot::GetVelocity (size_t i) const
+{
+  NS_ASSERT (i < GetN ());
+  return Vector (vx[i], vy[i], vz[i]);
+}
+
+/// Columns per tile: the six coordinate arrays of a tile take 24 KiB
+static const size_t TILE = 512;
+
+/// Coordinate arrays of a snapshot
+struct Columns
+{
+  const double *x; //!< x coordinate of the positions
+  const double *y; //!< y coordinate of the positions
+  const double *z; //!< z coordinate of the positions
+  const double *vx; //!< x coordinate of the velocities
+  const double *vy; //!< y coordinate of the velocities
+  const double *vz; //!< z coordinate of the velocities
+};
+
+/**
+ * \param c the coordinates
+ * \param i a row
+ * \param j a column
+ * \return the squared distance of nodes i and j
+ */
+static inline double
+DistanceSquared (const Columns &c, size_t i, size_t j)
+{
+  double dx = c.x[j] - c.x[i];
+  double dy = c.y[j] - c.y[i];
+  double dz = c.z[j] - c.z[i];
+  return dx * dx + dy * dy + dz * dz;
+}
+
+/**
+ * \param c the coordinates
+ * \param i a row
+ * \param j a column
+ * \return the squared relative speed of nodes i and j
+ */
+static inline double
+SpeedSquared (const Columns &c, size_t i, size_t j)
+{
+  double dx = c.vx[j] - c.vx[i];
+  double dy = c.vy[j] - c.vy[i];
+  double dz = c.vz[j] - c.vz[i];
+  return dx * dx + dy * dy + dz * dz;
+}
+
+#if defined (__AVX2__)
+static const size_t LANES = 4;
+
+static void
+KinematicsLanes (const Columns &c, size_t i, size_t j, double *distance, double *speed)
+{
+  if (distance)
+    {
+      __m256d dx = _mm256_sub_pd (_mm256_loadu_pd (c.x + j), _mm256_set1_pd (c.x[i]));
+      __m256d dy = _mm256_sub_pd (_mm256_loadu_pd (c.y + j), _mm256_set1_pd (c.y[i]));
+      __m256d dz = _mm256_sub_pd (_mm256_loadu_pd (c.z + j), _mm256_set1_pd (c.z[i]));
+      __m256d d2 = _mm256_add_pd (_mm256_add_pd (_mm256_mul_pd (dx, dx), _mm256_mul_pd (dy, dy)),
+                                  _mm256_mul_pd (dz, dz));
+      _mm256_storeu_pd (distance + j, _mm256_sqrt_pd (d2));
+    }
+  if (speed)
+    {
+      __m256d dx = _mm256_sub_pd (_mm256_loadu_pd (c.vx + j), _mm256_set1_pd (c.vx[i]));
+      __m256d dy = _mm256_sub_pd (_mm256_loadu_pd (c.vy + j), _mm256_set1_pd (c.vy[i]));
+      __m256d dz = _mm256_sub_pd (_mm256_loadu_pd (c.vz + j), _mm256_set1_pd (c.vz[i]));
+      __m256d s2 = _mm256_add_pd (_mm256_add_pd (_mm256_mul_pd (dx, dx), _mm256_mul_pd (dy, dy)),
+                                  _mm256_mul_pd (dz, dz));
+      _mm256_storeu_pd (speed + j, _mm256_sqrt_pd (s2));
+    }
+}
+
+static uint64_t
+AdjacencyLanes (const Columns &c, size_t i, size_t j, double range2)
+{
+  __m256d dx = _mm256_sub_pd (_mm256_loadu_pd (c.x + j), _mm256_set1_pd (c.x[i]));
+  __m256d dy = _mm256_sub_pd (_mm256_loadu_pd (c.y + j), _mm256_set1_pd (c.y[i]));
+  __m256d dz = _mm256_sub_pd (_mm256_loadu_pd (c.z + j), _mm256_set1_pd (c.z[i]));
+  __m256d d2 = _mm256_add_pd (_mm256_add_pd (_mm256_mul_pd (dx, dx), _mm256_mul_pd (dy, dy)),
+                              _mm256_mul_pd (dz, dz));
+  return _mm256_movemask_pd (_mm256_cmp_pd (d2, _mm256_set1_pd (range2), _CMP_LE_OQ));
+}
+
+#elif defined (__SSE2__)
+static const size_t LANES = 2;
+
+static void
+KinematicsLanes (const Columns &c, size_t i, size_t j, double *distance, double *speed)
+{
+  if (distance)
+    {
+      __m128d dx = _mm_sub_pd (_mm_loadu_pd (c.x + j), _mm_set1_pd (c.x[i]));
+      __m128d dy = _mm_sub_pd (_mm_loadu_pd (c.y + j), _mm_set1_pd (c.y[i]));
+      __m128d dz = _mm_sub_pd (_mm_loadu_pd (c.z + j), _mm_set1_pd (c.z[i]));
+      __m128d d2 = _mm_add_pd (_mm_add_pd (_mm_mul_pd (dx, dx), _mm_mul_pd (dy, dy)), _mm_mul_pd (dz, dz));
+      _mm_storeu_pd (distance + j, _mm_sqrt_pd (d2));
+    }
+  if (speed)
+    {
+      __m128d dx = _mm_sub_pd (_mm_loadu_pd (c.vx + j), _mm_set1_pd (c.vx[i]));
+      __m128d dy = _mm_sub_pd (_mm_loadu_pd (c.vy + j), _mm_set1_pd (c.vy[i]));
+      __m128d dz = _mm_sub_pd (_mm_loadu_pd (c.vz + j), _mm_set1_pd (c.vz[i]));
+      __m128d s2 = _mm_add_pd (_mm_add_pd (_mm_mul_pd (dx, dx), _mm_mul_pd (dy, dy)), _mm_mul_pd (dz, dz));
+      _mm_storeu_pd (speed + j, _mm_sqrt_pd (s2));
+    }
+}
+
+static uint64_t
+AdjacencyLanes (const Columns &c, size_t i, size_t j, double range2)
+{
+  __m128d dx = _mm_sub_pd (_mm_loadu_pd (c.x + j), _mm_set1_pd (c.x[i]));
+  __m128d dy = _mm_sub_pd (_mm_loadu_pd (c.y + j), _mm_set1_pd (c.y[i]));
+  __m128d dz = _mm_sub_pd (_mm_loadu_pd (c.z + j), _mm_set1_pd (c.z[i]));
+  __m128d d2 = _mm_add_pd (_mm_add_pd (_mm_mul_pd (dx, dx), _mm_mul_pd (dy, dy)), _mm_mul_pd (dz, dz));
+  return _mm_movemask_pd (_mm_cmple_pd (d2, _mm_set1_pd (range2)));
+}
+
+#else
+static const size_t LANES = 1;
+
+static void
+KinematicsLanes (const Columns &c, size_t i, size_t j, double *distance, double *speed)
+{
+  if (distance)
+    {
+      distance[j] = std::sqrt (DistanceSquared (c, i, j));
+    }
+  if (speed)
+    {
+      speed[j] = std::sqrt (SpeedSquared (c, i, j));
+    }
+}
+
+static uint64_t
+AdjacencyLanes (const Columns &c, size_t i, size_t j, double range2)
+{
+  return DistanceSquared (c, i, j) <= range2 ? 1 : 0;
+}
+#endif
+
+/**
+ * Fill rows [begin, end) of the distance and relative speed matrices.
+ * \param c the coordinates
+ * \param n the number of nodes
+ * \param begin the first row
+ * \param end the row after the last one
+ * \param distance the distance matrix, or null
+ * \param speed the relative speed matrix, or null
+ * \param upper if true, only fill the upper triangle
+ */
+static void
+KinematicsRows (Columns c, size_t n, size_t begin, size_t end, double *distance, double *speed, bool upper)
+{
+  for (size_t tile = 0; tile < n; tile += TILE)
+    {
+      size_t tileEnd = std::min (n, tile + TILE);
+      for (size_t i = begin; i < end; i++)
+        {
+          size_t j = upper ? std::max (tile, i + 1) : tile;
+          double *distanceRow = distance ? distance + i * n : 0;
+          double *speedRow = speed ? speed + i * n : 0;
+          for (; j + LANES <= tileEnd; j += LANES)
+            {
+              KinematicsLanes (c, i, j, distanceRow, speedRow);
+            }
+          for (; j < tileEnd; j++)
+            {
+              if (distanceRow)
+                {
+                  distanceRow[j] = std::sqrt (DistanceSquared (c, i, j));
+                }
+              if (speedRow)
+                {
+                  speedRow[j] = std::sqrt (SpeedSquared (c, i, j));
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Fill rows [begin, end) of the adjacency bit matrix.
+ * \param c the coordinates
+ * \param n the number of nodes
+ * \param begin the first row
+ * \param end the row after the last one
+ * \param range2 the squared range
+ * \param adjacency the bit matrix, cleared
+ */
+static void
+AdjacencyRows (Columns c, size_t n, size_t begin, size_t end, double range2, uint64_t *adjacency)
+{
+  size_t words = (n + 63) / 64;
+  // tiles start on a word, and a word holds a whole number of lanes
+  for (size_t tile = 0; tile < n; tile += TILE)
+    {
+      size_t tileEnd = std::min (n, tile + TILE);
+      for (size_t i = begin; i < end; i++)
+        {
+          uint64_t *row = adjacency + i * words;
+          size_t j = tile;
+          for (; j + LANES <= tileEnd; j += LANES)
+            {
+              row[j / 64] |= AdjacencyLanes (c, i, j, range2) << (j % 64);
+            }
+          for (; j < tileEnd; j++)
+            {
+              if (DistanceSquared (c, i, j) <= range2)
+                {
+                  row[j / 64] |= uint64_t (1) << (j % 64);
+                }
+            }
+        }
+    }
+  for (size_t i = begin; i < end; i++)
+    {
+      adjacency[i * words + i / 64] &= ~(uint64_t (1) << (i % 64));
+    }
+}
+
+/**
+ * \param snapshot a snapshot
+ * \return the coordinate arrays of the snapshot
+ */
+static Columns
+GetColumns (const KinematicSnapshot &snapshot)
+{
+  Columns c;
+  c.x = &snapshot.x[0];
+  c.y = &snapshot.y[0];
+  c.z = &snapshot.z[0];
+  c.vx = &snapshot.vx[0];
+  c.vy = &snapshot.vy[0];
+  c.vz = &snapshot.vz[0];
+  return c;
+}
+
+/**
+ * Split rows between threads so that each gets the same number of pairs.
+ * \param n the number of rows
+ * \param threads the number of threads
+ * \param upper if true, row i only holds n - i - 1 pairs
+ * \return the threads + 1 row boundaries
+ */
+static std::vector<size_t>
+SplitRows (size_t n, uint32_t threads, bool upper)
+{
+  std::vector<size_t> bounds (threads + 1, n);
+  for (uint32_t k = 0; k < threads; k++)
+    {
+      double share = double (k) / threads;
+      bounds[k] = upper ? size_t (n * (1.0 - std::sqrt (1.0 - share))) : size_t (n * share);
+    }
+  return bounds;
+}
+
+void
+PairwiseKinematics (const KinematicSnapshot &snapshot, double *distance, double *relativeSpeed,
+                    bool upper, uint32_t threads)
+{
+  NS_ASSERT (threads > 0);
+  size_t n = snapshot.GetN ();
+  if (n == 0 || (distance == 0 && relativeSpeed == 0))
+    {
+      return;
+    }
+  Columns c = GetColumns (snapshot);
+  threads = std::min<size_t> (threads, n);
+  std::vector<size_t> bounds = SplitRows (n, threads, upper);
+  std::vector<std::thread> workers;
+  for (uint32_t k = 1; k < threads; k++)
+    {
+      workers.push_back (std::thread (&KinematicsRows, c, n, bounds[k], bounds[k + 1],
+                                      distance, relativeSpeed, upper));
+    }
+  KinematicsRows (c, n, bounds[0], bounds[1], distance, relativeSpeed, upper);
+  for (size_t k = 0; k < workers.size (); k++)
+    {
+      workers[k].join ();
+    }
+}
+
+void
+PairwiseAdjacency (const KinematicSnapshot &snapshot, double range,
+                   std::vector<uint64_t> &adjacency, uint32_t threads)
+{
+  NS_ASSERT (threads > 0);
+  size_t n = snapshot.GetN ();
+  adjacency.assign (n * ((n + 63) / 64), 0);
+  if (n == 0)
+    {
+      return;
+    }
+  Columns c = GetColumns (snapshot);
+  double range2 = range * range;
+  threads = std::min<size_t> (threads, n);
+  std::vector<size_t> bounds = SplitRows (n, threads, false);
+  std::vector<std::thread> workers;
+  for (uint32_t k = 1; k < threads; k++)
+    {
+      workers.push_back (std::thread (&AdjacencyRows, c, n, bounds[k], bounds[k + 1],
+                                      range2, &adjacency[0]));
+    }
+  AdjacencyRows (c, n, bounds[0], bounds[1], range2, &adjacency[0]);
+  for (size_t k = 0; k < workers.size (); k++)
+    {
+      workers[k].join ();
+    }
+}
+
+bool
+IsAdjacent (const std::vector<uint64_t> &adjacency, size_t n, size_t i, size_t j)
+{
+  NS_ASSERT (i < n && j < n);
+  return (adjacency[i * ((n + 63) / 64) + j / 64] >> (j % 64)) & 1;
+}
+
+} // namespace ns3
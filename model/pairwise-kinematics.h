@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef PAIRWISE_KINEMATICS_H
+#define PAIRWISE_KINEMATICS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/vector.h"
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup mobility
+ * \brief Positions and velocities of a set of nodes at one time, stored one
+ * array per coordinate.
+ *
+ * This is the input of PairwiseKinematics and PairwiseAdjacency: laying the
+ * coordinates out in separate arrays lets those kernels load consecutive
+ * nodes straight into vector registers.
+ */
+class KinematicSnapshot
+{
+public:
+  KinematicSnapshot ();
+
+  /**
+   * Evaluate a set of nodes at the current time, with one
+   * MobilityModel::GetPositions pass.
+   * \param models the mobility models of the nodes
+   */
+  void Take (const std::vector<Ptr<MobilityModel> > &models);
+  /**
+   * \param n the new number of nodes, new nodes stand still at the origin
+   */
+  void Resize (size_t n);
+  /**
+   * \return the number of nodes
+   */
+  size_t GetN (void) const;
+  /**
+   * \param i the index of a node
+   * \param position the position of the node
+   * \param velocity the velocity of the node
+   */
+  void Set (size_t i, const Vector &position, const Vector &velocity);
+  /**
+   * \param i the index of a node
+   * \return the position of the node
+   */
+  Vector GetPosition (size_t i) const;
+  /**
+   * \param i the index of a node
+   * \return the velocity of the node
+   */
+  Vector GetVelocity (size_t i) const;
+
+  std::vector<double> x; //!< x coordinate of the positions
+  std::vector<double> y; //!< y coordinate of the positions
+  std::vector<double> z; //!< z coordinate of the positions
+  std::vector<double> vx; //!< x coordinate of the velocities
+  std::vector<double> vy; //!< y coordinate of the velocities
+  std::vector<double> vz; //!< z coordinate of the velocities
+};
+
+/**
+ * \ingroup mobility
+ * \brief Compute the distance and the relative speed of every pair of nodes.
+ *
+ * The results are the N x N row-major matrices of
+ * MobilityModel::GetDistanceFrom and MobilityModel::GetRelativeSpeed: entry
+ * i * N + j is about nodes i and j, the diagonal is zero.  When upper is
+ * true, only the entries with j > i are written, the others are left
+ * untouched.
+ *
+ * The columns are processed in tiles which stay in the L1 cache while every
+ * row goes over them, four or two columns at a time when the module is
+ * compiled with AVX2 or SSE2 enabled.  The rows are split between the given
+ * number of threads.
+ *
+ * \param snapshot the nodes
+ * \param distance receives the N x N distances, or null
+ * \param relativeSpeed receives the N x N relative speeds, or null
+ * \param upper if true, only compute the upper triangle
+ * \param threads the number of threads to use
+ */
+void PairwiseKinematics (const KinematicSnapshot &snapshot, double *distance, double *relativeSpeed,
+                         bool upper = false, uint32_t threads = 1);
+
+/**
+ * \ingroup mobility
+ * \brief Find every pair of nodes within a range of each other.
+ *
+ * The result is a bit matrix: row i takes (N + 63) / 64 words, and bit
+ * j % 64 of word j / 64 of the row is set when the squared distance of
+ * nodes i and j is at most range * range, i != j.  No square root is taken.
+ * Tiling, vectorization and threading are those of PairwiseKinematics.
+ *
+ * \param snapshot the nodes
+ * \param range the distance, in meters
+ * \param adjacency cleared and filled with the bit matrix
+ * \param threads the number of threads to use
+ */
+void PairwiseAdjacency (const KinematicSnapshot &snapshot, double range,
+                        std::vector<uint64_t> &adjacency, uint32_t threads = 1);
+
+/**
+ * \param adjacency a bit matrix filled by PairwiseAdjacency
+ * \param n the number of nodes
+ * \param i the index of a node
+ * \param j the index of another node
+ * \return true if the two nodes are within range
+ */
+bool IsAdjacent (const std::vector<uint64_t> &adjacency, size_t n, size_t i, size_t j);
+
+} // namespace ns3
+
+#endif /* PAIRWISE_KINEMATICS_H */
@@ -0,0 +1,261 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "patrol-zone-registry.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PatrolZoneRegistry");
+
+NS_OBJECT_ENSURE_REGISTERED (PatrolZoneRegistry);
+
+TypeId
+PatrolZoneRegistry::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PatrolZoneRegistry")
+    .SetParent<Object> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<PatrolZoneRegistry> ()
+    .AddAttribute ("CellSize",
+                   "Width of the cells of the grid indexing the zones. "
+                   "Can not be changed once zones are added.",
+                   DoubleValue (1000.0),
+                   MakeDoubleAccessor (&PatrolZoneRegistry::SetCellSize,
+                                       &PatrolZoneRegistry::GetCellSize),
+                   MakeDoubleChecker<double> ())
+  ;
+  return tid;
+}
+
+PatrolZoneRegistry::PatrolZoneRegistry ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PatrolZoneRegistry::~PatrolZoneRegistry ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+PatrolZoneRegistry::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_zones.clear ();
+  m_cells.clear ();
+  m_memberships.clear ();
+  Object::DoDispose ();
+}
+
+void
+PatrolZoneRegistry::SetCellSize (double cellSize)
+{
+  NS_LOG_FUNCTION (this << cellSize);
+  NS_ABORT_MSG_IF (!m_zones.empty (), "CellSize can not be changed once zones are added");
+  m_cellSize = cellSize;
+}
+
+double
+PatrolZoneRegistry::GetCellSize (void) const
+{
+  return m_cellSize;
+}
+
+uint64_t
+PatrolZoneRegistry::GetCellKey (int64_t x, int64_t y)
+{
+  return (static_cast<uint64_t> (static_cast<uint32_t> (x)) << 32) | static_cast<uint32_t> (y);
+}
+
+int64_t
+PatrolZoneRegistry::GetCell (double coordinate) const
+{
+  return static_cast<int64_t> (std::floor (coordinate / m_cellSize));
+}
+
+uint32_t
+PatrolZoneRegistry::AddZone (const Vector2D &center, double orbitDistance, double maxRadius)
+{
+  NS_LOG_FUNCTION (this << center << orbitDistance << maxRadius);
+  NS_ABORT_MSG_IF (m_cellSize <= 0, "CellSize must be positive");
+  NS_ABORT_MSG_IF (orbitDistance <= 0, "InterOrbitDistance must be positive");
+  uint32_t index = m_zones.size ();
+  Zone zone;
+  zone.center = center;
+  zone.orbitDistance = orbitDistance;
+  zone.maxRadius = maxRadius;
+  m_zones.push_back (zone);
+  // list the zone in every cell its bounding square overlaps
+  double reach = GetReach (index);
+  int64_t xMin = GetCell (center.x - reach);
+  int64_t xMax = GetCell (center.x + reach);
+  int64_t yMin = GetCell (center.y - reach);
+  int64_t yMax = GetCell (center.y + reach);
+  for (int64_t x = xMin; x <= xMax; x++)
+    {
+      for (int64_t y = yMin; y <= yMax; y++)
+        {
+          m_cells[GetCellKey (x, y)].push_back (index);
+        }
+    }
+  return index;
+}
+
+uint32_t
+PatrolZoneRegistry::GetNZones (void) const
+{
+  return m_zones.size ();
+}
+
+Vector2D
+PatrolZoneRegistry::GetCenter (uint32_t zone) const
+{
+  NS_ASSERT (zone < GetNZones ());
+  return m_zones[zone].center;
+}
+
+double
+PatrolZoneRegistry::GetInterOrbitDistance (uint32_t zone) const
+{
+  NS_ASSERT (zone < GetNZones ());
+  return m_zones[zone].orbitDistance;
+}
+
+double
+PatrolZoneRegistry::GetMaximumRadius (uint32_t zone) const
+{
+  NS_ASSERT (zone < GetNZones ());
+  return m_zones[zone].maxRadius;
+}
+
+double
+PatrolZoneRegistry::GetReach (uint32_t zone) const
+{
+  return m_zones[zone].maxRadius + m_zones[zone].orbitDistance / 2;
+}
+
+int32_t
+PatrolZoneRegistry::FindZone (const Vector &position) const
+{
+  NS_LOG_FUNCTION (this << position);
+  std::map<uint64_t, std::vector<uint32_t> >::const_iterator cell =
+    m_cells.find (GetCellKey (GetCell (position.x), GetCell (position.y)));
+  if (cell == m_cells.end ())
+    {
+      return -1;
+    }
+  int32_t found = -1;
+  double nearest = 0.0;
+  for (std::vector<uint32_t>::const_iterator i = cell->second.begin (); i != cell->second.end (); ++i)
+    {
+      const Zone &zone = m_zones[*i];
+      double dx = position.x - zone.center.x;
+      double dy = position.y - zone.center.y;
+      double distance = dx * dx + dy * dy;
+      double reach = GetReach (*i);
+      if (distance <= reach * reach && (found < 0 || distance < nearest))
+        {
+          found = *i;
+          nearest = distance;
+        }
+    }
+  return found;
+}
+
+void
+PatrolZoneRegistry::Register (Ptr<ConstantTimeCircularMotionModel> model, uint32_t zone)
+{
+  Membership membership;
+  membership.zone = zone;
+  membership.slot = m_zones[zone].drones.size ();
+  m_zones[zone].drones.push_back (model);
+  m_memberships[PeekPointer (model)] = membership;
+}
+
+void
+PatrolZoneRegistry::Unassign (Ptr<ConstantTimeCircularMotionModel> model)
+{
+  std::map<const ConstantTimeCircularMotionModel *, Membership>::iterator it = m_memberships.find (PeekPointer (model));
+  if (it == m_memberships.end ())
+    {
+      return;
+    }
+  // move the last drone of the zone into the freed slot
+  std::vector<Ptr<ConstantTimeCircularMotionModel> > &drones = m_zones[it->second.zone].drones;
+  uint32_t slot = it->second.slot;
+  drones[slot] = drones.back ();
+  drones.pop_back ();
+  if (slot < drones.size ())
+    {
+      m_memberships[PeekPointer (drones[slot])].slot = slot;
+    }
+  m_memberships.erase (it);
+}
+
+void
+PatrolZoneRegistry::Assign (Ptr<ConstantTimeCircularMotionModel> model, uint32_t zone)
+{
+  NS_LOG_FUNCTION (this << model << zone);
+  NS_ASSERT (zone < GetNZones ());
+  Unassign (model);
+  const Zone &z = m_zones[zone];
+  model->SetAttribute ("Center", Vector2DValue (z.center));
+  model->SetAttribute ("InterOrbitDistance", DoubleValue (z.orbitDistance));
+  model->SetAttribute ("MaximumRadius", DoubleValue (z.maxRadius));
+  Register (model, zone);
+}
+
+void
+PatrolZoneRegistry::Transit (Ptr<ConstantTimeCircularMotionModel> model, uint32_t zone)
+{
+  NS_LOG_FUNCTION (this << model << zone);
+  NS_ASSERT (zone < GetNZones ());
+  Unassign (model);
+  const Zone &z = m_zones[zone];
+  model->TransitToZone (z.center, z.orbitDistance, z.maxRadius);
+  Register (model, zone);
+}
+
+int32_t
+PatrolZoneRegistry::GetZoneOf (Ptr<const ConstantTimeCircularMotionModel> model) const
+{
+  std::map<const ConstantTimeCircularMotionModel *, Membership>::const_iterator it = m_memberships.find (PeekPointer (model));
+  if (it == m_memberships.end ())
+    {
+      return -1;
+    }
+  return it->second.zone;
+}
+
+uint32_t
+PatrolZoneRegistry::GetNDrones (uint32_t zone) const
+{
+  NS_ASSERT (zone < GetNZones ());
+  return m_zones[zone].drones.size ();
+}
+
+Ptr<ConstantTimeCircularMotionModel>
+PatrolZoneRegistry::GetDrone (uint32_t zone, uint32_t i) const
+{
+  NS_ASSERT (zone < GetNZones () && i < GetNDrones (zone));
+  return m_zones[zone].drones[i];
+}
+
+} // namespace ns3
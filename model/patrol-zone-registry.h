@@ -0,0 +1,183 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef PATROL_ZONE_REGISTRY_H
+#define PATROL_ZONE_REGISTRY_H
+
+#include <map>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/vector.h"
+#include "constant-time-circular-motion-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Registry of surveillance sites, each with its own set of orbits.
+ *
+ * A patrol zone is a center with its own InterOrbitDistance and
+ * MaximumRadius.  Drones flying an ns3::ConstantTimeCircularMotionModel are
+ * assigned to a zone, which configures their orbits, and can later transit
+ * to another zone.
+ *
+ * Zones are indexed by a uniform grid of CellSize wide square cells: each
+ * zone is listed in every cell its disk overlaps, so finding the zone
+ * covering a position only looks at the zones of one cell, however many
+ * zones are registered.
+ */
+class PatrolZoneRegistry : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  PatrolZoneRegistry ();
+  virtual ~PatrolZoneRegistry ();
+
+  /**
+   * Register a patrol zone.
+   * \param center the center of the orbits of the zone
+   * \param orbitDistance the distance between two successive orbits
+   * \param maxRadius the radius of the outermost orbit
+   * \return the index of the zone
+   */
+  uint32_t AddZone (const Vector2D &center, double orbitDistance, double maxRadius);
+  /**
+   * \return the number of zones
+   */
+  uint32_t GetNZones (void) const;
+  /**
+   * \param zone the index of a zone
+   * \return the center of the zone
+   */
+  Vector2D GetCenter (uint32_t zone) const;
+  /**
+   * \param zone the index of a zone
+   * \return the distance between two successive orbits of the zone
+   */
+  double GetInterOrbitDistance (uint32_t zone) const;
+  /**
+   * \param zone the index of a zone
+   * \return the radius of the outermost orbit of the zone
+   */
+  double GetMaximumRadius (uint32_t zone) const;
+  /**
+   * Find the zone covering a position, i.e. within half an orbit spacing
+   * of its outermost orbit.  When zones overlap, the one with the nearest
+   * center wins.
+   * \param position the position to look up
+   * \return the index of the zone, or -1 if no zone covers the position
+   */
+  int32_t FindZone (const Vector &position) const;
+
+  /**
+   * Assign a drone to a zone before it starts patrolling: its Center,
+   * InterOrbitDistance and MaximumRadius attributes are set to the ones of
+   * the zone.
+   * \param model the mobility model of the drone
+   * \param zone the index of the zone
+   */
+  void Assign (Ptr<ConstantTimeCircularMotionModel> model, uint32_t zone);
+  /**
+   * Send a patrolling drone to another zone.
+   * \param model the mobility model of the drone
+   * \param zone the index of the zone to fly to
+   */
+  void Transit (Ptr<ConstantTimeCircularMotionModel> model, uint32_t zone);
+  /**
+   * \param model the mobility model of a drone
+   * \return the zone the drone is assigned to, or -1 if it is not assigned
+   */
+  int32_t GetZoneOf (Ptr<const ConstantTimeCircularMotionModel> model) const;
+  /**
+   * \param zone the index of a zone
+   * \return the number of drones assigned to the zone
+   */
+  uint32_t GetNDrones (uint32_t zone) const;
+  /**
+   * \param zone the index of a zone
+   * \param i the index of a drone within the zone
+   * \return the mobility model of the drone
+   */
+  Ptr<ConstantTimeCircularMotionModel> GetDrone (uint32_t zone, uint32_t i) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \param cellSize the width of the cells, set before the first zone is added
+   */
+  void SetCellSize (double cellSize);
+  /**
+   * \return the width of the cells
+   */
+  double GetCellSize (void) const;
+
+  /// A surveillance site
+  struct Zone
+  {
+    Vector2D center; //!< center of the orbits
+    double orbitDistance; //!< distance between two successive orbits
+    double maxRadius; //!< radius of the outermost orbit
+    std::vector<Ptr<ConstantTimeCircularMotionModel> > drones; //!< drones assigned to the zone
+  };
+  /// Where a drone is registered
+  struct Membership
+  {
+    uint32_t zone; //!< index of the zone
+    uint32_t slot; //!< index of the drone in Zone::drones
+  };
+  /**
+   * \param x the x coordinate of a cell
+   * \param y the y coordinate of a cell
+   * \return the key of the cell in m_cells
+   */
+  static uint64_t GetCellKey (int64_t x, int64_t y);
+  /**
+   * \param coordinate a position coordinate
+   * \return the coordinate of the cell holding it
+   */
+  int64_t GetCell (double coordinate) const;
+  /**
+   * \param zone the index of a zone
+   * \return the distance from the center up to which the zone covers positions
+   */
+  double GetReach (uint32_t zone) const;
+  /**
+   * Remove a drone from the zone it is assigned to, if any.
+   * \param model the mobility model of the drone
+   */
+  void Unassign (Ptr<ConstantTimeCircularMotionModel> model);
+  /**
+   * Add a drone to the list of a zone.
+   * \param model the mobility model of the drone
+   * \param zone the index of the zone
+   */
+  void Register (Ptr<ConstantTimeCircularMotionModel> model, uint32_t zone);
+
+  double m_cellSize; //!< width of the cells of the grid
+  std::vector<Zone> m_zones; //!< registered zones
+  std::map<uint64_t, std::vector<uint32_t> > m_cells; //!< zones overlapping each non empty cell
+  std::map<const ConstantTimeCircularMotionModel *, Membership> m_memberships; //!< zone of each drone
+};
+
+} // namespace ns3
+
+#endif /* PATROL_ZONE_REGISTRY_H */
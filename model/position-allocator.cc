@@ -49,6 +49,15 @@ PositionAllocator::PositionAllocator ()
 PositionAllocator::~PositionAllocator ()
 {}
 
+void
+PositionAllocator::GetNextBatch (uint32_t n, Vector *positions) const
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      positions[i] = GetNext ();
+    }
+}
+
 
 NS_OBJECT_ENSURE_REGISTERED (ListPositionAllocator);
 
@@ -127,6 +136,20 @@ ListPositionAllocator::GetNext (void) const
   return v;
 }
 
+void
+ListPositionAllocator::GetNextBatch (uint32_t n, Vector *positions) const
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      positions[i] = *m_current;
+      m_current++;
+      if (m_current == m_positions.end ())
+        {
+          m_current = m_positions.begin ();
+        }
+    }
+}
+
 int64_t
 ListPositionAllocator::AssignStreams (int64_t stream)
 {
@@ -284,6 +307,24 @@ GridPositionAllocator::GetNext (void) const
   return Vector (x, y, m_z);
 }
 
+void
+GridPositionAllocator::GetNextBatch (uint32_t n, Vector *positions) const
+{
+  for (uint32_t i = 0; i < n; i++, m_current++)
+    {
+      uint32_t minor = m_current % m_n;
+      uint32_t major = m_current / m_n;
+      if (m_layoutType == ROW_FIRST)
+        {
+          positions[i] = Vector (m_xMin + m_deltaX * minor, m_yMin + m_deltaY * major, m_z);
+        }
+      else
+        {
+          positions[i] = Vector (m_xMin + m_deltaX * major, m_yMin + m_deltaY * minor, m_z);
+        }
+    }
+}
+
 int64_t
 GridPositionAllocator::AssignStreams (int64_t stream)
 {
@@ -48,6 +48,16 @@ public:
    * This method _must_ be implement in subclasses.
    */
   virtual Vector GetNext (void) const = 0;
+  /**
+   * Allocate the next positions, as n calls to GetNext would.
+   *
+   * Subclasses may override this to fill the array without a virtual call
+   * per position.
+   *
+   * \param n the number of positions
+   * \param positions receives the n positions
+   */
+  virtual void GetNextBatch (uint32_t n, Vector *positions) const;
   /**
    * Assign a fixed random variable stream number to the random variables
    * used by this model. Return the number of streams (possibly zero) that
@@ -111,6 +121,7 @@ public:
    */
   uint32_t GetSize (void) const;
   virtual Vector GetNext (void) const;
+  virtual void GetNextBatch (uint32_t n, Vector *positions) const;
   virtual int64_t AssignStreams (int64_t stream);
 
 private:
@@ -209,6 +220,7 @@ public:
 
 
   virtual Vector GetNext (void) const;
+  virtual void GetNextBatch (uint32_t n, Vector *positions) const;
   virtual int64_t AssignStreams (int64_t stream);
 
 private:
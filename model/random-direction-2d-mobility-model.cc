@@ -24,6 +24,7 @@
 #include "ns3/string.h"
 #include "ns3/pointer.h"
 #include "random-direction-2d-mobility-model.h"
+#include "mobility-stats.h"
 
 namespace ns3 {
 
@@ -76,6 +77,7 @@ RandomDirection2dMobilityModel::DoInitialize (void)
 void
 RandomDirection2dMobilityModel::DoInitializePrivate (void)
 {
+  MOBILITY_STATS_SCOPE (this, UPDATE);
   double direction = m_direction->GetValue (0, 2 * M_PI);
   SetDirectionAndSpeed (direction);
 }
@@ -83,10 +85,12 @@ RandomDirection2dMobilityModel::DoInitializePrivate (void)
 void
 RandomDirection2dMobilityModel::BeginPause (void)
 {
+  MOBILITY_STATS_SCOPE (this, UPDATE);
   m_helper.Update ();
   m_helper.Pause ();
   Time pause = Seconds (m_pause->GetValue ());
   m_event.Cancel ();
+  MOBILITY_STATS_COUNT (this, SCHEDULE);
   m_event = Simulator::Schedule (pause, &RandomDirection2dMobilityModel::ResetDirectionAndSpeed, this);
   NotifyCourseChange ();
 }
@@ -106,6 +110,7 @@ RandomDirection2dMobilityModel::SetDirectionAndSpeed (double direction)
   Vector next = m_bounds.CalculateIntersection (position, vector);
   Time delay = Seconds (CalculateDistance (position, next) / speed);
   m_event.Cancel ();
+  MOBILITY_STATS_COUNT (this, SCHEDULE);
   m_event = Simulator::Schedule (delay,
                                  &RandomDirection2dMobilityModel::BeginPause, this);
   NotifyCourseChange ();
@@ -113,6 +118,7 @@ RandomDirection2dMobilityModel::SetDirectionAndSpeed (double direction)
 void
 RandomDirection2dMobilityModel::ResetDirectionAndSpeed (void)
 {
+  MOBILITY_STATS_SCOPE (this, UPDATE);
   double direction = m_direction->GetValue (0, M_PI);
 
   m_helper.UpdateWithBounds (m_bounds);
@@ -145,6 +151,7 @@ RandomDirection2dMobilityModel::DoSetPosition (const Vector &position)
 {
   m_helper.SetPosition (position);
   m_event.Cancel ();
+  MOBILITY_STATS_COUNT (this, SCHEDULE);
   m_event = Simulator::ScheduleNow (&RandomDirection2dMobilityModel::DoInitializePrivate, this);
 }
 Vector
@@ -152,6 +159,13 @@ RandomDirection2dMobilityModel::DoGetVelocity (void) const
 {
   return m_helper.GetVelocity ();
 }
+TrajectorySegment
+RandomDirection2dMobilityModel::DoGetCurrentSegment (void) const
+{
+  // the helper moves in a straight line until the next scheduled event
+  m_helper.UpdateWithBounds (m_bounds);
+  return m_helper.GetSegment (m_event.IsRunning () ? TimeStep (m_event.GetTs ()) : Time::Max ());
+}
 int64_t
 RandomDirection2dMobilityModel::DoAssignStreams (int64_t stream)
 {
@@ -74,6 +74,7 @@ private:
   virtual Vector DoGetPosition (void) const;
   virtual void DoSetPosition (const Vector &position);
   virtual Vector DoGetVelocity (void) const;
+  virtual TrajectorySegment DoGetCurrentSegment (void) const;
   virtual int64_t DoAssignStreams (int64_t);
 
   Ptr<UniformRandomVariable> m_direction; //!< rv to control direction
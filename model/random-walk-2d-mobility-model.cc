@@ -24,6 +24,7 @@
 #include "ns3/pointer.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "mobility-stats.h"
 #include <cmath>
 
 namespace ns3 {
@@ -84,6 +85,7 @@ RandomWalk2dMobilityModel::DoInitialize (void)
 void
 RandomWalk2dMobilityModel::DoInitializePrivate (void)
 {
+  MOBILITY_STATS_SCOPE (this, UPDATE);
   m_helper.Update ();
   double speed = m_speed->GetValue ();
   double direction = m_direction->GetValue ();
@@ -116,12 +118,14 @@ RandomWalk2dMobilityModel::DoWalk (Time delayLeft)
   m_event.Cancel ();
   if (m_bounds.IsInside (nextPosition))
     {
+      MOBILITY_STATS_COUNT (this, SCHEDULE);
       m_event = Simulator::Schedule (delayLeft, &RandomWalk2dMobilityModel::DoInitializePrivate, this);
     }
   else
     {
       nextPosition = m_bounds.CalculateIntersection (position, speed);
       Time delay = Seconds ((nextPosition.x - position.x) / speed.x);
+      MOBILITY_STATS_COUNT (this, SCHEDULE);
       m_event = Simulator::Schedule (delay, &RandomWalk2dMobilityModel::Rebound, this,
                                      delayLeft - delay);
     }
@@ -131,6 +135,7 @@ RandomWalk2dMobilityModel::DoWalk (Time delayLeft)
 void
 RandomWalk2dMobilityModel::Rebound (Time delayLeft)
 {
+  MOBILITY_STATS_SCOPE (this, UPDATE);
   m_helper.UpdateWithBounds (m_bounds);
   Vector position = m_helper.GetCurrentPosition ();
   Vector speed = m_helper.GetVelocity ();
@@ -168,6 +173,7 @@ RandomWalk2dMobilityModel::DoSetPosition (const Vector &position)
   NS_ASSERT (m_bounds.IsInside (position));
   m_helper.SetPosition (position);
   m_event.Cancel ();
+  MOBILITY_STATS_COUNT (this, SCHEDULE);
   m_event = Simulator::ScheduleNow (&RandomWalk2dMobilityModel::DoInitializePrivate, this);
 }
 Vector
@@ -175,6 +181,13 @@ RandomWalk2dMobilityModel::DoGetVelocity (void) const
 {
   return m_helper.GetVelocity ();
 }
+TrajectorySegment
+RandomWalk2dMobilityModel::DoGetCurrentSegment (void) const
+{
+  // the helper moves in a straight line until the next scheduled event
+  m_helper.UpdateWithBounds (m_bounds);
+  return m_helper.GetSegment (m_event.IsRunning () ? TimeStep (m_event.GetTs ()) : Time::Max ());
+}
 int64_t
 RandomWalk2dMobilityModel::DoAssignStreams (int64_t stream)
 {
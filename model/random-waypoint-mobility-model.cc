@@ -24,6 +24,7 @@
 #include "ns3/string.h"
 #include "random-waypoint-mobility-model.h"
 #include "position-allocator.h"
+#include "mobility-stats.h"
 
 namespace ns3 {
 
@@ -58,6 +59,7 @@ RandomWaypointMobilityModel::GetTypeId (void)
 void
 RandomWaypointMobilityModel::BeginWalk (void)
 {
+  MOBILITY_STATS_SCOPE (this, UPDATE);
   m_helper.Update ();
   Vector m_current = m_helper.GetCurrentPosition ();
   NS_ASSERT_MSG (m_position, "No position allocator added before using this model");
@@ -72,6 +74,7 @@ RandomWaypointMobilityModel::BeginWalk (void)
   m_helper.Unpause ();
   Time travelDelay = Seconds (CalculateDistance (destination, m_current) / speed);
   m_event.Cancel ();
+  MOBILITY_STATS_COUNT (this, SCHEDULE);
   m_event = Simulator::Schedule (travelDelay,
                                  &RandomWaypointMobilityModel::DoInitializePrivate, this);
   NotifyCourseChange ();
@@ -87,9 +90,11 @@ RandomWaypointMobilityModel::DoInitialize (void)
 void
 RandomWaypointMobilityModel::DoInitializePrivate (void)
 {
+  MOBILITY_STATS_SCOPE (this, UPDATE);
   m_helper.Update ();
   m_helper.Pause ();
   Time pause = Seconds (m_pause->GetValue ());
+  MOBILITY_STATS_COUNT (this, SCHEDULE);
   m_event = Simulator::Schedule (pause, &RandomWaypointMobilityModel::BeginWalk, this);
   NotifyCourseChange ();
 }
@@ -105,6 +110,7 @@ RandomWaypointMobilityModel::DoSetPosition (const Vector &position)
 {
   m_helper.SetPosition (position);
   m_event.Cancel ();
+  MOBILITY_STATS_COUNT (this, SCHEDULE);
   m_event = Simulator::ScheduleNow (&RandomWaypointMobilityModel::DoInitializePrivate, this);
 }
 Vector
@@ -112,6 +118,13 @@ RandomWaypointMobilityModel::DoGetVelocity (void) const
 {
   return m_helper.GetVelocity ();
 }
+TrajectorySegment
+RandomWaypointMobilityModel::DoGetCurrentSegment (void) const
+{
+  // the helper moves in a straight line until the next scheduled event
+  m_helper.Update ();
+  return m_helper.GetSegment (m_event.IsRunning () ? TimeStep (m_event.GetTs ()) : Time::Max ());
+}
 int64_t
 RandomWaypointMobilityModel::DoAssignStreams (int64_t stream)
 {
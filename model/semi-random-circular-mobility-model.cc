@@ -7,6 +7,8 @@
 #include "semi-random-circular-mobility-model.h"
 #include "ns3/double.h"
 #include "ns3/vector.h"
+#include "mobility-stats.h"
+#include "orbit-shell.h"
 
 namespace ns3{
 
@@ -39,7 +41,8 @@ NS_OBJECT_ENSURE_REGISTERED (SemiRandomCircularMobilityModel);
                         MakeVector2DAccessor(&SemiRandomCircularMobilityModel::center),
                         MakeVector2DChecker())
             .AddAttribute("Timestep",
-                        "Time step for updating position along the orbit",
+                        "Time step for updating position along the orbit. Unused, orbit switches "
+                        "are scheduled at the exact arrival time at the exchange point",
                         DoubleValue(1.0),
                         MakeDoubleAccessor(&SemiRandomCircularMobilityModel::time_step),
                         MakeDoubleChecker<double>())
@@ -58,6 +61,19 @@ NS_OBJECT_ENSURE_REGISTERED (SemiRandomCircularMobilityModel);
                         DoubleValue(4.0),
                         MakeDoubleAccessor(&SemiRandomCircularMobilityModel::m_exchange_points),
                         MakeDoubleChecker<double>())
+            .AddAttribute("AltitudeStep",
+                        "Altitude difference between two successive orbits, which then form stacked "
+                        "(radius, altitude) shells. Radial legs climb or descend to the altitude of the "
+                        "next shell. 0 keeps every drone at its initial altitude. The altitude given "
+                        "to SetPosition is not snapped to a shell, the first radial leg levels the drone off",
+                        DoubleValue(0.0),
+                        MakeDoubleAccessor(&SemiRandomCircularMobilityModel::m_altitude_step),
+                        MakeDoubleChecker<double>())
+            .AddAttribute("BaseAltitude",
+                        "Altitude of the shell of orbit 0 when AltitudeStep is not 0",
+                        DoubleValue(0.0),
+                        MakeDoubleAccessor(&SemiRandomCircularMobilityModel::m_base_altitude),
+                        MakeDoubleChecker<double>())
             .AddAttribute("Mode",
                         "Random Flight mode or Random walk mode"
                         "Random Flight mode is when nodes can switch to any other orbit"
@@ -73,7 +89,7 @@ NS_OBJECT_ENSURE_REGISTERED (SemiRandomCircularMobilityModel);
                         MakePointerChecker<RandomVariableStream>())
             .AddAttribute("FlightChoice",
                         "A random variable which decides which orbit to move to next",
-                        StringValue("ns3::UniformRandomVariable[Min[0.0|Max=2.0]]"),
+                        StringValue("ns3::UniformRandomVariable[Min=0.0|Max=2.0]"),
                         MakePointerAccessor(&SemiRandomCircularMobilityModel::m_rf_choice),
                         MakePointerChecker<RandomVariableStream>());
         return tid;
@@ -105,57 +121,69 @@ NS_OBJECT_ENSURE_REGISTERED (SemiRandomCircularMobilityModel);
     }
     void SemiRandomCircularMobilityModel::DoSetPosition(const Vector &position)
     {
-        m_helper.Update();
-        m_helper.Pause();
-        m_helper.SetPosition(position);
         m_event.Cancel();
-        DoConfigureAngVelHelper(position);
+        m_vel_helper.Pause();
+        m_vel_helper.SetPosition(position);
         // change position here
         current_position = position;
-        // if angular distance covered is close to 2\Pi, initiate Orbit Switch and radial motion
+        DoStartOrbit(position);
+    }
+    void SemiRandomCircularMobilityModel::DoStartOrbit(const Vector &position)
+    {
+        m_helper.Update();
+        m_helper.Pause();
+        DoConfigureAngVelHelper(position);
+        m_helper.Unpause();
+        m_on_orbit = true;
+        // the drone flies a full revolution, then on to the next exchange point 
+        // ahead of it, and switches orbits there 
         Vector2D omega = m_helper.GetOmega();
         // omega.x represents the angular velocity and omega.y represents clockwise and counterclockwise directions
-        time_to_travel = (2*M_PI)/omega.x;
-        // find the nearest exchange point to our particular position
-        double theta = m_helper.GetTheta(position);
+        double theta = m_helper.GetThetaAt(Simulator::Now());
         double step = (2*M_PI)/m_exchange_points;
+        double to_exchange_point;
         if(omega.y >0)
         {
-            int number = std::ceil(theta/step);
-            time_to_travel += ((number*2*M_PI/m_exchange_points)-theta)/omega.x;
+            to_exchange_point = std::ceil(theta/step)*step - theta;
         }
         else
         {
-            int number = std::floor(theta/step);
-            time_to_travel += (theta-(number*2*M_PI/m_exchange_points))/omega.x;
+            to_exchange_point = theta - std::floor(theta/step)*step;
+        }
+        time_to_travel = (2*M_PI + to_exchange_point)/omega.x;
+        if(!std::isfinite(time_to_travel))
+        {
+            // a drone that does not move never reaches an exchange point
+            m_next_decision = Time::Max();
+            return;
         }
-        m_event = Simulator::ScheduleNow(&SemiRandomCircularMobilityModel::DoSurveil,this);
-        time_travelled += time_step;
+        m_next_decision = Simulator::Now() + Seconds(time_to_travel);
+        MOBILITY_STATS_COUNT(this, SCHEDULE);
+        m_event = Simulator::Schedule(m_next_decision - Simulator::Now(),
+                                &SemiRandomCircularMobilityModel::DoSurveil,this);
     }
     void SemiRandomCircularMobilityModel::DoSurveil()
     {
-        m_vel_helper.Update();
-        m_vel_helper.Pause();
-        m_helper.Update();
-        m_helper.Pause();
-        // find out nearest exit from here on
-        if(time_travelled >= time_to_travel)
+        MOBILITY_STATS_SCOPE(this, UPDATE);
+        if(!m_on_orbit)
         {
-            // we travelled enough time on the orbit, time to switch orbits now
-            // reset counters
-            time_to_travel = 0;
-            time_travelled = 0;
-            Simulator::ScheduleNow(&SemiRandomCircularMobilityModel::DoOrbitSwitch,this);
+            // back from a radial leg, continue on the orbit we arrived at
+            m_vel_helper.Update();
+            m_vel_helper.Pause();
+            DoStartOrbit(m_vel_helper.GetCurrentPosition());
             NotifyCourseChange();
             return;
         }
-        m_helper.Unpause();
-        m_event = Simulator::Schedule(Seconds(time_step),&SemiRandomCircularMobilityModel::DoSurveil,this);
-        //m_helper.SetPosition(m_position);
+        // we reached the exchange point, time to switch orbits now
+        m_helper.Update();
+        m_helper.Pause();
+        time_to_travel = 0;
+        NotifyCourseChange();
+        DoOrbitSwitch();
     }
     void SemiRandomCircularMobilityModel::DoOrbitSwitch()
     {
-        m_helper.Update();
+        MOBILITY_STATS_SCOPE(this, UPDATE);
         Vector cur_pos = m_helper.GetCurrentPosition();
         m_vel_helper.Pause();
         m_vel_helper.SetPosition(cur_pos);
@@ -184,6 +212,10 @@ NS_OBJECT_ENSURE_REGISTERED (SemiRandomCircularMobilityModel);
                 
                 travel_vec = Vector(cur_pos.x-center.x, cur_pos.y-center.y ,cur_pos.z);
             }
+            // random flights do not move the drone yet, it stays where it is, 
+            // held by the paused m_vel_helper and off any orbit
+            m_on_orbit = false;
+            m_next_decision = Time::Max();
         }
         else
         {
@@ -212,9 +244,18 @@ NS_OBJECT_ENSURE_REGISTERED (SemiRandomCircularMobilityModel);
                 }        
             }
             double theta = m_helper.GetTheta(travel_vec);
-            m_vel_helper.SetVelocity(Vector(m_radial_vel*std::cos(theta),m_radial_vel*std::sin(theta),0));
+            // the leg ends on the shell of the next orbit, inwards or outwards
+            int orbit_number = std::round(m_helper.GetRadius()/m_orbit_dist);
+            double outwards = travel_vec.x*(cur_pos.x-center.x) + travel_vec.y*(cur_pos.y-center.y);
+            int fin_orbit_num = outwards > 0 ? orbit_number+1 : orbit_number-1;
+            double climb_rate = GetOrbitShellClimbRate(cur_pos.z,m_base_altitude,m_altitude_step,
+                                                       fin_orbit_num,m_orbit_dist/m_radial_vel);
+            m_vel_helper.SetVelocity(Vector(m_radial_vel*std::cos(theta),m_radial_vel*std::sin(theta),climb_rate));
             m_vel_helper.Update();
             m_vel_helper.Unpause();
+            m_on_orbit = false;
+            m_next_decision = Simulator::Now() + Seconds(m_orbit_dist/m_radial_vel);
+            MOBILITY_STATS_COUNT(this, SCHEDULE);
             m_event = Simulator::Schedule(Seconds(m_orbit_dist/m_radial_vel),
                                     &SemiRandomCircularMobilityModel::DoSurveil,this);
             NotifyCourseChange();
@@ -236,7 +277,47 @@ NS_OBJECT_ENSURE_REGISTERED (SemiRandomCircularMobilityModel);
     }
     Vector SemiRandomCircularMobilityModel::DoGetPosition(void) const
     {
-        return m_helper.GetCurrentPosition();
+        // no event moves the drone between decisions, bring the helper up to date here
+        if(m_on_orbit)
+        {
+            m_helper.Update();
+            return m_helper.GetCurrentPosition();
+        }
+        m_vel_helper.Update();
+        return m_vel_helper.GetCurrentPosition();
+    }
+    TrajectorySegment SemiRandomCircularMobilityModel::DoGetCurrentSegment(void) const
+    {
+        Time end = Max(m_next_decision, Simulator::Now());
+        if(m_on_orbit)
+        {
+            return m_helper.GetSegment(end);
+        }
+        return m_vel_helper.GetSegment(end);
+    }
+    Vector SemiRandomCircularMobilityModel::GetPositionAt(const Time &t) const
+    {
+        NS_ASSERT_MSG(t >= Simulator::Now(), "GetPositionAt only looks ahead");
+        NS_ASSERT_MSG(t <= m_next_decision, "GetPositionAt can not look past the next orbit decision at " << m_next_decision);
+        if(m_on_orbit)
+        {
+            return m_helper.GetPositionAt(t);
+        }
+        return m_vel_helper.GetPositionAt(t);
+    }
+    bool SemiRandomCircularMobilityModel::GetOrbitPhase(ConstantAngularVelocityHelper &phase) const
+    {
+        // a drone which does not turn is standing still, not orbiting
+        if(!m_on_orbit || m_helper.GetAngularRate() == 0.0)
+        {
+            return false;
+        }
+        phase = m_helper;
+        return true;
+    }
+    Time SemiRandomCircularMobilityModel::GetNextDecisionTime(void) const
+    {
+        return m_next_decision;
     }
     int64_t SemiRandomCircularMobilityModel::DoAssignStreams (int64_t stream)
     {
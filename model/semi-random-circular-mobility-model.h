@@ -35,9 +35,33 @@ namespace ns3{
          * 2. Radial movement - There must be gossip of information between nodes because of which 
          * we enable switching orbits by nodes. 
          * */
+        /**
+         * Look ahead on the current orbit arc or radial leg without 
+         * simulating or scheduling anything.
+         * \param t a time between now and GetNextDecisionTime ()
+         * \return the position of the drone at time t
+         * */
+        Vector GetPositionAt(const Time &t) const;
+        /**
+         * \return the time at which the drone takes its next orbit decision
+         * */
+        Time GetNextDecisionTime(void) const;
+        /**
+         * Describe the orbit the drone is flying, e.g. to predict when it 
+         * comes within range of another drone. 
+         * \param phase set to a copy of the orbit helper
+         * \return false while the drone is not on an orbit: on a radial leg, or
+         * standing still, e.g. after a random flight
+         * */
+        bool GetOrbitPhase(ConstantAngularVelocityHelper &phase) const;
 
         private:
             void DoSurveil();
+            /**
+             * Start flying the orbit through position and schedule the orbit 
+             * switch at the exact time the drone reaches its exchange point.
+             * */
+            void DoStartOrbit(const Vector &position);
             void DoOrbitSwitch();
             void DoConfigureAngVelHelper(const Vector &position);
             void DoInitializePrivate(void);
@@ -45,6 +69,7 @@ namespace ns3{
             virtual Vector DoGetPosition(void) const;
             virtual void DoSetPosition(const Vector &position);
             virtual Vector DoGetVelocity(void) const;
+            virtual TrajectorySegment DoGetCurrentSegment(void) const;
             virtual double DoGetRadius();
             virtual int64_t DoAssignStreams(int64_t);
 
@@ -58,13 +83,16 @@ namespace ns3{
         double m_radial_vel;
         double m_orbit_dist;
         double m_max_orbit_rad;
+        double m_altitude_step; //!< altitude difference between successive orbit shells, 0 for flat orbits
+        double m_base_altitude; //!< altitude of the shell of orbit 0
         enum Mode m_mode;
         double time_step;
         EventId m_event; //!< stored event ID 
         double m_exchange_points;
         double time_to_travel=0.0;
-        double time_travelled = 0.0;
         std::vector<double> exchangePoints;
+        bool m_on_orbit = true; //!< false while moving along a radial leg
+        Time m_next_decision; //!< time of the next orbit decision
         Ptr<RandomVariableStream> m_rw_choice;
         Ptr<RandomVariableStream> m_rf_choice;
     };
@@ -22,6 +22,7 @@
 #include "ns3/double.h"
 #include "steady-state-random-waypoint-mobility-model.h"
 #include "ns3/test.h"
+#include "mobility-stats.h"
 
 namespace ns3 {
 
@@ -108,6 +109,7 @@ SteadyStateRandomWaypointMobilityModel::DoInitialize (void)
 void
 SteadyStateRandomWaypointMobilityModel::DoInitializePrivate (void)
 {
+  MOBILITY_STATS_SCOPE (this, UPDATE);
   alreadyStarted = true;
   // Configure random variables based on attributes
   NS_ASSERT (m_minSpeed >= 1e-6);
@@ -179,6 +181,7 @@ SteadyStateRandomWaypointMobilityModel::DoInitializePrivate (void)
           pause = Seconds (u*expectedPauseTime);
         }
       NS_ASSERT (!m_event.IsRunning ());
+      MOBILITY_STATS_COUNT (this, SCHEDULE);
       m_event = Simulator::Schedule (pause, &SteadyStateRandomWaypointMobilityModel::BeginWalk, this);
     }
   else // node initially moving
@@ -199,6 +202,7 @@ SteadyStateRandomWaypointMobilityModel::DoInitializePrivate (void)
       double u2 = m_u_r->GetValue (0, 1);
       m_helper.SetPosition (Vector (m_minX + u2*x1 + (1 - u2)*x2, m_minY + u2*y1 + (1 - u2)*y2, m_z));
       NS_ASSERT (!m_event.IsRunning ());
+      MOBILITY_STATS_COUNT (this, SCHEDULE);
       m_event = Simulator::ScheduleNow (&SteadyStateRandomWaypointMobilityModel::SteadyStateBeginWalk, this, 
                                         Vector (m_minX + x2, m_minY + y2, m_z));
     }
@@ -208,6 +212,7 @@ SteadyStateRandomWaypointMobilityModel::DoInitializePrivate (void)
 void
 SteadyStateRandomWaypointMobilityModel::SteadyStateBeginWalk (const Vector &destination)
 {
+  MOBILITY_STATS_SCOPE (this, UPDATE);
   m_helper.Update ();
   Vector m_current = m_helper.GetCurrentPosition ();
   NS_ASSERT (m_minX <= m_current.x && m_current.x <= m_maxX);
@@ -224,6 +229,7 @@ SteadyStateRandomWaypointMobilityModel::SteadyStateBeginWalk (const Vector &dest
   m_helper.SetVelocity (Vector (k*dx, k*dy, k*dz));
   m_helper.Unpause ();
   Time travelDelay = Seconds (CalculateDistance (destination, m_current) / speed);
+  MOBILITY_STATS_COUNT (this, SCHEDULE);
   m_event = Simulator::Schedule (travelDelay, 
                                  &SteadyStateRandomWaypointMobilityModel::Start, this);
   NotifyCourseChange ();
@@ -232,6 +238,7 @@ SteadyStateRandomWaypointMobilityModel::SteadyStateBeginWalk (const Vector &dest
 void
 SteadyStateRandomWaypointMobilityModel::BeginWalk (void)
 {
+  MOBILITY_STATS_SCOPE (this, UPDATE);
   m_helper.Update ();
   Vector m_current = m_helper.GetCurrentPosition ();
   NS_ASSERT (m_minX <= m_current.x && m_current.x <= m_maxX);
@@ -246,6 +253,7 @@ SteadyStateRandomWaypointMobilityModel::BeginWalk (void)
   m_helper.SetVelocity (Vector (k*dx, k*dy, k*dz));
   m_helper.Unpause ();
   Time travelDelay = Seconds (CalculateDistance (destination, m_current) / speed);
+  MOBILITY_STATS_COUNT (this, SCHEDULE);
   m_event = Simulator::Schedule (travelDelay,
                                  &SteadyStateRandomWaypointMobilityModel::Start, this);
   NotifyCourseChange ();
@@ -254,9 +262,11 @@ SteadyStateRandomWaypointMobilityModel::BeginWalk (void)
 void
 SteadyStateRandomWaypointMobilityModel::Start (void)
 {
+  MOBILITY_STATS_SCOPE (this, UPDATE);
   m_helper.Update ();
   m_helper.Pause ();
   Time pause = Seconds (m_pause->GetValue ());
+  MOBILITY_STATS_COUNT (this, SCHEDULE);
   m_event = Simulator::Schedule (pause, &SteadyStateRandomWaypointMobilityModel::BeginWalk, this);
   NotifyCourseChange ();
 }
@@ -274,6 +284,7 @@ SteadyStateRandomWaypointMobilityModel::DoSetPosition (const Vector &position)
     {
       m_helper.SetPosition (position);
       m_event.Cancel ();
+      MOBILITY_STATS_COUNT (this, SCHEDULE);
       m_event = Simulator::ScheduleNow (&SteadyStateRandomWaypointMobilityModel::Start, this);
     }
 }
@@ -282,6 +293,13 @@ SteadyStateRandomWaypointMobilityModel::DoGetVelocity (void) const
 {
   return m_helper.GetVelocity ();
 }
+TrajectorySegment
+SteadyStateRandomWaypointMobilityModel::DoGetCurrentSegment (void) const
+{
+  // the helper moves in a straight line until the next scheduled event
+  m_helper.Update ();
+  return m_helper.GetSegment (m_event.IsRunning () ? TimeStep (m_event.GetTs ()) : Time::Max ());
+}
 int64_t
 SteadyStateRandomWaypointMobilityModel::DoAssignStreams (int64_t stream)
 {
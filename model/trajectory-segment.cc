@@ -0,0 +1,233 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include "ns3/assert.h"
+#include "trajectory-segment.h"
+
+namespace ns3 {
+
+TrajectorySegment::TrajectorySegment ()
+  : m_type (CONSTANT_POSITION),
+    m_start (Seconds (0.0)),
+    m_end (Seconds (0.0)),
+    m_position (Vector (0.0, 0.0, 0.0)),
+    m_velocity (Vector (0.0, 0.0, 0.0)),
+    m_acceleration (Vector (0.0, 0.0, 0.0)),
+    m_center (Vector2D (0.0, 0.0)),
+    m_radius (0.0),
+    m_theta (0.0),
+    m_rate (0.0)
+{
+}
+
+TrajectorySegment
+TrajectorySegment::ConstantPosition (const Time &start, const Time &end, const Vector &position)
+{
+  NS_ASSERT (start <= end);
+  TrajectorySegment segment;
+  segment.m_type = CONSTANT_POSITION;
+  segment.m_start = start;
+  segment.m_end = end;
+  segment.m_position = position;
+  return segment;
+}
+
+TrajectorySegment
+TrajectorySegment::ConstantVelocity (const Time &start, const Time &end,
+                                     const Vector &position, const Vector &velocity)
+{
+  TrajectorySegment segment = ConstantPosition (start, end, position);
+  segment.m_type = CONSTANT_VELOCITY;
+  segment.m_velocity = velocity;
+  return segment;
+}
+
+TrajectorySegment
+TrajectorySegment::ConstantAcceleration (const Time &start, const Time &end,
+                                         const Vector &position, const Vector &velocity,
+                                         const Vector &acceleration)
+{
+  TrajectorySegment segment = ConstantVelocity (start, end, position, velocity);
+  segment.m_type = CONSTANT_ACCELERATION;
+  segment.m_acceleration = acceleration;
+  return segment;
+}
+
+TrajectorySegment
+TrajectorySegment::CircularArc (const Time &start, const Time &end,
+                                const Vector2D &center, double radius,
+                                double theta, double rate, double z)
+{
+  NS_ASSERT (start <= end);
+  TrajectorySegment segment;
+  segment.m_type = CIRCULAR_ARC;
+  segment.m_start = start;
+  segment.m_end = end;
+  segment.m_center = center;
+  segment.m_radius = radius;
+  segment.m_theta = theta;
+  segment.m_rate = rate;
+  segment.m_position = segment.GetPositionAt (start);
+  segment.m_position.z = z;
+  segment.m_velocity = segment.GetVelocityAt (start);
+  return segment;
+}
+
+TrajectorySegment::Type
+TrajectorySegment::GetType (void) const
+{
+  return m_type;
+}
+
+Time
+TrajectorySegment::GetStart (void) const
+{
+  return m_start;
+}
+
+Time
+TrajectorySegment::GetEnd (void) const
+{
+  return m_end;
+}
+
+bool
+TrajectorySegment::IsValidAt (const Time &t) const
+{
+  return t >= m_start && t <= m_end;
+}
+
+Vector
+TrajectorySegment::GetPosition (void) const
+{
+  return m_position;
+}
+
+Vector
+TrajectorySegment::GetVelocity (void) const
+{
+  return m_velocity;
+}
+
+Vector
+TrajectorySegment::GetAcceleration (void) const
+{
+  return m_acceleration;
+}
+
+Vector2D
+TrajectorySegment::GetCenter (void) const
+{
+  return m_center;
+}
+
+double
+TrajectorySegment::GetRadius (void) const
+{
+  return m_radius;
+}
+
+double
+TrajectorySegment::GetTheta (void) const
+{
+  return m_theta;
+}
+
+double
+TrajectorySegment::GetAngularRate (void) const
+{
+  return m_rate;
+}
+
+Vector
+TrajectorySegment::GetPositionAt (const Time &t) const
+{
+  double dt = (t - m_start).GetSeconds ();
+  switch (m_type)
+    {
+    case CONSTANT_POSITION:
+      return m_position;
+    case CONSTANT_VELOCITY:
+      return Vector (m_position.x + m_velocity.x * dt,
+                     m_position.y + m_velocity.y * dt,
+                     m_position.z + m_velocity.z * dt);
+    case CONSTANT_ACCELERATION:
+      return Vector (m_position.x + (m_velocity.x + 0.5 * m_acceleration.x * dt) * dt,
+                     m_position.y + (m_velocity.y + 0.5 * m_acceleration.y * dt) * dt,
+                     m_position.z + (m_velocity.z + 0.5 * m_acceleration.z * dt) * dt);
+    case CIRCULAR_ARC:
+      {
+        double theta = m_theta + m_rate * dt;
+        return Vector (m_center.x + m_radius * std::cos (theta),
+                       m_center.y + m_radius * std::sin (theta),
+                       m_position.z);
+      }
+    }
+  NS_ASSERT_MSG (false, "Unknown segment type " << m_type);
+  return m_position;
+}
+
+Vector
+TrajectorySegment::GetVelocityAt (const Time &t) const
+{
+  double dt = (t - m_start).GetSeconds ();
+  switch (m_type)
+    {
+    case CONSTANT_POSITION:
+      return Vector (0.0, 0.0, 0.0);
+    case CONSTANT_VELOCITY:
+      return m_velocity;
+    case CONSTANT_ACCELERATION:
+      return Vector (m_velocity.x + m_acceleration.x * dt,
+                     m_velocity.y + m_acceleration.y * dt,
+                     m_velocity.z + m_acceleration.z * dt);
+    case CIRCULAR_ARC:
+      {
+        double theta = m_theta + m_rate * dt;
+        double speed = m_radius * m_rate;
+        return Vector (-speed * std::sin (theta), speed * std::cos (theta), 0.0);
+      }
+    }
+  NS_ASSERT_MSG (false, "Unknown segment type " << m_type);
+  return m_velocity;
+}
+
+std::ostream &
+operator << (std::ostream &os, const TrajectorySegment &segment)
+{
+  os << "[" << segment.GetStart ().GetSeconds () << "s, " << segment.GetEnd ().GetSeconds () << "s] ";
+  switch (segment.GetType ())
+    {
+    case TrajectorySegment::CONSTANT_POSITION:
+      os << "at " << segment.GetPosition ();
+      break;
+    case TrajectorySegment::CONSTANT_VELOCITY:
+      os << "from " << segment.GetPosition () << " velocity " << segment.GetVelocity ();
+      break;
+    case TrajectorySegment::CONSTANT_ACCELERATION:
+      os << "from " << segment.GetPosition () << " velocity " << segment.GetVelocity ()
+         << " acceleration " << segment.GetAcceleration ();
+      break;
+    case TrajectorySegment::CIRCULAR_ARC:
+      os << "arc center " << segment.GetCenter () << " radius " << segment.GetRadius ()
+         << " theta " << segment.GetTheta () << " rate " << segment.GetAngularRate ();
+      break;
+    }
+  return os;
+}
+
+} // namespace ns3
@@ -0,0 +1,182 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TRAJECTORY_SEGMENT_H
+#define TRAJECTORY_SEGMENT_H
+
+#include <ostream>
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief A piece of trajectory described in closed form.
+ *
+ * A segment tells how a node moves between a start time and an end time:
+ *  - CONSTANT_POSITION: the node stays at GetPosition (),
+ *  - CONSTANT_VELOCITY: the node is at p + v (t - start),
+ *  - CONSTANT_ACCELERATION: the node is at p + v (t - start) + a (t - start)^2 / 2,
+ *  - CIRCULAR_ARC: the node is at angle theta + rate (t - start) on the
+ *    horizontal circle of the given center and radius, at the altitude of
+ *    GetPosition ().
+ *
+ * p, v and a are the position, velocity and acceleration at the start time.
+ * The end time is the earliest time at which the motion may change, e.g.
+ * the next event of the mobility model; Time::Max () if it never does.
+ */
+class TrajectorySegment
+{
+public:
+  /// Kind of motion of a segment
+  enum Type
+  {
+    CONSTANT_POSITION,
+    CONSTANT_VELOCITY,
+    CONSTANT_ACCELERATION,
+    CIRCULAR_ARC
+  };
+
+  /**
+   * Create a segment standing at the origin, valid at time zero only.
+   */
+  TrajectorySegment ();
+
+  /**
+   * \param start the time from which the segment is valid
+   * \param end the time until which the segment is valid
+   * \param position the position of the node
+   * \return a segment standing still
+   */
+  static TrajectorySegment ConstantPosition (const Time &start, const Time &end, const Vector &position);
+  /**
+   * \param start the time from which the segment is valid
+   * \param end the time until which the segment is valid
+   * \param position the position at the start time
+   * \param velocity the velocity of the node
+   * \return a straight segment flown at constant speed
+   */
+  static TrajectorySegment ConstantVelocity (const Time &start, const Time &end,
+                                             const Vector &position, const Vector &velocity);
+  /**
+   * \param start the time from which the segment is valid
+   * \param end the time until which the segment is valid
+   * \param position the position at the start time
+   * \param velocity the velocity at the start time
+   * \param acceleration the acceleration of the node
+   * \return a parabolic segment
+   */
+  static TrajectorySegment ConstantAcceleration (const Time &start, const Time &end,
+                                                 const Vector &position, const Vector &velocity,
+                                                 const Vector &acceleration);
+  /**
+   * \param start the time from which the segment is valid
+   * \param end the time until which the segment is valid
+   * \param center the center of the circle
+   * \param radius the radius of the circle
+   * \param theta the angle of the node around the center at the start time
+   * \param rate the signed angular rate, in rad/s, positive counterclockwise
+   * \param z the altitude of the circle
+   * \return an arc flown at constant angular rate
+   */
+  static TrajectorySegment CircularArc (const Time &start, const Time &end,
+                                        const Vector2D &center, double radius,
+                                        double theta, double rate, double z);
+
+  /**
+   * \return the kind of motion
+   */
+  Type GetType (void) const;
+  /**
+   * \return the time from which the segment is valid
+   */
+  Time GetStart (void) const;
+  /**
+   * \return the time until which the segment is valid
+   */
+  Time GetEnd (void) const;
+  /**
+   * \param t a time
+   * \return true if t is between the start and the end of the segment
+   */
+  bool IsValidAt (const Time &t) const;
+  /**
+   * \return the position at the start time
+   */
+  Vector GetPosition (void) const;
+  /**
+   * \return the velocity at the start time
+   */
+  Vector GetVelocity (void) const;
+  /**
+   * \return the acceleration of a CONSTANT_ACCELERATION segment, zero
+   * for the other kinds
+   */
+  Vector GetAcceleration (void) const;
+  /**
+   * \return the center of a CIRCULAR_ARC segment
+   */
+  Vector2D GetCenter (void) const;
+  /**
+   * \return the radius of a CIRCULAR_ARC segment
+   */
+  double GetRadius (void) const;
+  /**
+   * \return the angle around the center at the start time of a
+   * CIRCULAR_ARC segment
+   */
+  double GetTheta (void) const;
+  /**
+   * \return the signed angular rate of a CIRCULAR_ARC segment, in rad/s
+   */
+  double GetAngularRate (void) const;
+
+  /**
+   * \param t a time at which the segment is valid
+   * \return the position of the node at time t
+   */
+  Vector GetPositionAt (const Time &t) const;
+  /**
+   * \param t a time at which the segment is valid
+   * \return the velocity of the node at time t
+   */
+  Vector GetVelocityAt (const Time &t) const;
+
+private:
+  Type m_type; //!< kind of motion
+  Time m_start; //!< start of validity
+  Time m_end; //!< end of validity
+  Vector m_position; //!< position at m_start
+  Vector m_velocity; //!< velocity at m_start
+  Vector m_acceleration; //!< acceleration of a parabolic segment
+  Vector2D m_center; //!< center of an arc
+  double m_radius; //!< radius of an arc
+  double m_theta; //!< angle of an arc at m_start
+  double m_rate; //!< angular rate of an arc
+};
+
+/**
+ * \brief Stream insertion operator.
+ *
+ * \param os the stream
+ * \param segment the segment
+ * \returns a reference to the stream
+ */
+std::ostream &operator << (std::ostream &os, const TrajectorySegment &segment);
+
+} // namespace ns3
+
+#endif /* TRAJECTORY_SEGMENT_H */
@@ -26,6 +26,7 @@
 #include "waypoint-mobility-model.h"
 #include "ns3/config.h"
 #include "ns3/test.h"
+#include "mobility-stats.h"
 
 namespace ns3 {
 
@@ -95,6 +96,7 @@ WaypointMobilityModel::AddWaypoint (const Waypoint &waypoint)
 
   if ( !m_lazyNotify )
     {
+      MOBILITY_STATS_COUNT (this, SCHEDULE);
       Simulator::Schedule (waypoint.time - Simulator::Now (), &WaypointMobilityModel::Update, this);
     }
 }
@@ -113,6 +115,7 @@ WaypointMobilityModel::WaypointsLeft (void) const
 void
 WaypointMobilityModel::Update (void) const
 {
+  MOBILITY_STATS_SCOPE (this, UPDATE);
   const Time now = Simulator::Now ();
   bool newWaypoint = false;
 
@@ -212,6 +215,24 @@ WaypointMobilityModel::DoGetVelocity (void) const
 {
   return m_velocity;
 }
+TrajectorySegment
+WaypointMobilityModel::DoGetCurrentSegment (void) const
+{
+  Update ();
+  const Time now = Simulator::Now ();
+  if ( now < m_current.time )
+    {
+      // waiting for the first waypoint
+      return TrajectorySegment::ConstantPosition (now, m_current.time, m_current.position);
+    }
+  if ( m_next.time > now )
+    {
+      return TrajectorySegment::ConstantVelocity (m_current.time, m_next.time, m_current.position, m_velocity);
+    }
+  // past the last waypoint
+  Time end = m_waypoints.empty () ? Time::Max () : Max (m_waypoints.front ().time, now);
+  return TrajectorySegment::ConstantPosition (m_current.time, end, m_current.position);
+}
 
 } // namespace ns3
 
@@ -156,6 +156,11 @@ private:
    * \return The velocity vector of a node. 
    */
   virtual Vector DoGetVelocity (void) const;
+  /**
+   * \brief Get the leg between the current and the next waypoint.
+   * \return the current segment of the trajectory
+   */
+  virtual TrajectorySegment DoGetCurrentSegment (void) const;
 
 protected:
   /**
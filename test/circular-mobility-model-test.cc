@@ -0,0 +1,989 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/constant-time-circular-motion-model.h"
+#include "ns3/semi-random-circular-mobility-model.h"
+#include "ns3/circular-swarm-mobility-manager.h"
+#include "ns3/circular-swarm-mobility-model.h"
+#include "ns3/pointer.h"
+#include "ns3/batch-sincos.h"
+#include "ns3/constant-angular-velocity-helper.h"
+#include "ns3/orbit-transition-table.h"
+#include "ns3/orbit-shell.h"
+#include "ns3/circular-encounter-predictor.h"
+#include "ns3/patrol-zone-registry.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/trajectory-segment.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/node.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check that the analytic mode of the constant time circular motion
+ * model changes course at the same times and places as the polling mode.
+ */
+class ConstantTimeCircularAnalyticTest : public TestCase
+{
+public:
+  ConstantTimeCircularAnalyticTest ()
+    : TestCase ("Check ConstantTimeCircularMotionModel analytic mode against polling mode")
+  {
+  }
+  virtual ~ConstantTimeCircularAnalyticTest ()
+  {
+  }
+
+private:
+  /// A course change as seen by the trace sink
+  struct Change
+  {
+    Time time; ///< time of the course change
+    Vector position; ///< position reported at the course change
+  };
+  std::vector<Change> m_polling; ///< course changes in polling mode
+  std::vector<Change> m_analytic; ///< course changes in analytic mode
+private:
+  virtual void DoRun (void);
+  /**
+   * Create a model in the given update mode
+   * \param mode the update mode
+   * \return the mobility model
+   */
+  Ptr<MobilityModel> CreateModel (ConstantTimeCircularMotionModel::UpdateMode mode);
+  /**
+   * Course change callback of the polling model
+   * \param model the mobility model
+   */
+  void PollingCourseChange (Ptr<const MobilityModel> model);
+  /**
+   * Course change callback of the analytic model
+   * \param model the mobility model
+   */
+  void AnalyticCourseChange (Ptr<const MobilityModel> model);
+};
+
+Ptr<MobilityModel>
+ConstantTimeCircularAnalyticTest::CreateModel (ConstantTimeCircularMotionModel::UpdateMode mode)
+{
+  ObjectFactory mobilityFactory;
+  mobilityFactory.SetTypeId ("ns3::ConstantTimeCircularMotionModel");
+  mobilityFactory.Set ("TangentialVelocity", DoubleValue (50.0));
+  mobilityFactory.Set ("RadialVelocity", DoubleValue (100.0));
+  mobilityFactory.Set ("Epsilon", DoubleValue (0.7));
+  mobilityFactory.Set ("UpdateMode", EnumValue (mode));
+  Ptr<MobilityModel> model = mobilityFactory.Create ()->GetObject<MobilityModel> ();
+  model->AssignStreams (1);
+  model->Initialize ();
+  return model;
+}
+
+void
+ConstantTimeCircularAnalyticTest::DoRun (void)
+{
+  Ptr<MobilityModel> polling = CreateModel (ConstantTimeCircularMotionModel::POLLING_MODE);
+  Ptr<MobilityModel> analytic = CreateModel (ConstantTimeCircularMotionModel::ANALYTIC_MODE);
+  polling->TraceConnectWithoutContext ("CourseChange", MakeCallback (&ConstantTimeCircularAnalyticTest::PollingCourseChange, this));
+  analytic->TraceConnectWithoutContext ("CourseChange", MakeCallback (&ConstantTimeCircularAnalyticTest::AnalyticCourseChange, this));
+  polling->SetPosition (Vector (225.0, 0.0, 0.0));
+  analytic->SetPosition (Vector (225.0, 0.0, 0.0));
+
+  Simulator::Stop (Seconds (500.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_GT (m_polling.size (), 0, "No orbit switch happened");
+  NS_TEST_ASSERT_MSG_EQ (m_analytic.size (), m_polling.size (), "Different number of course changes");
+  for (uint32_t i = 0; i < m_polling.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_analytic[i].time, m_polling[i].time, "Course changed at a different time");
+      NS_TEST_EXPECT_MSG_EQ_TOL (m_analytic[i].position.x, m_polling[i].position.x, 1e-3, "Course changed at a different x");
+      NS_TEST_EXPECT_MSG_EQ_TOL (m_analytic[i].position.y, m_polling[i].position.y, 1e-3, "Course changed at a different y");
+    }
+}
+
+void
+ConstantTimeCircularAnalyticTest::PollingCourseChange (Ptr<const MobilityModel> model)
+{
+  Change change;
+  change.time = Simulator::Now ();
+  change.position = model->GetPosition ();
+  m_polling.push_back (change);
+}
+
+void
+ConstantTimeCircularAnalyticTest::AnalyticCourseChange (Ptr<const MobilityModel> model)
+{
+  Change change;
+  change.time = Simulator::Now ();
+  change.position = model->GetPosition ();
+  m_analytic.push_back (change);
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check that GetPositionAt predicts the position later reported by
+ * GetPosition.
+ */
+class ConstantTimeCircularLookAheadTest : public TestCase
+{
+public:
+  ConstantTimeCircularLookAheadTest ()
+    : TestCase ("Check ConstantTimeCircularMotionModel look-ahead position")
+  {
+  }
+  virtual ~ConstantTimeCircularLookAheadTest ()
+  {
+  }
+
+private:
+  Ptr<ConstantTimeCircularMotionModel> m_model; ///< mobility model
+  uint32_t m_checks; ///< number of predictions checked
+  uint32_t m_stills; ///< number of frozen phase ends checked
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  /// Predict the position a few seconds ahead and schedule its check
+  void Predict (void);
+  /**
+   * Compare the current position with the prediction
+   * \param predicted the predicted position
+   */
+  void Check (Vector predicted);
+  /// Check that the drone stands still once the motion of its phase ended
+  void CheckStill (void);
+};
+
+void
+ConstantTimeCircularLookAheadTest::DoTeardown (void)
+{
+  m_model = 0;
+}
+
+void
+ConstantTimeCircularLookAheadTest::DoRun (void)
+{
+  m_checks = 0;
+  m_stills = 0;
+  m_model = CreateObjectWithAttributes<ConstantTimeCircularMotionModel> ("UpdateMode", EnumValue (ConstantTimeCircularMotionModel::ANALYTIC_MODE));
+  m_model->AssignStreams (1);
+  m_model->Initialize ();
+  m_model->SetPosition (Vector (150.0, 0.0, 0.0));
+  for (double t = 0.5; t < 200.0; t += 3.7)
+    {
+      Simulator::Schedule (Seconds (t), &ConstantTimeCircularLookAheadTest::Predict, this);
+    }
+  Simulator::Stop (Seconds (210.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_GT (m_checks, 0, "No prediction was checked");
+  NS_TEST_ASSERT_MSG_GT (m_stills, 0, "No frozen phase end was checked");
+}
+
+void
+ConstantTimeCircularLookAheadTest::Predict (void)
+{
+  Time at = Simulator::Now () + Seconds (2.0);
+  if (at >= m_model->GetNextDecisionTime ())
+    {
+      return;
+    }
+  Simulator::Schedule (Seconds (2.0), &ConstantTimeCircularLookAheadTest::Check, this, m_model->GetPositionAt (at));
+  // the motion of a phase stops on the last polling tick, before the decision
+  Time moving = m_model->GetCurrentSegment ().GetEnd ();
+  if (moving < m_model->GetNextDecisionTime ())
+    {
+      Simulator::Schedule (moving - Simulator::Now (), &ConstantTimeCircularLookAheadTest::CheckStill, this);
+    }
+}
+
+void
+ConstantTimeCircularLookAheadTest::CheckStill (void)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_model->GetCurrentSegment ().GetType (), TrajectorySegment::CONSTANT_POSITION,
+                         "The drone should stand still once its phase stopped moving");
+  Vector velocity = m_model->GetVelocity ();
+  NS_TEST_EXPECT_MSG_EQ ((velocity.x == 0.0 && velocity.y == 0.0 && velocity.z == 0.0), true,
+                         "A drone standing still should have no velocity");
+  m_stills++;
+}
+
+void
+ConstantTimeCircularLookAheadTest::Check (Vector predicted)
+{
+  Vector position = m_model->GetPosition ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (position.x, predicted.x, 1e-9, "Predicted x differs");
+  NS_TEST_EXPECT_MSG_EQ_TOL (position.y, predicted.y, 1e-9, "Predicted y differs");
+  m_checks++;
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check that the bulk swarm refresh agrees with the per-node facades
+ * and keeps drones on their orbits.
+ */
+class CircularSwarmMobilityTest : public TestCase
+{
+public:
+  CircularSwarmMobilityTest ()
+    : TestCase ("Check CircularSwarmMobilityManager bulk positions")
+  {
+  }
+  virtual ~CircularSwarmMobilityTest ()
+  {
+  }
+
+private:
+  Ptr<CircularSwarmMobilityManager> m_manager; ///< swarm manager
+  std::vector<Ptr<MobilityModel> > m_models; ///< per-node facades
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  /// Compare the bulk positions with the facades
+  void Check (void);
+};
+
+void
+CircularSwarmMobilityTest::DoTeardown (void)
+{
+  m_models.clear ();
+  m_manager = 0;
+}
+
+void
+CircularSwarmMobilityTest::DoRun (void)
+{
+  m_manager = CreateObject<CircularSwarmMobilityManager> ();
+  m_manager->AssignStreams (1);
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Ptr<MobilityModel> model = CreateObjectWithAttributes<CircularSwarmMobilityModel> ("Manager", PointerValue (m_manager));
+      double radius = 75.0 * (1 + i % 10);
+      double angle = 0.1 * i;
+      model->SetPosition (Vector (radius * std::cos (angle), radius * std::sin (angle), 0.0));
+      m_models.push_back (model);
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_manager->GetN (), 100, "Drones not registered with the manager");
+  for (double t = 0.3; t < 300.0; t += 7.1)
+    {
+      Simulator::Schedule (Seconds (t), &CircularSwarmMobilityTest::Check, this);
+    }
+  Simulator::Stop (Seconds (300.0));
+  Simulator::Run ();
+  m_manager->Dispose ();
+  Simulator::Destroy ();
+}
+
+void
+CircularSwarmMobilityTest::Check (void)
+{
+  std::vector<Vector> positions;
+  m_manager->GetPositions (positions);
+  NS_TEST_ASSERT_MSG_EQ (positions.size (), m_models.size (), "Wrong number of positions");
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      Vector position = m_models[i]->GetPosition ();
+      NS_TEST_EXPECT_MSG_EQ_TOL (positions[i].x, position.x, 1e-9, "Bulk x differs from the facade");
+      NS_TEST_EXPECT_MSG_EQ_TOL (positions[i].y, position.y, 1e-9, "Bulk y differs from the facade");
+      if (m_manager->GetPhaseType (i) == CircularSwarmMobilityManager::ORBIT_PHASE)
+        {
+          double radius = std::sqrt (position.x * position.x + position.y * position.y);
+          double orbit = radius / 75.0;
+          NS_TEST_EXPECT_MSG_EQ_TOL (orbit, std::round (orbit), 1e-6, "Drone is off its orbit");
+        }
+    }
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check the first course change of a swarm drone reports its position.
+ */
+class CircularSwarmFirstCourseChangeTest : public TestCase
+{
+public:
+  CircularSwarmFirstCourseChangeTest ()
+    : TestCase ("Check CircularSwarmMobilityModel first course change")
+  {
+  }
+  virtual ~CircularSwarmFirstCourseChangeTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Record the position reported to a course change sink
+   * \param model the model whose course changed
+   */
+  void CourseChange (Ptr<const MobilityModel> model);
+
+  std::vector<Vector> m_positions; ///< positions seen by the sink
+};
+
+void
+CircularSwarmFirstCourseChangeTest::CourseChange (Ptr<const MobilityModel> model)
+{
+  m_positions.push_back (model->GetPosition ());
+}
+
+void
+CircularSwarmFirstCourseChangeTest::DoRun (void)
+{
+  // every decision is a random flight to orbit 2, the orbit the drone starts on
+  Ptr<CircularSwarmMobilityManager> manager = CreateObjectWithAttributes<CircularSwarmMobilityManager> (
+      "Epsilon", DoubleValue (0.0), "OrbitChoice", StringValue ("ns3::ConstantRandomVariable[Constant=0.15]"));
+  manager->AssignStreams (1);
+  Ptr<MobilityModel> model = CreateObjectWithAttributes<CircularSwarmMobilityModel> ("Manager", PointerValue (manager),
+                                                                                     "CachePositions", BooleanValue (true));
+  model->TraceConnectWithoutContext ("CourseChange",
+                                     MakeCallback (&CircularSwarmFirstCourseChangeTest::CourseChange, this));
+  model->SetPosition (Vector (150.0, 0.0, 20.0));
+  NS_TEST_ASSERT_MSG_EQ (m_positions.size (), 1, "The registration should notify one course change");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_positions[0].x, 150.0, 1e-9, "The sink should see the new x");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_positions[0].z, 20.0, 1e-9, "The sink should see the new z");
+  Vector position = model->GetPosition ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (position.x, 150.0, 1e-9, "The origin should not be cached");
+
+  // staying in orbit restarts the orbit from a new anchor, which sinks must see
+  Simulator::Stop (Seconds (35.0));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_positions.size (), 4, "Each decision to stay in orbit should notify a course change");
+  NS_TEST_EXPECT_MSG_EQ (model->GetCurrentSegment ().GetStart (), Seconds (30.0), "Wrong start of the current orbit");
+  manager->Dispose ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check the batched sincos kernel against the scalar library.
+ */
+class BatchSinCosTest : public TestCase
+{
+public:
+  BatchSinCosTest ()
+    : TestCase ("Check BatchSinCos against std::sin and std::cos")
+  {
+  }
+  virtual ~BatchSinCosTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+};
+
+void
+BatchSinCosTest::DoRun (void)
+{
+  // an odd count exercises the scalar tail after the vector lanes
+  std::vector<double> angle;
+  for (double a = -50.0; a < 50.0; a += 0.0137)
+    {
+      angle.push_back (a);
+    }
+  angle.push_back (M_PI / 4);
+  angle.push_back (M_PI / 2);
+  angle.push_back (2 * M_PI);
+  std::vector<double> sine (angle.size ());
+  std::vector<double> cosine (angle.size ());
+  BatchSinCos (&angle[0], &sine[0], &cosine[0], angle.size ());
+  for (uint32_t i = 0; i < angle.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ_TOL (sine[i], std::sin (angle[i]), 1e-15, "Wrong sine of " << angle[i]);
+      NS_TEST_EXPECT_MSG_EQ_TOL (cosine[i], std::cos (angle[i]), 1e-15, "Wrong cosine of " << angle[i]);
+    }
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check that a ConstantAngularVelocityHelper updated at every
+ * polling tick stays on the closed-form orbit.
+ */
+class ConstantAngularVelocityDriftTest : public TestCase
+{
+public:
+  ConstantAngularVelocityDriftTest ()
+    : TestCase ("Check ConstantAngularVelocityHelper does not drift off its orbit")
+  {
+  }
+  virtual ~ConstantAngularVelocityDriftTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Update the helper and schedule the next update.
+   */
+  void Tick (void);
+
+  ConstantAngularVelocityHelper m_helper; ///< the helper under test
+};
+
+void
+ConstantAngularVelocityDriftTest::Tick (void)
+{
+  m_helper.Update ();
+  Simulator::Schedule (Seconds (0.1), &ConstantAngularVelocityDriftTest::Tick, this);
+}
+
+void
+ConstantAngularVelocityDriftTest::DoRun (void)
+{
+  double radius = 300.0;
+  double rate = 20.0 / radius;
+  m_helper.SetCenter (Vector2D (0.0, 0.0));
+  m_helper.SetPosition (Vector (radius, 0.0, 10.0));
+  m_helper.SetOmega (Vector2D (1.0, rate));
+  m_helper.Unpause ();
+  // the same orbit from other angles, only brought up to date by one batch
+  ConstantAngularVelocityHelper batch[3];
+  ConstantAngularVelocityHelper *helpers[3];
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      double phase = 2.0 * i;
+      batch[i].SetCenter (Vector2D (0.0, 0.0));
+      batch[i].SetPosition (Vector (radius * std::cos (phase), radius * std::sin (phase), 10.0));
+      batch[i].SetOmega (Vector2D (1.0, rate));
+      batch[i].Unpause ();
+      helpers[i] = &batch[i];
+    }
+  Simulator::Schedule (Seconds (0.1), &ConstantAngularVelocityDriftTest::Tick, this);
+  Simulator::Stop (Seconds (3600.05));
+  Simulator::Run ();
+
+  Vector position = m_helper.GetCurrentPosition ();
+  double theta = 3600.0 * rate;
+  NS_TEST_EXPECT_MSG_EQ_TOL (position.x, radius * std::cos (theta), 1e-6, "Drifted along x");
+  NS_TEST_EXPECT_MSG_EQ_TOL (position.y, radius * std::sin (theta), 1e-6, "Drifted along y");
+  NS_TEST_EXPECT_MSG_EQ_TOL (std::sqrt (position.x * position.x + position.y * position.y), radius, 1e-9,
+                             "Radius crept");
+
+  std::vector<double> scratch;
+  ConstantAngularVelocityHelper::UpdateBatch (helpers, 3, scratch);
+  NS_TEST_EXPECT_MSG_EQ (scratch.size (), 9, "The scratch buffer should hold three values per helper");
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Vector actual = batch[i].GetCurrentPosition ();
+      double angle = 2.0 * i + theta;
+      NS_TEST_EXPECT_MSG_EQ_TOL (actual.x, radius * std::cos (angle), 1e-6, "Wrong batch x of helper " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (actual.y, radius * std::sin (angle), 1e-6, "Wrong batch y of helper " << i);
+    }
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check the compiled orbit transition law and its stationary
+ * distribution against a sampled orbit chain.
+ */
+class OrbitTransitionTableTest : public TestCase
+{
+public:
+  OrbitTransitionTableTest ()
+    : TestCase ("Check OrbitTransitionTable against the orbit decision law")
+  {
+  }
+  virtual ~OrbitTransitionTableTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+};
+
+void
+OrbitTransitionTableTest::DoRun (void)
+{
+  OrbitTransitionTable table;
+  table.Configure (75.0, 750.0);
+  uint32_t n = table.GetNOrbits ();
+  NS_TEST_ASSERT_MSG_EQ (n, 10, "Wrong number of orbits");
+
+  // spot checks of the law documented in the model
+  double speedFactor;
+  NS_TEST_EXPECT_MSG_EQ (table.SampleWalk (1, 0.5, speedFactor), 2, "First orbit moves out");
+  NS_TEST_EXPECT_MSG_EQ (table.SampleWalk (1, 0.51, speedFactor), 1, "First orbit stays");
+  NS_TEST_EXPECT_MSG_EQ (table.SampleWalk (4, 0.8, speedFactor), 3, "Middle orbit moves in");
+  NS_TEST_EXPECT_MSG_EQ (table.SampleWalk (4, 0.9, speedFactor), 4, "Middle orbit stays");
+  NS_TEST_EXPECT_MSG_EQ (table.SampleWalk (10, 0.3, speedFactor), 8, "Outer orbit jumps in");
+  NS_TEST_EXPECT_MSG_EQ (speedFactor, 2.0, "Jump is flown at twice the radial speed");
+  NS_TEST_EXPECT_MSG_EQ (table.SampleFlight (0.0), 1, "Flight to the first orbit");
+  NS_TEST_EXPECT_MSG_EQ (table.SampleFlight (1.0), 10, "Flight to the last orbit");
+  NS_TEST_EXPECT_MSG_EQ_TOL (table.GetWalkProbability (4, 4), 1.0 / 8, 1e-12, "Wrong stay probability");
+  NS_TEST_EXPECT_MSG_EQ_TOL (table.GetWalkProbability (10, 8), 0.4, 1e-12, "Wrong jump probability");
+
+  double epsilon = 0.9;
+  for (uint32_t i = 0; i <= n; i++)
+    {
+      double total = 0.0;
+      for (uint32_t j = 0; j <= n; j++)
+        {
+          total += table.GetTransitionProbability (i, j, epsilon);
+        }
+      NS_TEST_EXPECT_MSG_EQ_TOL (total, 1.0, 1e-12, "Row " << i << " is not a distribution");
+    }
+
+  // run the chain and compare the orbit occupancy with the stationary distribution
+  std::vector<double> stationary = table.GetStationaryDistribution (epsilon);
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  uniform->SetStream (1);
+  std::vector<double> visits (n + 1, 0.0);
+  uint32_t steps = 200000;
+  int orbit = 1;
+  for (uint32_t k = 0; k < steps; k++)
+    {
+      double coinFlip = uniform->GetValue ();
+      double rand = uniform->GetValue ();
+      orbit = coinFlip >= epsilon ? table.SampleFlight (rand) : table.SampleWalk (orbit, rand, speedFactor);
+      visits[orbit] += 1.0 / steps;
+    }
+  for (uint32_t i = 0; i <= n; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ_TOL (visits[i], stationary[i], 0.01, "Orbit " << i << " occupancy");
+    }
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check that SemiRandomCircularMobilityModel switches orbits
+ * exactly at its exchange point.
+ */
+class SemiRandomExchangePointTest : public TestCase
+{
+public:
+  SemiRandomExchangePointTest ()
+    : TestCase ("Check SemiRandomCircularMobilityModel exchange point arrival")
+  {
+  }
+  virtual ~SemiRandomExchangePointTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Record the first course change after the start
+   * \param model the mobility model
+   */
+  void CourseChange (Ptr<const MobilityModel> model);
+
+  uint32_t m_changes; ///< number of course changes seen
+  Time m_switchTime; ///< time of the first course change
+  Vector m_switchPosition; ///< position at the first course change
+};
+
+void
+SemiRandomExchangePointTest::CourseChange (Ptr<const MobilityModel> model)
+{
+  if (m_changes++ == 0)
+    {
+      m_switchTime = Simulator::Now ();
+      m_switchPosition = model->GetPosition ();
+    }
+}
+
+void
+SemiRandomExchangePointTest::DoRun (void)
+{
+  m_changes = 0;
+  double radius = 150.0;
+  double theta = 0.3;
+  Ptr<SemiRandomCircularMobilityModel> model = CreateObjectWithAttributes<SemiRandomCircularMobilityModel> (
+      "ExchangePoints", DoubleValue (4.0), "TangentialVelocity", DoubleValue (5.0));
+  model->AssignStreams (1);
+  model->SetPosition (Vector (radius * std::cos (theta), radius * std::sin (theta), 0.0));
+  model->TraceConnectWithoutContext ("CourseChange", MakeCallback (&SemiRandomExchangePointTest::CourseChange, this));
+  // the drone on orbit 150 flies clockwise: one revolution, then back to angle 0
+  double expected = (2 * M_PI + theta) * radius / 5.0;
+  NS_TEST_EXPECT_MSG_EQ_TOL (model->GetNextDecisionTime ().GetSeconds (), expected, 1e-6, "Wrong decision time");
+  Simulator::Stop (Seconds (expected + 1.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_GT (m_changes, 0, "The drone never left its orbit");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_switchTime.GetSeconds (), expected, 1e-6, "Orbit switch off its exchange point time");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_switchPosition.x, radius, 1e-6, "Orbit switch off its exchange point");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_switchPosition.y, 0.0, 1e-6, "Orbit switch off its exchange point");
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check the look-ahead of SemiRandomCircularMobilityModel on its
+ * orbits and radial legs against the positions actually reached, and that a
+ * random flight, which stops the drone, has no next decision.
+ */
+class SemiRandomLookAheadTest : public TestCase
+{
+public:
+  SemiRandomLookAheadTest ()
+    : TestCase ("Check SemiRandomCircularMobilityModel look-ahead position")
+  {
+  }
+  virtual ~SemiRandomLookAheadTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  /// Predict the position two seconds ahead and schedule its check
+  void Predict (void);
+  /**
+   * Compare the current position with the prediction
+   * \param predicted the predicted position
+   */
+  void Check (Vector predicted);
+
+  Ptr<SemiRandomCircularMobilityModel> m_model; ///< mobility model
+  uint32_t m_orbitChecks; ///< number of predictions checked along an orbit
+  uint32_t m_legChecks; ///< number of predictions checked along a radial leg
+  bool m_onOrbit; ///< the last prediction was made along an orbit
+};
+
+void
+SemiRandomLookAheadTest::DoTeardown (void)
+{
+  m_model = 0;
+}
+
+void
+SemiRandomLookAheadTest::Predict (void)
+{
+  Time at = Simulator::Now () + Seconds (2.0);
+  if (at >= m_model->GetNextDecisionTime ())
+    {
+      return;
+    }
+  ConstantAngularVelocityHelper phase;
+  m_onOrbit = m_model->GetOrbitPhase (phase);
+  Simulator::Schedule (Seconds (2.0), &SemiRandomLookAheadTest::Check, this, m_model->GetPositionAt (at));
+}
+
+void
+SemiRandomLookAheadTest::Check (Vector predicted)
+{
+  Vector position = m_model->GetPosition ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (position.x, predicted.x, 1e-9, "Predicted x differs");
+  NS_TEST_EXPECT_MSG_EQ_TOL (position.y, predicted.y, 1e-9, "Predicted y differs");
+  NS_TEST_EXPECT_MSG_EQ_TOL (position.z, predicted.z, 1e-9, "Predicted z differs");
+  if (m_onOrbit)
+    {
+      m_orbitChecks++;
+    }
+  else
+    {
+      m_legChecks++;
+    }
+}
+
+void
+SemiRandomLookAheadTest::DoRun (void)
+{
+  m_orbitChecks = 0;
+  m_legChecks = 0;
+  m_model = CreateObjectWithAttributes<SemiRandomCircularMobilityModel> (
+      "ExchangePoints", DoubleValue (4.0), "TangentialVelocity", DoubleValue (5.0),
+      "RadialVelocity", DoubleValue (1.0),
+      "AltitudeStep", DoubleValue (20.0), "BaseAltitude", DoubleValue (100.0));
+  m_model->AssignStreams (1);
+  // orbit 2, on the altitude of its shell
+  m_model->SetPosition (Vector (150.0, 0.0, 140.0));
+  ConstantAngularVelocityHelper phase;
+  NS_TEST_EXPECT_MSG_EQ (m_model->GetOrbitPhase (phase), true, "The drone should start on its orbit");
+  // one revolution, the drone starts on an exchange point
+  Time decision = m_model->GetNextDecisionTime ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (decision.GetSeconds (), 2 * M_PI * 150.0 / 5.0, 1e-6, "Wrong decision time");
+  for (double t = 0.5; t < decision.GetSeconds () + 75.0; t += 0.9)
+    {
+      Simulator::Schedule (Seconds (t), &SemiRandomLookAheadTest::Predict, this);
+    }
+  Simulator::Stop (decision + Seconds (75.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_GT (m_orbitChecks, 0, "No prediction was checked along the orbit");
+  NS_TEST_EXPECT_MSG_GT (m_legChecks, 0, "No prediction was checked along the radial leg");
+
+  // a random flight leaves the drone where it is, with no decision to come
+  Ptr<SemiRandomCircularMobilityModel> flight = CreateObjectWithAttributes<SemiRandomCircularMobilityModel> (
+      "ExchangePoints", DoubleValue (4.0), "TangentialVelocity", DoubleValue (5.0),
+      "Mode", EnumValue (SemiRandomCircularMobilityModel::RANDOM_FLIGHT_MODE));
+  flight->AssignStreams (1);
+  flight->SetPosition (Vector (150.0, 0.0, 0.0));
+  decision = flight->GetNextDecisionTime ();
+  Simulator::Stop (decision + Seconds (1.0));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (flight->GetNextDecisionTime (), Time::Max (), "A random flight should not decide again");
+  NS_TEST_EXPECT_MSG_EQ (flight->GetOrbitPhase (phase), false, "A stopped drone is not on an orbit");
+  Vector position = flight->GetPosition ();
+  Vector later = flight->GetPositionAt (Simulator::Now () + Seconds (1000.0));
+  NS_TEST_EXPECT_MSG_EQ_TOL (later.x, position.x, 1e-9, "A random flight should not move the drone");
+  NS_TEST_EXPECT_MSG_EQ_TOL (later.y, position.y, 1e-9, "A random flight should not move the drone");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check that the predicted encounters of two drones on concentric
+ * orbits happen at the communication range.
+ */
+class CircularEncounterPredictorTest : public TestCase
+{
+public:
+  CircularEncounterPredictorTest ()
+    : TestCase ("Check CircularEncounterPredictor contact windows")
+  {
+  }
+  virtual ~CircularEncounterPredictorTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Record the distance of the drones when they come within range
+   * \param a the first drone
+   * \param b the second drone
+   */
+  void EncounterStart (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b);
+  /**
+   * Record the distance of the drones when they go out of range
+   * \param a the first drone
+   * \param b the second drone
+   */
+  void EncounterEnd (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b);
+
+  uint32_t m_starts; ///< number of contact windows started
+  uint32_t m_ends; ///< number of contact windows ended
+  double m_range; ///< communication range
+};
+
+void
+CircularEncounterPredictorTest::EncounterStart (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b)
+{
+  m_starts++;
+  NS_TEST_EXPECT_MSG_EQ_TOL (a->GetDistanceFrom (b), m_range, 1e-3, "Contact started out of range");
+}
+
+void
+CircularEncounterPredictorTest::EncounterEnd (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b)
+{
+  m_ends++;
+  NS_TEST_EXPECT_MSG_EQ_TOL (a->GetDistanceFrom (b), m_range, 1e-3, "Contact ended out of range");
+}
+
+void
+CircularEncounterPredictorTest::DoRun (void)
+{
+  m_starts = 0;
+  m_ends = 0;
+  m_range = 100.0;
+  // orbits 150 and 225 are flown in opposite directions
+  Ptr<SemiRandomCircularMobilityModel> inner = CreateObject<SemiRandomCircularMobilityModel> ();
+  Ptr<SemiRandomCircularMobilityModel> outer = CreateObject<SemiRandomCircularMobilityModel> ();
+  inner->SetPosition (Vector (150.0, 0.0, 0.0));
+  outer->SetPosition (Vector (0.0, 225.0, 0.0));
+  Ptr<CircularEncounterPredictor> predictor = CreateObjectWithAttributes<CircularEncounterPredictor> ("Range", DoubleValue (m_range));
+  predictor->TraceConnectWithoutContext ("EncounterStart", MakeCallback (&CircularEncounterPredictorTest::EncounterStart, this));
+  predictor->TraceConnectWithoutContext ("EncounterEnd", MakeCallback (&CircularEncounterPredictorTest::EncounterEnd, this));
+  predictor->Add (inner);
+  predictor->Add (outer);
+  NS_TEST_EXPECT_MSG_EQ (predictor->IsInContact (0, 1), false, "Drones start out of range");
+  NS_TEST_EXPECT_MSG_NE (predictor->GetNextContactChange (0, 1), Time::Max (), "No contact predicted");
+  // both drones stay on their orbit for more than a full revolution
+  Simulator::Stop (Seconds (180.0));
+  Simulator::Run ();
+  predictor->Dispose ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_GT (m_starts, 1, "Too few contact windows");
+  NS_TEST_EXPECT_MSG_GT (m_ends, 1, "Too few contact windows");
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check zone lookup and zone transit of the PatrolZoneRegistry.
+ */
+class PatrolZoneRegistryTest : public TestCase
+{
+public:
+  PatrolZoneRegistryTest ()
+    : TestCase ("Check PatrolZoneRegistry lookup and transit")
+  {
+  }
+  virtual ~PatrolZoneRegistryTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+};
+
+void
+PatrolZoneRegistryTest::DoRun (void)
+{
+  Ptr<PatrolZoneRegistry> registry = CreateObjectWithAttributes<PatrolZoneRegistry> ("CellSize", DoubleValue (500.0));
+  uint32_t home = registry->AddZone (Vector2D (0.0, 0.0), 75.0, 750.0);
+  uint32_t away = registry->AddZone (Vector2D (3000.0, 0.0), 50.0, 500.0);
+  registry->AddZone (Vector2D (0.0, 5000.0), 75.0, 750.0);
+  NS_TEST_EXPECT_MSG_EQ (registry->FindZone (Vector (100.0, -200.0, 0.0)), 0, "Wrong zone");
+  NS_TEST_EXPECT_MSG_EQ (registry->FindZone (Vector (3400.0, 100.0, 0.0)), 1, "Wrong zone");
+  NS_TEST_EXPECT_MSG_EQ (registry->FindZone (Vector (1500.0, 0.0, 0.0)), -1, "Position between zones");
+
+  Ptr<ConstantTimeCircularMotionModel> model = CreateObject<ConstantTimeCircularMotionModel> ();
+  model->AssignStreams (1);
+  registry->Assign (model, home);
+  model->SetPosition (Vector (150.0, 0.0, 0.0));
+  NS_TEST_EXPECT_MSG_EQ (registry->GetZoneOf (model), 0, "Drone not assigned");
+  Simulator::Schedule (Seconds (5.0), &PatrolZoneRegistry::Transit, registry, model, away);
+  // 2100 m or so to fly at 10 m/s, then patrol the new zone for a while
+  Simulator::Stop (Seconds (400.0));
+  Simulator::Run ();
+  Vector position = model->GetPosition ();
+  NS_TEST_EXPECT_MSG_EQ (registry->GetZoneOf (model), 1, "Drone not moved to the new zone");
+  NS_TEST_EXPECT_MSG_EQ (registry->GetNDrones (home), 0, "Drone still listed in its old zone");
+  NS_TEST_EXPECT_MSG_EQ (registry->FindZone (position), 1, "Drone did not reach the new zone");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check that ConstantTimeCircularMotionModel flies every orbit at
+ * the altitude of its shell.
+ */
+class ConstantTimeCircularShellTest : public TestCase
+{
+public:
+  ConstantTimeCircularShellTest ()
+    : TestCase ("Check ConstantTimeCircularMotionModel stacked shells")
+  {
+  }
+  virtual ~ConstantTimeCircularShellTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check the altitude of the drone when it starts an orbit
+   * \param model the mobility model
+   */
+  void CourseChange (Ptr<const MobilityModel> model);
+
+  uint32_t m_orbits; ///< number of orbit phases checked
+};
+
+void
+ConstantTimeCircularShellTest::CourseChange (Ptr<const MobilityModel> model)
+{
+  Ptr<const ConstantTimeCircularMotionModel> drone = DynamicCast<const ConstantTimeCircularMotionModel> (model);
+  ConstantAngularVelocityHelper phase;
+  if (!drone->GetOrbitPhase (phase))
+    {
+      return;
+    }
+  m_orbits++;
+  double orbit = std::round (phase.GetRadius () / 75.0);
+  NS_TEST_EXPECT_MSG_EQ_TOL (model->GetPosition ().z, 100.0 + 20.0 * orbit, 1e-6, "Orbit flown off its shell");
+}
+
+void
+ConstantTimeCircularShellTest::DoRun (void)
+{
+  NS_TEST_EXPECT_MSG_EQ_TOL (GetOrbitShellClimbRate (140.0, 100.0, 20.0, 3, 10.0), 2.0, 1e-12, "Wrong climb rate");
+  NS_TEST_EXPECT_MSG_EQ (GetOrbitShellClimbRate (140.0, 100.0, 0.0, 3, 10.0), 0.0, "Flat orbits do not climb");
+  NS_TEST_EXPECT_MSG_EQ (GetOrbitShellClimbRate (140.0, 100.0, 20.0, 3, 0.0), 0.0, "Empty legs do not climb");
+  EnumValue modes[] = {EnumValue (ConstantTimeCircularMotionModel::POLLING_MODE),
+                       EnumValue (ConstantTimeCircularMotionModel::ANALYTIC_MODE)};
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      m_orbits = 0;
+      Ptr<ConstantTimeCircularMotionModel> model = CreateObjectWithAttributes<ConstantTimeCircularMotionModel> (
+          "UpdateMode", modes[i], "AltitudeStep", DoubleValue (20.0), "BaseAltitude", DoubleValue (100.0));
+      model->AssignStreams (1);
+      model->Initialize ();
+      model->TraceConnectWithoutContext ("CourseChange", MakeCallback (&ConstantTimeCircularShellTest::CourseChange, this));
+      // SetPosition does not snap the altitude: start on the shell of orbit 3
+      model->SetPosition (Vector (225.0, 0.0, 160.0));
+      NS_TEST_EXPECT_MSG_EQ_TOL (model->GetPosition ().z, 160.0, 1e-12, "The initial altitude should be kept");
+      Simulator::Stop (Seconds (500.0));
+      Simulator::Run ();
+      Simulator::Destroy ();
+      NS_TEST_EXPECT_MSG_GT (m_orbits, 5, "Too few orbits flown");
+    }
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Circular Mobility Model Test Suite
+ */
+static struct CircularMobilityModelTestSuite : public TestSuite
+{
+  CircularMobilityModelTestSuite () : TestSuite ("circular-mobility-model", UNIT)
+  {
+    AddTestCase (new ConstantTimeCircularAnalyticTest (), TestCase::QUICK);
+    AddTestCase (new ConstantTimeCircularLookAheadTest (), TestCase::QUICK);
+    AddTestCase (new CircularSwarmMobilityTest (), TestCase::QUICK);
+    AddTestCase (new CircularSwarmFirstCourseChangeTest (), TestCase::QUICK);
+    AddTestCase (new BatchSinCosTest (), TestCase::QUICK);
+    AddTestCase (new ConstantAngularVelocityDriftTest (), TestCase::QUICK);
+    AddTestCase (new OrbitTransitionTableTest (), TestCase::QUICK);
+    AddTestCase (new SemiRandomExchangePointTest (), TestCase::QUICK);
+    AddTestCase (new SemiRandomLookAheadTest (), TestCase::QUICK);
+    AddTestCase (new CircularEncounterPredictorTest (), TestCase::QUICK);
+    AddTestCase (new PatrolZoneRegistryTest (), TestCase::QUICK);
+    AddTestCase (new ConstantTimeCircularShellTest (), TestCase::QUICK);
+  }
+} g_circularMobilityModelTestSuite; ///< the test suite
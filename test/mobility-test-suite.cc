@@ -23,14 +23,39 @@
  * involved).
  */
 
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <sstream>
+#include <vector>
 #include "ns3/test.h"
 #include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
 #include "ns3/simulator.h"
 #include "ns3/scheduler.h"
 #include "ns3/vector.h"
 #include "ns3/mobility-model.h"
 #include "ns3/waypoint-mobility-model.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
 #include "ns3/mobility-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/pointer.h"
+#include "ns3/circular-swarm-mobility-manager.h"
+#include "ns3/circular-swarm-mobility-model.h"
+#include "ns3/semi-random-circular-mobility-model.h"
+#include "ns3/enum.h"
+#include "ns3/constant-time-circular-motion-model.h"
+#include "ns3/trajectory-segment.h"
+#include "ns3/constant-acceleration-mobility-model.h"
+#include "ns3/course-change-aggregator.h"
+#include "ns3/mobility-stats.h"
+#include "ns3/mobility-neighbor-index.h"
+#include "ns3/kinetic-range-monitor.h"
+#include "ns3/pairwise-kinematics.h"
+#include "ns3/mobility-snapshot.h"
 
 using namespace ns3;
 
@@ -410,6 +435,1132 @@ WaypointMobilityModelViaHelper::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Bulk install of MobilityHelper
+ *
+ * Check that InstallBulk gives the nodes the same models and positions as
+ * Install, keeps the models already aggregated and reports its phases.
+ */
+class MobilityInstallBulkTest : public TestCase
+{
+public:
+  MobilityInstallBulkTest ()
+    : TestCase ("Check MobilityHelper::InstallBulk matches Install")
+  {
+  }
+  virtual ~MobilityInstallBulkTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+};
+
+void
+MobilityInstallBulkTest::DoRun (void)
+{
+  NodeContainer reference;
+  NodeContainer bulk;
+  reference.Create (10);
+  bulk.Create (10);
+  Ptr<ConstantPositionMobilityModel> existing = CreateObject<ConstantPositionMobilityModel> ();
+  bulk.Get (3)->AggregateObject (existing);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "MinX", DoubleValue (1.0),
+                                 "MinY", DoubleValue (2.0),
+                                 "DeltaX", DoubleValue (5.0),
+                                 "DeltaY", DoubleValue (7.0),
+                                 "GridWidth", UintegerValue (4),
+                                 "LayoutType", StringValue ("ColumnFirst"));
+  mobility.Install (reference);
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "MinX", DoubleValue (1.0),
+                                 "MinY", DoubleValue (2.0),
+                                 "DeltaX", DoubleValue (5.0),
+                                 "DeltaY", DoubleValue (7.0),
+                                 "GridWidth", UintegerValue (4),
+                                 "LayoutType", StringValue ("ColumnFirst"));
+  MobilityHelper::InstallTiming timing = mobility.InstallBulk (bulk);
+
+  NS_TEST_EXPECT_MSG_EQ (timing.created, 9, "Nodes with a model should keep it");
+  NS_TEST_EXPECT_MSG_EQ ((timing.create >= 0.0 && timing.aggregate >= 0.0 && timing.position >= 0.0), true,
+                         "Phase times should not be negative");
+  NS_TEST_EXPECT_MSG_EQ (bulk.Get (3)->GetObject<MobilityModel> (), existing, "The existing model should be kept");
+  for (uint32_t i = 0; i < bulk.GetN (); i++)
+    {
+      Ptr<MobilityModel> model = bulk.Get (i)->GetObject<MobilityModel> ();
+      NS_TEST_ASSERT_MSG_NE (model, 0, "Every node should have a model");
+      if (i != 3)
+        {
+          NS_TEST_EXPECT_MSG_EQ (model->GetInstanceTypeId (), ConstantVelocityMobilityModel::GetTypeId (), "Wrong model type");
+        }
+      Vector expected = reference.Get (i)->GetObject<MobilityModel> ()->GetPosition ();
+      Vector actual = model->GetPosition ();
+      NS_TEST_EXPECT_MSG_EQ_TOL (actual.x, expected.x, 1e-12, "Wrong x for node " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (actual.y, expected.y, 1e-12, "Wrong y for node " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (actual.z, expected.z, 1e-12, "Wrong z for node " << i);
+    }
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check MobilityModel::GetPositions against per-model queries on
+ * a list mixing swarm drones and other models.
+ */
+class MobilityModelGetPositionsTest : public TestCase
+{
+public:
+  MobilityModelGetPositionsTest ()
+    : TestCase ("Check MobilityModel::GetPositions batch snapshot")
+  {
+  }
+  virtual ~MobilityModelGetPositionsTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Compare the batch snapshot with GetPosition and GetVelocity
+   */
+  void Check (void);
+
+  std::vector<Ptr<MobilityModel> > m_models; ///< models to snapshot
+};
+
+void
+MobilityModelGetPositionsTest::Check (void)
+{
+  std::vector<Vector> positions (m_models.size ());
+  std::vector<Vector> velocities (m_models.size ());
+  MobilityModel::GetPositions (&m_models[0], m_models.size (), &positions[0], &velocities[0]);
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      Vector position = m_models[i]->GetPosition ();
+      Vector velocity = m_models[i]->GetVelocity ();
+      NS_TEST_EXPECT_MSG_EQ_TOL (positions[i].x, position.x, 1e-9, "Wrong x of model " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (positions[i].y, position.y, 1e-9, "Wrong y of model " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (positions[i].z, position.z, 1e-9, "Wrong z of model " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (velocities[i].x, velocity.x, 1e-9, "Wrong velocity of model " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (velocities[i].y, velocity.y, 1e-9, "Wrong velocity of model " << i);
+    }
+}
+
+void
+MobilityModelGetPositionsTest::DoRun (void)
+{
+  Ptr<CircularSwarmMobilityManager> managers[2];
+  for (uint32_t m = 0; m < 2; m++)
+    {
+      managers[m] = CreateObjectWithAttributes<CircularSwarmMobilityManager> ("Center", Vector2DValue (Vector2D (1000.0 * m, 0.0)));
+      managers[m]->AssignStreams (10 * m);
+    }
+  for (uint32_t i = 0; i < 12; i++)
+    {
+      if (i % 5 == 4)
+        {
+          Ptr<ConstantPositionMobilityModel> still = CreateObject<ConstantPositionMobilityModel> ();
+          still->SetPosition (Vector (i, 2.0 * i, 3.0));
+          m_models.push_back (still);
+          continue;
+        }
+      Ptr<CircularSwarmMobilityManager> manager = managers[(i / 3) % 2];
+      Ptr<CircularSwarmMobilityModel> drone = CreateObjectWithAttributes<CircularSwarmMobilityModel> ("Manager", PointerValue (manager));
+      Vector2D center = Vector2D (manager == managers[0] ? 0.0 : 1000.0, 0.0);
+      drone->SetPosition (Vector (center.x + 75.0 * (1 + i % 4), center.y, 10.0));
+      m_models.push_back (drone);
+    }
+  for (double t = 1.0; t < 60.0; t += 7.3)
+    {
+      Simulator::Schedule (Seconds (t), &MobilityModelGetPositionsTest::Check, this);
+    }
+  Simulator::Stop (Seconds (60.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  for (uint32_t m = 0; m < 2; m++)
+    {
+      managers[m]->Dispose ();
+    }
+  m_models.clear ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check that a drone with CachePositions set follows the same
+ * trajectory as its uncached twin, and that the cache is only hit within a
+ * timestamp.
+ */
+class MobilityModelCacheTest : public TestCase
+{
+public:
+  MobilityModelCacheTest ()
+    : TestCase ("Check MobilityModel position memoization")
+  {
+  }
+  virtual ~MobilityModelCacheTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Query both drones twice and compare them
+   */
+  void Check (void);
+  /**
+   * Move the cached drone within a timestamp
+   */
+  void CheckSetPosition (void);
+
+  Ptr<MobilityModel> m_cached; ///< drone with the cache enabled
+  Ptr<MobilityModel> m_plain; ///< drone without cache
+  uint32_t m_checks; ///< number of checks done
+};
+
+void
+MobilityModelCacheTest::Check (void)
+{
+  m_checks++;
+  for (uint32_t k = 0; k < 2; k++)
+    {
+      Vector cached = m_cached->GetPosition ();
+      Vector plain = m_plain->GetPosition ();
+      NS_TEST_EXPECT_MSG_EQ_TOL (cached.x, plain.x, 1e-9, "Cached x off the trajectory");
+      NS_TEST_EXPECT_MSG_EQ_TOL (cached.y, plain.y, 1e-9, "Cached y off the trajectory");
+      NS_TEST_EXPECT_MSG_EQ_TOL (m_cached->GetVelocity ().x, m_plain->GetVelocity ().x, 1e-9, "Cached velocity off the trajectory");
+    }
+}
+
+void
+MobilityModelCacheTest::CheckSetPosition (void)
+{
+  m_cached->GetPosition ();
+  uint64_t misses = m_cached->GetCacheMisses ();
+  m_cached->SetPosition (Vector (225.0, 0.0, 0.0));
+  Vector position = m_cached->GetPosition ();
+  NS_TEST_EXPECT_MSG_EQ (m_cached->GetCacheMisses (), misses + 1, "SetPosition did not clear the cache");
+  NS_TEST_EXPECT_MSG_EQ_TOL (position.x, 225.0, 1e-6, "Stale position after SetPosition");
+}
+
+void
+MobilityModelCacheTest::DoRun (void)
+{
+  m_checks = 0;
+  Ptr<MobilityModel> models[2];
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      models[i] = CreateObjectWithAttributes<SemiRandomCircularMobilityModel> (
+          "ExchangePoints", DoubleValue (4.0), "TangentialVelocity", DoubleValue (5.0),
+          "CachePositions", BooleanValue (i == 0));
+      DynamicCast<SemiRandomCircularMobilityModel> (models[i])->AssignStreams (3);
+      models[i]->SetPosition (Vector (150.0, 0.0, 0.0));
+    }
+  m_cached = models[0];
+  m_plain = models[1];
+  NS_TEST_EXPECT_MSG_EQ (m_plain->GetCacheHits () + m_plain->GetCacheMisses (), 0, "Cache used while disabled");
+  for (double t = 0.5; t < 600.0; t += 3.7)
+    {
+      Simulator::Schedule (Seconds (t), &MobilityModelCacheTest::Check, this);
+    }
+  Simulator::Schedule (Seconds (599.0), &MobilityModelCacheTest::CheckSetPosition, this);
+  Simulator::Stop (Seconds (600.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  // each check misses once on the position and once on the velocity, then
+  // hits on the second round
+  NS_TEST_EXPECT_MSG_GT (m_checks, 0, "No check ran");
+  NS_TEST_EXPECT_MSG_GT (m_cached->GetCacheHits (), m_checks, "The cache was never hit");
+  NS_TEST_EXPECT_MSG_GT (m_cached->GetCacheMisses (), 2 * m_checks - 1, "The cache missed too rarely");
+  m_cached = 0;
+  m_plain = 0;
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check that the current trajectory segment of the drone models
+ * predicts their positions until its end.
+ */
+class TrajectorySegmentTest : public TestCase
+{
+public:
+  TrajectorySegmentTest ()
+    : TestCase ("Check MobilityModel::GetCurrentSegment against the positions")
+  {
+  }
+  virtual ~TrajectorySegmentTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check the segment of every model at the current time and schedule a
+   * look ahead check within it
+   */
+  void Check (void);
+  /**
+   * Compare a segment with the position of its model
+   * \param i the index of the model
+   * \param segment a segment of the model taken earlier
+   */
+  void CheckLater (uint32_t i, TrajectorySegment segment);
+
+  std::vector<Ptr<MobilityModel> > m_models; ///< models checked
+  uint32_t m_checks; ///< number of look ahead checks done
+  uint32_t m_arcs; ///< number of circular arcs seen
+};
+
+void
+TrajectorySegmentTest::Check (void)
+{
+  Time now = Simulator::Now ();
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      TrajectorySegment segment = m_models[i]->GetCurrentSegment ();
+      NS_TEST_EXPECT_MSG_EQ (segment.IsValidAt (now), true, "Segment " << segment << " of model " << i << " not valid now");
+      Vector expected = m_models[i]->GetPosition ();
+      Vector position = segment.GetPositionAt (now);
+      NS_TEST_EXPECT_MSG_EQ_TOL (position.x, expected.x, 1e-6, "Wrong x of model " << i << " on " << segment);
+      NS_TEST_EXPECT_MSG_EQ_TOL (position.y, expected.y, 1e-6, "Wrong y of model " << i << " on " << segment);
+      NS_TEST_EXPECT_MSG_EQ_TOL (position.z, expected.z, 1e-6, "Wrong z of model " << i << " on " << segment);
+      if (segment.GetType () == TrajectorySegment::CIRCULAR_ARC)
+        {
+          m_arcs++;
+        }
+      // look ahead strictly before the end, where the next phase may start
+      Time ahead = Min (Seconds (1.3), Seconds ((segment.GetEnd () - now).GetSeconds () / 2));
+      if (ahead.IsStrictlyPositive ())
+        {
+          Simulator::Schedule (ahead, &TrajectorySegmentTest::CheckLater, this, i, segment);
+        }
+    }
+}
+
+void
+TrajectorySegmentTest::CheckLater (uint32_t i, TrajectorySegment segment)
+{
+  m_checks++;
+  Vector expected = m_models[i]->GetPosition ();
+  Vector position = segment.GetPositionAt (Simulator::Now ());
+  NS_TEST_EXPECT_MSG_EQ_TOL (position.x, expected.x, 1e-6, "Segment " << segment << " of model " << i << " went off course");
+  NS_TEST_EXPECT_MSG_EQ_TOL (position.y, expected.y, 1e-6, "Segment " << segment << " of model " << i << " went off course");
+}
+
+void
+TrajectorySegmentTest::DoRun (void)
+{
+  m_checks = 0;
+  m_arcs = 0;
+  Ptr<ConstantTimeCircularMotionModel> constantTime = CreateObjectWithAttributes<ConstantTimeCircularMotionModel> (
+      "UpdateMode", EnumValue (ConstantTimeCircularMotionModel::ANALYTIC_MODE), "AltitudeStep", DoubleValue (20.0));
+  constantTime->AssignStreams (1);
+  constantTime->Initialize ();
+  constantTime->SetPosition (Vector (150.0, 0.0, 0.0));
+  m_models.push_back (constantTime);
+  Ptr<SemiRandomCircularMobilityModel> semiRandom = CreateObjectWithAttributes<SemiRandomCircularMobilityModel> (
+      "ExchangePoints", DoubleValue (4.0), "TangentialVelocity", DoubleValue (5.0));
+  semiRandom->AssignStreams (2);
+  semiRandom->SetPosition (Vector (225.0, 0.0, 0.0));
+  m_models.push_back (semiRandom);
+  Ptr<CircularSwarmMobilityManager> manager = CreateObject<CircularSwarmMobilityManager> ();
+  manager->AssignStreams (3);
+  Ptr<CircularSwarmMobilityModel> swarm = CreateObjectWithAttributes<CircularSwarmMobilityModel> ("Manager", PointerValue (manager));
+  swarm->SetPosition (Vector (300.0, 0.0, 10.0));
+  m_models.push_back (swarm);
+  Ptr<ConstantVelocityMobilityModel> straight = CreateObject<ConstantVelocityMobilityModel> ();
+  straight->SetPosition (Vector (1.0, 2.0, 3.0));
+  straight->SetVelocity (Vector (4.0, -5.0, 0.5));
+  m_models.push_back (straight);
+  for (double t = 0.25; t < 600.0; t += 3.7)
+    {
+      Simulator::Schedule (Seconds (t), &TrajectorySegmentTest::Check, this);
+    }
+  Simulator::Stop (Seconds (602.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_GT (m_checks, 0, "No segment was checked ahead");
+  NS_TEST_EXPECT_MSG_GT (m_arcs, 0, "No circular arc was exported");
+  manager->Dispose ();
+  m_models.clear ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check the evaluation of published analytic trajectories.
+ */
+class MobilityModelAnalyticTest : public TestCase
+{
+public:
+  MobilityModelAnalyticTest ()
+    : TestCase ("Check MobilityModel::GetPositions on analytic models")
+  {
+  }
+  virtual ~MobilityModelAnalyticTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Compare the batch snapshot with GetPosition and GetVelocity
+   */
+  void Check (void);
+  /**
+   * Change the course of the analytic models
+   */
+  void Steer (void);
+
+  std::vector<Ptr<MobilityModel> > m_models; ///< models to snapshot
+};
+
+void
+MobilityModelAnalyticTest::Check (void)
+{
+  std::vector<Vector> positions (m_models.size ());
+  std::vector<Vector> velocities (m_models.size ());
+  MobilityModel::GetPositions (&m_models[0], m_models.size (), &positions[0], &velocities[0]);
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      Vector position = m_models[i]->GetPosition ();
+      Vector velocity = m_models[i]->GetVelocity ();
+      NS_TEST_EXPECT_MSG_EQ_TOL (positions[i].x, position.x, 1e-9, "Wrong x of model " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (positions[i].y, position.y, 1e-9, "Wrong y of model " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (positions[i].z, position.z, 1e-9, "Wrong z of model " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (velocities[i].x, velocity.x, 1e-9, "Wrong x velocity of model " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (velocities[i].y, velocity.y, 1e-9, "Wrong y velocity of model " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (velocities[i].z, velocity.z, 1e-9, "Wrong z velocity of model " << i);
+    }
+}
+
+void
+MobilityModelAnalyticTest::Steer (void)
+{
+  m_models[0]->SetPosition (Vector (-5.0, 7.0, 1.0));
+  DynamicCast<ConstantVelocityMobilityModel> (m_models[1])->SetVelocity (Vector (-3.0, 2.0, 0.5));
+  m_models[2]->SetPosition (Vector (40.0, -40.0, 0.0));
+  DynamicCast<ConstantAccelerationMobilityModel> (m_models[2])->SetVelocityAndAcceleration (Vector (0.0, 1.0, 0.0),
+                                                                                             Vector (-0.2, 0.1, 0.0));
+  Check ();
+}
+
+void
+MobilityModelAnalyticTest::DoRun (void)
+{
+  Ptr<ConstantPositionMobilityModel> still = CreateObject<ConstantPositionMobilityModel> ();
+  still->SetPosition (Vector (1.0, 2.0, 3.0));
+  m_models.push_back (still);
+  Ptr<ConstantVelocityMobilityModel> straight = CreateObject<ConstantVelocityMobilityModel> ();
+  straight->SetPosition (Vector (10.0, 0.0, 5.0));
+  straight->SetVelocity (Vector (4.0, -1.0, 0.0));
+  m_models.push_back (straight);
+  Ptr<ConstantAccelerationMobilityModel> accelerating = CreateObject<ConstantAccelerationMobilityModel> ();
+  accelerating->SetPosition (Vector (0.0, 0.0, 50.0));
+  accelerating->SetVelocityAndAcceleration (Vector (1.0, 0.0, 0.0), Vector (0.5, 0.25, -0.1));
+  m_models.push_back (accelerating);
+  // a model evaluated through the virtual methods, between analytic ones
+  Ptr<SemiRandomCircularMobilityModel> drone = CreateObjectWithAttributes<SemiRandomCircularMobilityModel> (
+      "TangentialVelocity", DoubleValue (5.0));
+  drone->AssignStreams (4);
+  drone->SetPosition (Vector (150.0, 0.0, 0.0));
+  m_models.push_back (drone);
+  m_models.push_back (CreateObject<ConstantVelocityMobilityModel> ());
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_models[i]->IsAnalytic (), i != 3, "Wrong evaluation path of model " << i);
+    }
+  for (double t = 0.0; t < 60.0; t += 6.7)
+    {
+      Simulator::Schedule (Seconds (t), &MobilityModelAnalyticTest::Check, this);
+    }
+  Simulator::Schedule (Seconds (25.0), &MobilityModelAnalyticTest::Steer, this);
+  Simulator::Stop (Seconds (60.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_models.clear ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check that CourseChangeAggregator coalesces course changes.
+ */
+class CourseChangeAggregatorTest : public TestCase
+{
+public:
+  CourseChangeAggregatorTest ()
+    : TestCase ("Check CourseChangeAggregator batches")
+  {
+  }
+  virtual ~CourseChangeAggregatorTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Change the course of some nodes, several times each
+   * \param first the first node to steer
+   */
+  void Steer (uint32_t first);
+  /**
+   * CourseChanges trace sink of the aggregator without window
+   * \param changes the batch
+   */
+  void Batch (const std::vector<CourseChangeAggregator::Change> &changes);
+  /**
+   * CourseChanges trace sink of the aggregator with a window
+   * \param changes the batch
+   */
+  void WindowBatch (const std::vector<CourseChangeAggregator::Change> &changes);
+
+  NodeContainer m_nodes; ///< nodes
+  std::vector<Time> m_batchTimes; ///< delivery times of the batches without window
+  std::vector<uint32_t> m_batchSizes; ///< sizes of the batches without window
+  std::vector<Time> m_windowTimes; ///< delivery times of the batches with a window
+  std::vector<uint32_t> m_windowSizes; ///< sizes of the batches with a window
+};
+
+void
+CourseChangeAggregatorTest::Steer (uint32_t first)
+{
+  for (uint32_t i = first; i < first + 10; i++)
+    {
+      Ptr<ConstantVelocityMobilityModel> model = m_nodes.Get (i)->GetObject<ConstantVelocityMobilityModel> ();
+      model->SetVelocity (Vector (1.0, i, 0.0));
+      model->SetVelocity (Vector (-1.0, i, 0.0));
+    }
+  m_nodes.Get (first + 3)->GetObject<MobilityModel> ()->SetPosition (Vector (-100.0, -100.0, 0.0));
+}
+
+void
+CourseChangeAggregatorTest::Batch (const std::vector<CourseChangeAggregator::Change> &changes)
+{
+  m_batchTimes.push_back (Simulator::Now ());
+  m_batchSizes.push_back (changes.size ());
+  for (uint32_t k = 0; k < changes.size (); k++)
+    {
+      Ptr<MobilityModel> model = m_nodes.Get (changes[k].id)->GetObject<MobilityModel> ();
+      NS_TEST_EXPECT_MSG_EQ (changes[k].position, model->GetPosition (), "Wrong position of node " << changes[k].id);
+      NS_TEST_EXPECT_MSG_EQ (changes[k].velocity, model->GetVelocity (), "Wrong velocity of node " << changes[k].id);
+    }
+}
+
+void
+CourseChangeAggregatorTest::WindowBatch (const std::vector<CourseChangeAggregator::Change> &changes)
+{
+  m_windowTimes.push_back (Simulator::Now ());
+  m_windowSizes.push_back (changes.size ());
+}
+
+void
+CourseChangeAggregatorTest::DoRun (void)
+{
+  m_nodes.Create (30);
+  for (uint32_t i = 0; i < m_nodes.GetN (); i++)
+    {
+      Ptr<ConstantVelocityMobilityModel> model = CreateObject<ConstantVelocityMobilityModel> ();
+      model->SetPosition (Vector (10.0 * i, 0.0, 0.0));
+      m_nodes.Get (i)->AggregateObject (model);
+    }
+  Ptr<CourseChangeAggregator> aggregator = MobilityHelper::InstallCourseChangeAggregator (m_nodes, Seconds (0.0));
+  aggregator->TraceConnectWithoutContext ("CourseChanges", MakeCallback (&CourseChangeAggregatorTest::Batch, this));
+  Ptr<CourseChangeAggregator> windowed = MobilityHelper::InstallCourseChangeAggregator (m_nodes, Seconds (2.0));
+  windowed->TraceConnectWithoutContext ("CourseChanges", MakeCallback (&CourseChangeAggregatorTest::WindowBatch, this));
+  NS_TEST_ASSERT_MSG_EQ (aggregator->GetN (), m_nodes.GetN (), "Not every node was followed");
+
+  Simulator::Schedule (Seconds (5.0), &CourseChangeAggregatorTest::Steer, this, 0);
+  Simulator::Schedule (Seconds (6.0), &CourseChangeAggregatorTest::Steer, this, 5);
+  Simulator::Schedule (Seconds (10.0), &CourseChangeAggregatorTest::Steer, this, 20);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_batchTimes.size (), 3, "One batch per steering time expected");
+  NS_TEST_EXPECT_MSG_EQ (m_batchTimes[0], Seconds (5.0), "Batch not delivered at the time of the changes");
+  NS_TEST_EXPECT_MSG_EQ (m_batchSizes[0], 10, "Each steered node should be reported once");
+  NS_TEST_EXPECT_MSG_EQ (m_batchSizes[1], 10, "Each steered node should be reported once");
+  NS_TEST_EXPECT_MSG_EQ (aggregator->GetChangeCount (), 3 * 21, "Wrong number of course changes");
+  NS_TEST_EXPECT_MSG_EQ (aggregator->GetBatchCount (), 3, "Wrong number of batches");
+
+  NS_TEST_ASSERT_MSG_EQ (m_windowTimes.size (), 2, "Changes within the window should share a batch");
+  NS_TEST_EXPECT_MSG_EQ (m_windowTimes[0], Seconds (7.0), "Batch not delivered at the end of the window");
+  NS_TEST_EXPECT_MSG_EQ (m_windowSizes[0], 15, "Nodes 0 to 14 should be reported once");
+  NS_TEST_EXPECT_MSG_EQ (m_windowTimes[1], Seconds (12.0), "Batch not delivered at the end of the window");
+  aggregator->Dispose ();
+  windowed->Dispose ();
+  m_nodes = NodeContainer ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check the MobilityStats counters of a polling and an analytic model.
+ */
+class MobilityStatsTest : public TestCase
+{
+public:
+  MobilityStatsTest ()
+    : TestCase ("Check MobilityStats accounting")
+  {
+  }
+  virtual ~MobilityStatsTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Query the position of every model
+   */
+  void Query (void);
+  /**
+   * Query the positions of all the models at once
+   */
+  void BulkQuery (void);
+
+  std::vector<Ptr<MobilityModel> > m_models; ///< models queried
+};
+
+void
+MobilityStatsTest::Query (void)
+{
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      m_models[i]->GetPosition ();
+    }
+}
+
+void
+MobilityStatsTest::BulkQuery (void)
+{
+  std::vector<Vector> positions (m_models.size ());
+  MobilityModel::GetPositions (&m_models[0], m_models.size (), &positions[0]);
+}
+
+void
+MobilityStatsTest::DoRun (void)
+{
+  MobilityStats::Reset ();
+  Ptr<ConstantTimeCircularMotionModel> polling = CreateObject<ConstantTimeCircularMotionModel> ();
+  polling->AssignStreams (5);
+  polling->Initialize ();
+  polling->SetPosition (Vector (150.0, 0.0, 0.0));
+  m_models.push_back (polling);
+  Ptr<ConstantVelocityMobilityModel> straight = CreateObject<ConstantVelocityMobilityModel> ();
+  straight->SetPosition (Vector (0.0, 0.0, 0.0));
+  straight->SetVelocity (Vector (1.0, 0.0, 0.0));
+  m_models.push_back (straight);
+  for (uint32_t i = 1; i <= 10; i++)
+    {
+      Simulator::Schedule (Seconds (i), &MobilityStatsTest::Query, this);
+    }
+  Simulator::Schedule (Seconds (20.0), &MobilityStatsTest::BulkQuery, this);
+  Simulator::Stop (Seconds (30.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  TypeId pollingTid = ConstantTimeCircularMotionModel::GetTypeId ();
+  TypeId straightTid = ConstantVelocityMobilityModel::GetTypeId ();
+  if (!MobilityStats::IsEnabled ())
+    {
+      NS_TEST_EXPECT_MSG_EQ (MobilityStats::GetCount (pollingTid, MobilityStats::SCHEDULE), 0,
+                             "Nothing should be counted when compiled out");
+      NS_TEST_EXPECT_MSG_EQ (MobilityStats::GetCount (straightTid, MobilityStats::GET_POSITION), 0,
+                             "Nothing should be counted when compiled out");
+    }
+  else
+    {
+      NS_TEST_EXPECT_MSG_GT (MobilityStats::GetCount (pollingTid, MobilityStats::SCHEDULE), 100,
+                             "The polling model should schedule an event every 0.1 s");
+      NS_TEST_EXPECT_MSG_EQ (MobilityStats::GetCount (straightTid, MobilityStats::SCHEDULE), 0,
+                             "The analytic model should not schedule events");
+      NS_TEST_EXPECT_MSG_EQ (MobilityStats::GetCount (straightTid, MobilityStats::GET_POSITION), 11,
+                             "Every position query should be counted, bulk ones included");
+      NS_TEST_EXPECT_MSG_EQ (MobilityStats::GetCount (straightTid, MobilityStats::UPDATE), 12,
+                             "The two setters and the helper updates of the queries should be counted");
+      NS_TEST_EXPECT_MSG_EQ (MobilityStats::GetCount (pollingTid, MobilityStats::GET_POSITION), 11,
+                             "Every position query should be counted, bulk ones included");
+      NS_TEST_EXPECT_MSG_GT (MobilityStats::GetCount (pollingTid, MobilityStats::UPDATE), 100,
+                             "The polling handlers should be counted for their model");
+      NS_TEST_EXPECT_MSG_EQ (MobilityStats::GetCount (TypeId (), MobilityStats::UPDATE), 0,
+                             "No update should be left without a model");
+      NS_TEST_EXPECT_MSG_EQ (MobilityStats::GetCount (straightTid, MobilityStats::COURSE_CHANGE), 2,
+                             "Every course change should be counted");
+      NS_TEST_EXPECT_MSG_GT (MobilityStats::GetSeconds (straightTid, MobilityStats::GET_POSITION), 0.0,
+                             "Position queries should be timed");
+    }
+  std::ostringstream os;
+  MobilityStats::Print (os);
+  NS_TEST_EXPECT_MSG_EQ (os.str ().empty (), false, "Nothing printed");
+  MobilityStats::Reset ();
+  m_models.clear ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check MobilityNeighborIndex queries against a scan of every node.
+ */
+class MobilityNeighborIndexTest : public TestCase
+{
+public:
+  MobilityNeighborIndexTest ()
+    : TestCase ("Check MobilityNeighborIndex against brute force")
+  {
+  }
+  virtual ~MobilityNeighborIndexTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Run radius and nearest queries around a few points
+   */
+  void Check (void);
+  /**
+   * Teleport a still node and check that it is found at once
+   */
+  void Teleport (void);
+
+  std::vector<Ptr<MobilityModel> > m_models; ///< nodes indexed
+  Ptr<MobilityNeighborIndex> m_index; ///< index under test
+  uint32_t m_found; ///< number of neighbors found
+};
+
+void
+MobilityNeighborIndexTest::Check (void)
+{
+  for (uint32_t q = 0; q < 10; q++)
+    {
+      Vector center = m_models[q * 37]->GetPosition ();
+      double radius = 40.0 + 25.0 * q;
+      std::vector<uint32_t> neighbors;
+      m_index->GetNeighbors (center, radius, neighbors);
+      std::vector<uint32_t> expected;
+      std::vector<double> distances;
+      for (uint32_t i = 0; i < m_models.size (); i++)
+        {
+          double distance = CalculateDistance (m_models[i]->GetPosition (), center);
+          distances.push_back (distance);
+          if (distance <= radius)
+            {
+              expected.push_back (i);
+            }
+        }
+      std::sort (neighbors.begin (), neighbors.end ());
+      NS_TEST_ASSERT_MSG_EQ (neighbors.size (), expected.size (), "Wrong number of neighbors within " << radius);
+      for (uint32_t i = 0; i < expected.size (); i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (neighbors[i], expected[i], "Wrong neighbor");
+        }
+      m_found += neighbors.size ();
+
+      std::vector<uint32_t> nearest;
+      m_index->GetNearest (center, 7, nearest);
+      std::vector<double> sorted = distances;
+      std::sort (sorted.begin (), sorted.end ());
+      NS_TEST_ASSERT_MSG_EQ (nearest.size (), 7, "Wrong number of nearest nodes");
+      for (uint32_t i = 0; i < nearest.size (); i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ_TOL (distances[nearest[i]], sorted[i], 1e-9, "Wrong nearest node " << i);
+        }
+    }
+}
+
+void
+MobilityNeighborIndexTest::Teleport (void)
+{
+  std::vector<uint32_t> neighbors;
+  m_index->GetNeighbors (Vector (5000.0, 5000.0, 0.0), 1.0, neighbors);
+  NS_TEST_EXPECT_MSG_EQ (neighbors.size (), 0, "Nobody should be there yet");
+  m_models[3]->SetPosition (Vector (5000.0, 5000.0, 0.0));
+  m_index->GetNeighbors (Vector (5000.0, 5000.0, 0.0), 1.0, neighbors);
+  NS_TEST_ASSERT_MSG_EQ (neighbors.size (), 1, "Teleported node not found");
+  NS_TEST_EXPECT_MSG_EQ (neighbors[0], 3, "Wrong node found");
+}
+
+void
+MobilityNeighborIndexTest::DoRun (void)
+{
+  m_found = 0;
+  NodeContainer nodes;
+  nodes.Create (400);
+  uint32_t state = 12345;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      double value[5];
+      for (uint32_t j = 0; j < 5; j++)
+        {
+          state = state * 1103515245 + 12345;
+          value[j] = (state >> 8) / 16777216.0;
+        }
+      Ptr<MobilityModel> model;
+      if (i % 4 == 3)
+        {
+          model = CreateObject<ConstantPositionMobilityModel> ();
+          model->SetPosition (Vector (1000.0 * value[0], 1000.0 * value[1], 0.0));
+        }
+      else
+        {
+          Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel> ();
+          moving->SetPosition (Vector (1000.0 * value[0], 1000.0 * value[1], 20.0 * value[2]));
+          moving->SetVelocity (Vector (20.0 * value[3] - 10.0, 20.0 * value[4] - 10.0, 0.0));
+          model = moving;
+        }
+      nodes.Get (i)->AggregateObject (model);
+      m_models.push_back (model);
+    }
+  m_index = MobilityHelper::InstallNeighborIndex (nodes, 100.0);
+  NS_TEST_ASSERT_MSG_EQ (m_index->GetN (), nodes.GetN (), "Not every node was indexed");
+  for (double t = 0.0; t < 60.0; t += 6.1)
+    {
+      Simulator::Schedule (Seconds (t), &MobilityNeighborIndexTest::Check, this);
+    }
+  Simulator::Schedule (Seconds (30.0), &MobilityNeighborIndexTest::Teleport, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_GT (m_found, 0, "No neighbor was ever found");
+  m_index->Dispose ();
+  m_index = 0;
+  m_models.clear ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check KineticRangeMonitor crossings against the positions.
+ */
+class KineticRangeMonitorTest : public TestCase
+{
+public:
+  KineticRangeMonitorTest ()
+    : TestCase ("Check KineticRangeMonitor range crossings")
+  {
+  }
+  virtual ~KineticRangeMonitorTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+  /**
+   * RangeEnter trace sink
+   * \param a the first node
+   * \param b the second node
+   */
+  void Enter (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b);
+  /**
+   * RangeLeave trace sink
+   * \param a the first node
+   * \param b the second node
+   */
+  void Leave (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b);
+  /**
+   * Compare the range state of every pair with the positions
+   */
+  void Check (void);
+
+  std::vector<Ptr<MobilityModel> > m_models; ///< nodes followed
+  Ptr<KineticRangeMonitor> m_monitor; ///< monitor under test
+  std::vector<Time> m_straight; ///< crossings of the two straight nodes
+  uint32_t m_crossings; ///< number of crossings
+};
+
+void
+KineticRangeMonitorTest::Enter (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b)
+{
+  m_crossings++;
+  NS_TEST_EXPECT_MSG_EQ_TOL (a->GetDistanceFrom (b), 100.0, 1e-3, "Entered range away from the range");
+  if ((a == m_models[0] && b == m_models[1]) || (a == m_models[1] && b == m_models[0]))
+    {
+      m_straight.push_back (Simulator::Now ());
+    }
+}
+
+void
+KineticRangeMonitorTest::Leave (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b)
+{
+  Enter (a, b);
+}
+
+void
+KineticRangeMonitorTest::Check (void)
+{
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      for (uint32_t j = 0; j < i; j++)
+        {
+          double distance = m_models[i]->GetDistanceFrom (m_models[j]);
+          if (std::fabs (distance - 100.0) > 1e-3)
+            {
+              NS_TEST_EXPECT_MSG_EQ (m_monitor->IsInRange (i, j), distance < 100.0,
+                                     "Wrong range state of " << i << " and " << j);
+            }
+          NS_TEST_EXPECT_MSG_EQ (m_monitor->GetNextEvent (i, j) >= Simulator::Now (), true,
+                                 "Pair " << i << " and " << j << " is not certified");
+        }
+    }
+}
+
+void
+KineticRangeMonitorTest::DoRun (void)
+{
+  m_crossings = 0;
+  Ptr<ConstantVelocityMobilityModel> straight = CreateObject<ConstantVelocityMobilityModel> ();
+  straight->SetPosition (Vector (0.0, 0.0, 0.0));
+  straight->SetVelocity (Vector (10.0, 0.0, 0.0));
+  m_models.push_back (straight);
+  Ptr<ConstantPositionMobilityModel> still = CreateObject<ConstantPositionMobilityModel> ();
+  still->SetPosition (Vector (500.0, 0.0, 0.0));
+  m_models.push_back (still);
+  Ptr<SemiRandomCircularMobilityModel> semiRandom = CreateObjectWithAttributes<SemiRandomCircularMobilityModel> (
+      "ExchangePoints", DoubleValue (4.0), "TangentialVelocity", DoubleValue (5.0));
+  semiRandom->AssignStreams (2);
+  semiRandom->SetPosition (Vector (225.0, 0.0, 0.0));
+  m_models.push_back (semiRandom);
+  Ptr<ConstantPositionMobilityModel> post = CreateObject<ConstantPositionMobilityModel> ();
+  post->SetPosition (Vector (0.0, 200.0, 0.0));
+  m_models.push_back (post);
+
+  m_monitor = CreateObjectWithAttributes<KineticRangeMonitor> ("Range", DoubleValue (100.0));
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      m_monitor->Add (m_models[i]);
+    }
+  m_monitor->TraceConnectWithoutContext ("RangeEnter", MakeCallback (&KineticRangeMonitorTest::Enter, this));
+  m_monitor->TraceConnectWithoutContext ("RangeLeave", MakeCallback (&KineticRangeMonitorTest::Leave, this));
+  for (double t = 0.5; t < 300.0; t += 3.7)
+    {
+      Simulator::Schedule (Seconds (t), &KineticRangeMonitorTest::Check, this);
+    }
+  Simulator::Stop (Seconds (300.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_EQ (m_straight.size (), 2, "The straight node should pass the still node once");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_straight[0].GetSeconds (), 40.0, 1e-6, "Wrong time of entry");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_straight[1].GetSeconds (), 60.0, 1e-6, "Wrong time of exit");
+  NS_TEST_EXPECT_MSG_GT (m_crossings, 2, "The orbiting node never crossed the range");
+  m_monitor->Dispose ();
+  m_monitor = 0;
+  m_models.clear ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check the pairwise kernels against the per pair MobilityModel queries.
+ */
+class PairwiseKinematicsTest : public TestCase
+{
+public:
+  PairwiseKinematicsTest ()
+    : TestCase ("Check PairwiseKinematics and PairwiseAdjacency against MobilityModel")
+  {
+  }
+  virtual ~PairwiseKinematicsTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+};
+
+void
+PairwiseKinematicsTest::DoRun (void)
+{
+  // not a multiple of the lanes, nor of the words or tiles
+  uint32_t n = 601;
+  std::vector<Ptr<MobilityModel> > models;
+  uint32_t state = 54321;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double value[6];
+      for (uint32_t j = 0; j < 6; j++)
+        {
+          state = state * 1103515245 + 12345;
+          value[j] = (state >> 8) / 16777216.0;
+        }
+      Ptr<ConstantVelocityMobilityModel> model = CreateObject<ConstantVelocityMobilityModel> ();
+      model->SetPosition (Vector (1000.0 * value[0], 1000.0 * value[1], 50.0 * value[2]));
+      model->SetVelocity (Vector (20.0 * value[3] - 10.0, 20.0 * value[4] - 10.0, value[5]));
+      models.push_back (model);
+    }
+  KinematicSnapshot snapshot;
+  snapshot.Take (models);
+  NS_TEST_ASSERT_MSG_EQ (snapshot.GetN (), n, "Wrong snapshot size");
+
+  std::vector<double> distance (n * n, -1.0);
+  std::vector<double> speed (n * n, -1.0);
+  PairwiseKinematics (snapshot, &distance[0], &speed[0], false, 3);
+  std::vector<double> upper (n * n, -1.0);
+  PairwiseKinematics (snapshot, &upper[0], 0, true, 2);
+  std::vector<uint64_t> adjacency;
+  PairwiseAdjacency (snapshot, 120.0, adjacency, 3);
+  uint32_t adjacent = 0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      for (uint32_t j = 0; j < n; j++)
+        {
+          double expected = models[i]->GetDistanceFrom (models[j]);
+          NS_TEST_EXPECT_MSG_EQ_TOL (distance[i * n + j], expected, 1e-9, "Wrong distance " << i << " " << j);
+          NS_TEST_EXPECT_MSG_EQ_TOL (speed[i * n + j], models[i]->GetRelativeSpeed (models[j]), 1e-9,
+                                     "Wrong relative speed " << i << " " << j);
+          NS_TEST_EXPECT_MSG_EQ (upper[i * n + j], j > i ? distance[i * n + j] : -1.0,
+                                 "Wrong upper triangle " << i << " " << j);
+          NS_TEST_EXPECT_MSG_EQ (IsAdjacent (adjacency, n, i, j), i != j && expected <= 120.0,
+                                 "Wrong adjacency " << i << " " << j);
+          adjacent += IsAdjacent (adjacency, n, i, j);
+        }
+    }
+  NS_TEST_EXPECT_MSG_GT (adjacent, 0, "No pair was ever adjacent");
+  Simulator::Destroy ();
+}
+
+/**
+ * Sum the distances from node 0 to a range of nodes of a snapshot, run by
+ * the worker threads of MobilitySnapshotTest.
+ * \param snapshot the snapshot
+ * \param begin the first node
+ * \param end the node after the last one
+ * \param distances receives the distance of each node
+ */
+static void
+SnapshotWorker (const MobilitySnapshot *snapshot, uint32_t begin, uint32_t end, double *distances)
+{
+  for (uint32_t i = begin; i < end; i++)
+    {
+      distances[i] = snapshot->GetDistance (0, i);
+    }
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check MobilitySnapshot against the models and read it from threads.
+ */
+class MobilitySnapshotTest : public TestCase
+{
+public:
+  MobilitySnapshotTest ()
+    : TestCase ("Check MobilitySnapshot reads from worker threads")
+  {
+  }
+  virtual ~MobilitySnapshotTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Take a snapshot and read it from several threads
+   */
+  void Take (void);
+  /**
+   * Check that the first snapshot did not follow the models
+   */
+  void CheckFrozen (void);
+
+  std::vector<Ptr<MobilityModel> > m_models; ///< nodes
+  Ptr<const MobilitySnapshot> m_snapshot; ///< first snapshot
+  std::vector<Vector> m_positions; ///< positions of the nodes at the first snapshot
+};
+
+void
+MobilitySnapshotTest::Take (void)
+{
+  m_snapshot = MobilitySnapshot::Take (m_models);
+  NS_TEST_ASSERT_MSG_EQ (m_snapshot->GetN (), m_models.size (), "Wrong snapshot size");
+  NS_TEST_EXPECT_MSG_EQ (m_snapshot->GetTime (), Simulator::Now (), "Wrong snapshot time");
+  std::vector<double> distances (m_models.size (), -1.0);
+  std::vector<std::thread> workers;
+  uint32_t slice = (m_models.size () + 3) / 4;
+  for (uint32_t k = 0; k < 4; k++)
+    {
+      uint32_t begin = std::min<uint32_t> (k * slice, m_models.size ());
+      uint32_t end = std::min<uint32_t> (begin + slice, m_models.size ());
+      workers.push_back (std::thread (&SnapshotWorker, PeekPointer (m_snapshot), begin, end, &distances[0]));
+    }
+  for (uint32_t k = 0; k < workers.size (); k++)
+    {
+      workers[k].join ();
+    }
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_snapshot->GetIndex (PeekPointer (m_models[i])), (int32_t) i, "Wrong index");
+      NS_TEST_EXPECT_MSG_EQ_TOL (distances[i], m_models[0]->GetDistanceFrom (m_models[i]), 1e-9,
+                                 "Wrong distance of node " << i);
+      m_positions.push_back (m_models[i]->GetPosition ());
+    }
+}
+
+void
+MobilitySnapshotTest::CheckFrozen (void)
+{
+  Ptr<const MobilitySnapshot> snapshot = MobilitySnapshot::Take (m_models);
+  NS_TEST_EXPECT_MSG_EQ (snapshot->GetEpoch (), m_snapshot->GetEpoch () + 1, "Epochs should follow each other");
+  uint32_t moved = 0;
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_snapshot->GetPosition (i), m_positions[i], "Snapshot of node " << i << " changed");
+      moved += CalculateDistance (snapshot->GetPosition (i), m_positions[i]) > 0;
+    }
+  NS_TEST_EXPECT_MSG_GT (moved, 0, "No node moved between the snapshots");
+  NS_TEST_EXPECT_MSG_EQ (snapshot->GetIndex (0), -1, "Unknown node found");
+}
+
+void
+MobilitySnapshotTest::DoRun (void)
+{
+  for (uint32_t i = 0; i < 203; i++)
+    {
+      Ptr<MobilityModel> model;
+      if (i % 10 == 9)
+        {
+          Ptr<SemiRandomCircularMobilityModel> drone = CreateObjectWithAttributes<SemiRandomCircularMobilityModel> (
+              "TangentialVelocity", DoubleValue (5.0));
+          drone->AssignStreams (i);
+          drone->SetPosition (Vector (100.0 + i, 0.0, 0.0));
+          model = drone;
+        }
+      else
+        {
+          Ptr<ConstantVelocityMobilityModel> straight = CreateObject<ConstantVelocityMobilityModel> ();
+          straight->SetPosition (Vector (3.0 * i, 500.0 - 2.0 * i, i % 7));
+          straight->SetVelocity (Vector (i % 5 - 2.0, i % 3 - 1.0, 0.0));
+          model = straight;
+        }
+      m_models.push_back (model);
+    }
+  Simulator::Schedule (Seconds (10.0), &MobilitySnapshotTest::Take, this);
+  Simulator::Schedule (Seconds (20.0), &MobilitySnapshotTest::CheckFrozen, this);
+  Simulator::Stop (Seconds (30.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_snapshot = 0;
+  m_models.clear ();
+}
+
 /**
  * \ingroup mobility-test
  * \ingroup tests
@@ -429,6 +1580,17 @@ MobilityTestSuite::MobilityTestSuite ()
   AddTestCase (new WaypointLazyNotifyTrue, TestCase::QUICK);
   AddTestCase (new WaypointInitialPositionIsWaypoint, TestCase::QUICK);
   AddTestCase (new WaypointMobilityModelViaHelper, TestCase::QUICK);
+  AddTestCase (new MobilityInstallBulkTest, TestCase::QUICK);
+  AddTestCase (new MobilityModelGetPositionsTest, TestCase::QUICK);
+  AddTestCase (new MobilityModelCacheTest, TestCase::QUICK);
+  AddTestCase (new TrajectorySegmentTest, TestCase::QUICK);
+  AddTestCase (new MobilityModelAnalyticTest, TestCase::QUICK);
+  AddTestCase (new CourseChangeAggregatorTest, TestCase::QUICK);
+  AddTestCase (new MobilityStatsTest, TestCase::QUICK);
+  AddTestCase (new MobilityNeighborIndexTest, TestCase::QUICK);
+  AddTestCase (new KineticRangeMonitorTest, TestCase::QUICK);
+  AddTestCase (new PairwiseKinematicsTest, TestCase::QUICK);
+  AddTestCase (new MobilitySnapshotTest, TestCase::QUICK);
 }
 
 static MobilityTestSuite mobilityTestSuite; ///< the test suite
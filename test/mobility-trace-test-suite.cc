@@ -19,18 +19,25 @@
  */
 
 #include <string>
+#include <sstream>
 
 #include "ns3/ascii-test.h"
 #include "ns3/trace-helper.h"
 #include "ns3/double.h"
 #include "ns3/uinteger.h"
 #include "ns3/string.h"
+#include "ns3/enum.h"
 #include "ns3/simulator.h"
 #include "ns3/rectangle.h"
 #include "ns3/mobility-model.h"
 #include "ns3/mobility-helper.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/mobility-binary-trace.h"
+#include "ns3/mobility-trace-writer.h"
 #include "ns3/node-container.h"
+#include "ns3/node-list.h"
 #include "ns3/test.h"
+#include "ns3/mobility-sampler.h"
 
 using namespace ns3;
 
@@ -107,6 +114,304 @@ MobilityTraceTestCase::DoRun (void)
 }
 
 
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Binary trace of MobilityHelper
+ *
+ * Trace the same course changes in ASCII and in binary, then check that the
+ * conversion of the binary trace gives back the ASCII trace.
+ */
+class MobilityBinaryTraceTest : public TestCase
+{
+public:
+  MobilityBinaryTraceTest ()
+    : TestCase ("Check the binary trace converts back to the ascii trace")
+  {
+  }
+  virtual ~MobilityBinaryTraceTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+};
+
+void
+MobilityBinaryTraceTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  mobility.Install (nodes);
+
+  std::ostringstream ascii;
+  std::ostringstream binary (std::ios::out | std::ios::binary);
+  MobilityHelper::EnableAscii (Create<OutputStreamWrapper> (&ascii), nodes);
+  MobilityHelper::EnableBinary (Create<OutputStreamWrapper> (&binary), nodes);
+
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<ConstantVelocityMobilityModel> model = nodes.Get (i)->GetObject<ConstantVelocityMobilityModel> ();
+      Simulator::Schedule (Seconds (1.0 + i), &ConstantVelocityMobilityModel::SetVelocity,
+                           model, Vector (1.0 + i, -0.00005, 0.0005));
+      Simulator::Schedule (Seconds (5.5), &ConstantVelocityMobilityModel::SetPosition,
+                           model, Vector (10.0 * i, 1.0 / 3.0, 0.0));
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (binary.str ().size (), 16 + 6 * sizeof (MobilityBinaryTrace::Record),
+                         "The binary trace should hold a header and six records");
+  std::istringstream is (binary.str (), std::ios::in | std::ios::binary);
+  MobilityBinaryTrace::Record record;
+  NS_TEST_ASSERT_MSG_EQ (MobilityBinaryTrace::ReadHeader (is), true, "Header not recognized");
+  NS_TEST_ASSERT_MSG_EQ (MobilityBinaryTrace::Read (is, record), true, "Missing record");
+  NS_TEST_EXPECT_MSG_EQ (record.time, Seconds (1.0).GetNanoSeconds (), "Wrong time");
+  NS_TEST_EXPECT_MSG_EQ (record.node, nodes.Get (0)->GetId (), "Wrong node");
+  NS_TEST_EXPECT_MSG_EQ (record.velocity[1], -0.00005, "Values should not be rounded");
+
+  std::istringstream converted (binary.str (), std::ios::in | std::ios::binary);
+  std::ostringstream os;
+  NS_TEST_EXPECT_MSG_EQ (MobilityBinaryTrace::ConvertToAscii (converted, os), 6, "Wrong record count");
+  NS_TEST_EXPECT_MSG_EQ (os.str (), ascii.str (), "The conversion should match the ascii trace");
+
+  std::istringstream garbage ("not a trace");
+  NS_TEST_EXPECT_MSG_EQ (MobilityBinaryTrace::ConvertToAscii (garbage, os), -1, "Garbage should be rejected");
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Trace writer thread of MobilityHelper
+ *
+ * Trace the same course changes directly and through writer threads, in
+ * both formats, and check that the outputs match; then overflow a small
+ * dropping buffer and check that every record is either written or counted.
+ */
+class MobilityTraceWriterTest : public TestCase
+{
+public:
+  MobilityTraceWriterTest ()
+    : TestCase ("Check the trace writer thread output and backpressure")
+  {
+  }
+  virtual ~MobilityTraceWriterTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+};
+
+void
+MobilityTraceWriterTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (4);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  mobility.Install (nodes);
+
+  std::ostringstream ascii;
+  std::ostringstream asyncAscii;
+  std::ostringstream asyncBinary (std::ios::out | std::ios::binary);
+  MobilityHelper::EnableAscii (Create<OutputStreamWrapper> (&ascii), nodes);
+  Ptr<MobilityTraceWriter> asciiWriter = CreateObjectWithAttributes<MobilityTraceWriter> ("Capacity", UintegerValue (4));
+  asciiWriter->SetStream (Create<OutputStreamWrapper> (&asyncAscii));
+  MobilityHelper::EnableAscii (asciiWriter, nodes);
+  Ptr<MobilityTraceWriter> binaryWriter = CreateObjectWithAttributes<MobilityTraceWriter> ("Format", EnumValue (MobilityTraceWriter::BINARY));
+  binaryWriter->SetStream (Create<OutputStreamWrapper> (&asyncBinary));
+  MobilityHelper::EnableAscii (binaryWriter, nodes);
+
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<ConstantVelocityMobilityModel> model = nodes.Get (i)->GetObject<ConstantVelocityMobilityModel> ();
+      for (uint32_t k = 0; k < 10; k++)
+        {
+          Simulator::Schedule (Seconds (1.0 + k), &ConstantVelocityMobilityModel::SetVelocity,
+                               model, Vector (1.0 + i, 0.5 * k, 0.0));
+        }
+    }
+  Simulator::Run ();
+  asciiWriter->Flush ();
+  NS_TEST_EXPECT_MSG_EQ (asciiWriter->GetWritten (), 40, "Every course change should be written");
+  NS_TEST_EXPECT_MSG_EQ (asciiWriter->GetDropped (), 0, "Nothing should be dropped by a blocking writer");
+  NS_TEST_EXPECT_MSG_EQ (asyncAscii.str (), ascii.str (), "The writer thread should match the ascii trace");
+  Simulator::Destroy ();
+
+  std::istringstream is (asyncBinary.str (), std::ios::in | std::ios::binary);
+  std::ostringstream converted;
+  NS_TEST_EXPECT_MSG_EQ (MobilityBinaryTrace::ConvertToAscii (is, converted), 40, "Wrong record count");
+  NS_TEST_EXPECT_MSG_EQ (converted.str (), ascii.str (), "The binary writer thread should match the ascii trace");
+
+  std::ostringstream dropped;
+  Ptr<MobilityTraceWriter> dropWriter = CreateObjectWithAttributes<MobilityTraceWriter> ("Capacity", UintegerValue (2),
+                                                                                           "Backpressure", EnumValue (MobilityTraceWriter::DROP));
+  dropWriter->SetStream (Create<OutputStreamWrapper> (&dropped));
+  for (uint32_t k = 0; k < 1000; k++)
+    {
+      dropWriter->Add (Seconds (k), 0, Vector (k, 0.0, 0.0), Vector (1.0, 0.0, 0.0));
+    }
+  dropWriter->Stop ();
+  NS_TEST_EXPECT_MSG_EQ (dropWriter->GetWritten () + dropWriter->GetDropped (), 1000,
+                         "Every record should be written or dropped");
+  std::istringstream lines (dropped.str ());
+  std::string line;
+  uint64_t n = 0;
+  while (std::getline (lines, line))
+    {
+      n++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (n, dropWriter->GetWritten (), "Every record written should be in the stream");
+  dropWriter->Dispose ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Trace attachment of MobilityHelper
+ *
+ * Check that sinks connected by container and by node id receive the same
+ * course changes, that nodes without a mobility model are skipped and that
+ * unknown node ids are ignored.
+ */
+class MobilityTraceAttachTest : public TestCase
+{
+public:
+  MobilityTraceAttachTest ()
+    : TestCase ("Check MobilityHelper trace attachment without configuration paths")
+  {
+  }
+  virtual ~MobilityTraceAttachTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+};
+
+void
+MobilityTraceAttachTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+  MobilityHelper mobility;
+  mobility.Install (nodes.Get (0));
+  mobility.Install (nodes.Get (1));
+
+  std::ostringstream byContainer;
+  std::ostringstream byId;
+  MobilityHelper::EnableAscii (Create<OutputStreamWrapper> (&byContainer), nodes);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      MobilityHelper::EnableAscii (Create<OutputStreamWrapper> (&byId), nodes.Get (i)->GetId ());
+    }
+  MobilityHelper::EnableAscii (Create<OutputStreamWrapper> (&byId), NodeList::GetNNodes () + 10);
+
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<MobilityModel> model = nodes.Get (i)->GetObject<MobilityModel> ();
+      Simulator::Schedule (Seconds (1.0 + i), &MobilityModel::SetPosition, model, Vector (i, 2.0, 3.0));
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::istringstream lines (byContainer.str ());
+  std::string line;
+  uint32_t n = 0;
+  while (std::getline (lines, line))
+    {
+      n++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (n, 2, "One line per course change of the nodes with a model");
+  NS_TEST_EXPECT_MSG_EQ (byId.str (), byContainer.str (), "Attachment by id should match attachment by container");
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Fixed rate columnar sampler
+ *
+ * Sample nodes moving at constant velocities and check the blocks read
+ * back from the stream.
+ */
+class MobilitySamplerTest : public TestCase
+{
+public:
+  MobilitySamplerTest ()
+    : TestCase ("Check MobilitySampler blocks")
+  {
+  }
+  virtual ~MobilitySamplerTest ()
+  {
+  }
+
+private:
+  virtual void DoRun (void);
+};
+
+void
+MobilitySamplerTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  mobility.Install (nodes);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<ConstantVelocityMobilityModel> model = nodes.Get (i)->GetObject<ConstantVelocityMobilityModel> ();
+      model->SetPosition (Vector (0.0, 10.0 * i, 5.0));
+      model->SetVelocity (Vector (1.0 + i, 0.0, -1.0));
+    }
+
+  std::ostringstream os (std::ios::out | std::ios::binary);
+  Ptr<MobilitySampler> sampler = MobilityHelper::InstallSampler (nodes, Seconds (0.5), Create<OutputStreamWrapper> (&os));
+  NS_TEST_EXPECT_MSG_EQ (sampler->GetN (), 3, "Every node should be sampled");
+  // a sampler whose caller drops the pointer keeps sampling
+  std::ostringstream dropped (std::ios::out | std::ios::binary);
+  MobilityHelper::InstallSampler (nodes, Seconds (1.0), Create<OutputStreamWrapper> (&dropped));
+  Simulator::Stop (Seconds (2.2));
+  Simulator::Run ();
+  sampler->Stop ();
+  NS_TEST_EXPECT_MSG_EQ (sampler->GetSampleCount (), 5, "One sample every 0.5 s from 0 s to 2 s");
+  NS_TEST_EXPECT_MSG_EQ (dropped.str ().size (), 8 + 12 + 3 * 4 + 3 * (8 + 6 * 3 * 8), "Dropped sampler stopped sampling");
+
+  std::istringstream is (os.str (), std::ios::in | std::ios::binary);
+  std::vector<uint32_t> ids;
+  bool velocities = false;
+  NS_TEST_ASSERT_MSG_EQ (MobilitySampler::ReadHeader (is, ids, velocities), true, "Header not recognized");
+  NS_TEST_ASSERT_MSG_EQ (ids.size (), 3, "Wrong node count");
+  NS_TEST_EXPECT_MSG_EQ (ids[2], nodes.Get (2)->GetId (), "Wrong node id");
+  NS_TEST_EXPECT_MSG_EQ (velocities, true, "Velocities should be sampled by default");
+  MobilitySampler::Block block;
+  uint32_t k = 0;
+  while (MobilitySampler::ReadBlock (is, ids.size (), velocities, block))
+    {
+      double t = 0.5 * k;
+      NS_TEST_EXPECT_MSG_EQ (block.time, Seconds (t).GetNanoSeconds (), "Wrong sample time");
+      for (uint32_t i = 0; i < ids.size (); i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ_TOL (block.x[i], (1.0 + i) * t, 1e-9, "Wrong x");
+          NS_TEST_EXPECT_MSG_EQ_TOL (block.y[i], 10.0 * i, 1e-9, "Wrong y");
+          NS_TEST_EXPECT_MSG_EQ_TOL (block.z[i], 5.0 - t, 1e-9, "Wrong z");
+          NS_TEST_EXPECT_MSG_EQ_TOL (block.vx[i], 1.0 + i, 1e-9, "Wrong x velocity");
+          NS_TEST_EXPECT_MSG_EQ_TOL (block.vz[i], -1.0, 1e-9, "Wrong z velocity");
+        }
+      k++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (k, 5, "Every sample should be read back");
+  NS_TEST_EXPECT_MSG_EQ (os.str ().size (), 8 + 12 + 3 * 4 + 5 * (8 + 6 * 3 * 8), "Wrong stream size");
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup mobility-test
  * \ingroup tests
@@ -124,6 +429,10 @@ MobilityTraceTestSuite::MobilityTraceTestSuite ()
   : TestSuite ("mobility-trace", UNIT)
 {
   AddTestCase (new MobilityTraceTestCase, TestCase::QUICK);
+  AddTestCase (new MobilityBinaryTraceTest, TestCase::QUICK);
+  AddTestCase (new MobilityTraceWriterTest, TestCase::QUICK);
+  AddTestCase (new MobilityTraceAttachTest, TestCase::QUICK);
+  AddTestCase (new MobilitySamplerTest, TestCase::QUICK);
 }
 
 static MobilityTraceTestSuite mobilityTraceTestSuite; ///< the test suite